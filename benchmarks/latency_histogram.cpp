@@ -0,0 +1,71 @@
+// latency_histogram.cpp
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram(int sub_bucket_bits)
+    : bits_(std::min(std::max(sub_bucket_bits, 2), 16)) {
+    // 2^bits exact slots, then 2^(bits-1) buckets for each of the 64 - bits octaves above
+    const std::size_t half = std::size_t(1) << (bits_ - 1);
+    counts_.assign((std::size_t(1) << bits_) + static_cast<std::size_t>(64 - bits_) * half, 0);
+}
+
+std::size_t LatencyHistogram::index_of(std::uint64_t value) const {
+    const std::uint64_t sub = std::uint64_t(1) << bits_;
+    if (value < sub) return static_cast<std::size_t>(value);
+    // value >> shift lands in [2^(bits-1), 2^bits)
+    const int top = 63 - __builtin_clzll(value);
+    const int shift = top - (bits_ - 1);
+    const std::uint64_t half = sub >> 1;
+    return static_cast<std::size_t>(sub + static_cast<std::uint64_t>(shift - 1) * half + ((value >> shift) - half));
+}
+
+std::uint64_t LatencyHistogram::highest_in(std::size_t index) const {
+    const std::uint64_t sub = std::uint64_t(1) << bits_;
+    if (index < sub) return index;
+    const std::uint64_t half = sub >> 1;
+    const std::uint64_t k = index - sub;
+    const int shift = static_cast<int>(k / half) + 1;
+    const std::uint64_t mantissa = k % half + half;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value) {
+    counts_[index_of(value)]++;
+    count_++;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += static_cast<double>(value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.bits_ != bits_) return;
+    for (std::size_t i = 0; i < counts_.size(); i++) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+    sum_ = 0.0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+    p = std::min(std::max(p, 0.0), 100.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(p / 100.0 * static_cast<double>(count_))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(highest_in(i), max_);
+    }
+    return max_;
+}
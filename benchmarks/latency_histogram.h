@@ -0,0 +1,44 @@
+// latency_histogram.h
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HDR-style log-linear histogram of non-negative integer values (latencies in
+// ns). Values below 2^bits are counted exactly; above that every power-of-two
+// range is split into 2^(bits-1) equal buckets, so any recorded value is
+// reproduced to a relative error below 2^-(bits-1) over the full 64-bit range
+// with a fixed, allocation-free record().
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(int sub_bucket_bits = 8);
+
+    void record(std::uint64_t value);
+    void merge(const LatencyHistogram& other);   // same sub_bucket_bits required
+    void reset();
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t min() const { return count_ ? min_ : 0; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+
+    // Smallest bucket upper bound with at least p% of the values at or below
+    // it (p in [0, 100]), clamped to max()
+    std::uint64_t percentile(double p) const;
+
+private:
+    std::size_t index_of(std::uint64_t value) const;
+    std::uint64_t highest_in(std::size_t index) const;
+
+    int bits_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_ = 0;
+    std::uint64_t min_ = UINT64_MAX;
+    std::uint64_t max_ = 0;
+    double sum_ = 0.0;
+};
+
+#endif
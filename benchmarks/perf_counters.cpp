@@ -0,0 +1,150 @@
+// perf_counters.cpp
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#if defined(__linux__)
+    struct EventSpec {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    // Raw FP event: FP_ARITH_INST_RETIRED.* (0xC7, all umasks) on Intel,
+    // FpRetSseAvxOps (0x03, all umasks) on AMD Zen; PRICER_PERF_FP_RAW=0x...
+    // overrides it for other CPUs
+    bool fp_event(std::uint64_t& config) {
+        if (const char* env = std::getenv("PRICER_PERF_FP_RAW")) {
+            config = std::strtoull(env, nullptr, 0);
+            return config != 0;
+        }
+#if defined(__x86_64__) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_is("intel")) { config = 0xFFC7; return true; }
+        if (__builtin_cpu_is("amd"))   { config = 0xFF03; return true; }
+#endif
+        return false;
+    }
+
+    int open_event(const EventSpec& e) {
+        perf_event_attr pe;
+        std::memset(&pe, 0, sizeof(pe));
+        pe.size = sizeof(pe);
+        pe.type = e.type;
+        pe.config = e.config;
+        pe.disabled = 1;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        pe.inherit = 1;   // threads the measured code starts count too (no group reads)
+        pe.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0));
+    }
+
+    bool read_sample(int fd, PerfCounters::Sample& s) {
+        std::uint64_t buf[3] = {0, 0, 0};
+        if (read(fd, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return false;
+        s.value = buf[0];
+        s.enabled = buf[1];
+        s.running = buf[2];
+        return true;
+    }
+#endif
+}
+
+bool PerfCounters::scaledDelta(const Sample& begin, const Sample& end, double& count) {
+    if (end.running <= begin.running || end.value < begin.value || end.enabled < begin.enabled) return false;
+    count = static_cast<double>(end.value - begin.value) * static_cast<double>(end.enabled - begin.enabled) /
+            static_cast<double>(end.running - begin.running);
+    return true;
+}
+
+double PerfCounters::Reading::ipc() const {
+    return (valid[Cycles] && valid[Instructions] && count[Cycles] > 0.0)
+        ? count[Instructions] / count[Cycles] : 0.0;
+}
+
+const char* PerfCounters::name(Event e) {
+    switch (e) {
+        case Cycles:       return "cycles";
+        case Instructions: return "instructions";
+        case L1DMisses:    return "l1d_misses";
+        case LLCMisses:    return "llc_misses";
+        case BranchMisses: return "branch_misses";
+        case FpOps:        return "fp_ops";
+        default:           return "?";
+    }
+}
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds_) fd = -1;
+#if defined(__linux__)
+    const std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const EventSpec specs[kEventCount - 1] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, l1d_read_miss},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+    for (int e = 0; e < kEventCount - 1; e++) {
+        fds_[e] = open_event(specs[e]);
+        if (e == Cycles && fds_[e] < 0) {
+            const int err = errno;
+            reason_ = std::string("perf_event_open: ") + std::strerror(err) +
+                      (err == ENOENT || err == EOPNOTSUPP
+                           ? " (no hardware PMU exposed, e.g. inside a VM)"
+                           : " (check /proc/sys/kernel/perf_event_paranoid or container seccomp)");
+            return;
+        }
+    }
+    std::uint64_t fp = 0;
+    if (fp_event(fp)) fds_[FpOps] = open_event({PERF_TYPE_RAW, fp});
+#else
+    reason_ = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    // Disabled counters do not move, so the baseline is exact
+    for (int e = 0; e < kEventCount; e++) {
+        if (fds_[e] < 0) continue;
+        base_ok_[e] = read_sample(fds_[e], base_[e]);
+        ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfCounters::Reading PerfCounters::stop() {
+    Reading r;
+#if defined(__linux__)
+    for (int fd : fds_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int e = 0; e < kEventCount; e++) {
+        Sample now;
+        if (fds_[e] < 0 || !base_ok_[e] || !read_sample(fds_[e], now)) continue;
+        r.valid[e] = scaledDelta(base_[e], now, r.count[e]);
+    }
+#endif
+    return r;
+}
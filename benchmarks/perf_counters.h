@@ -0,0 +1,68 @@
+// perf_counters.h
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hardware counters of the calling thread, and of the threads it starts
+// after construction (e.g. runScenarios' workers), via Linux perf_event_open,
+// for the benchmarks. Each event is opened on its own, so one the CPU or kernel does
+// not offer (commonly the FP one, or all of them in containers and with
+// perf_event_paranoid > 2) is reported as unavailable and the rest still
+// count. Counts are scaled for multiplexing. A reading is the difference
+// from the values at start(): PERF_EVENT_IOC_RESET does not clear what
+// exited inherited threads folded into the count.
+class PerfCounters {
+public:
+    enum Event {
+        Cycles,
+        Instructions,
+        L1DMisses,          // L1 data cache read misses
+        LLCMisses,          // last-level cache misses
+        BranchMisses,
+        FpOps,              // retired FP arithmetic instructions (Intel) / FLOPs (AMD Zen), raw event
+        kEventCount
+    };
+
+    struct Reading {
+        bool valid[kEventCount] = {};
+        double count[kEventCount] = {};
+
+        double ipc() const;
+    };
+
+    // One raw read of a counter: value, time enabled, time running
+    struct Sample {
+        std::uint64_t value = 0, enabled = 0, running = 0;
+    };
+
+    // Count between two samples of one counter, scaled for multiplexing;
+    // false if the counter did not run in between
+    static bool scaledDelta(const Sample& begin, const Sample& end, double& count);
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return fds_[Cycles] >= 0; }
+    bool has(Event e) const { return fds_[e] >= 0; }
+    const std::string& unavailableReason() const { return reason_; }
+
+    void start();          // records a baseline and enables every open counter
+    Reading stop();        // disables them and reads the change since start()
+
+    static const char* name(Event e);
+
+private:
+    int fds_[kEventCount];
+    Sample base_[kEventCount];
+    bool base_ok_[kEventCount] = {};
+    std::string reason_;
+};
+
+#endif
@@ -2,15 +2,56 @@
 #include <iomanip>
 #include <vector>
 #include <chrono>
+#include <string>
+#include <cmath>
+#include <cstdio>
 
 #include "black_scholes.h"
+#include "greeks.h"
 #include "monte_carlo.h"
+#include "fourier.h"
+#include "vol_surface.h"
+#include "scenario.h"
+#include "cpu_dispatch.h"
+#include "aad.h"
+#include "chebyshev_proxy.h"
+#include "hedging.h"
+#include "heston_mc.h"
+#include "normal_pool.h"
+#include "utils.h"
+#include "perf_counters.h"
 
 static double ms_since(const std::chrono::steady_clock::time_point& t0,
                        const std::chrono::steady_clock::time_point& t1) {
     return std::chrono::duration<double, std::milli>(t1 - t0).count();
 }
 
+// Set by --counters when perf_event_open is permitted; null otherwise
+static PerfCounters* g_counters = nullptr;
+
+// Runs fn under the hardware counters, if enabled
+template <class Fn>
+static PerfCounters::Reading counted(Fn&& fn) {
+    if (g_counters) g_counters->start();
+    fn();
+    return g_counters ? g_counters->stop() : PerfCounters::Reading{};
+}
+
+// One line of counts normalised per unit of work (option, path, element)
+static void print_counters(const char* label, const PerfCounters::Reading& c, double units, const char* unit) {
+    if (!g_counters) return;
+    std::cout << "    " << std::left << std::setw(10) << label << "per " << std::setw(6) << unit;
+    for (int e = 0; e < PerfCounters::kEventCount; e++) {
+        if (!c.valid[e]) continue;
+        std::cout << " " << PerfCounters::name(static_cast<PerfCounters::Event>(e)) << "="
+                  << std::setprecision(4) << c.count[e] / units;
+    }
+    if (c.valid[PerfCounters::Cycles] && c.valid[PerfCounters::Instructions]) {
+        std::cout << " ipc=" << std::setprecision(3) << c.ipc();
+    }
+    std::cout << "\n";
+}
+
 static void bench_case(double S, double K, double T, double r, double sigma,
                        std::uint64_t seed,
                        const std::vector<std::size_t>& paths_list) {
@@ -33,9 +74,13 @@ static void bench_case(double S, double K, double T, double r, double sigma,
               << std::setw(14) << "time_ms"
               << "\n";
 
-    auto run = [&](MCMode mode, const char* name, std::size_t n) {
+    auto run = [&](MCMode mode, const char* name, std::size_t n, bool f32 = false) {
+        MCResult mc;
         const auto a0 = std::chrono::steady_clock::now();
-        const auto mc = mcCallPrice(S, K, T, r, sigma, n, seed, mode);
+        const auto c = counted([&] {
+            mc = f32 ? mcCallPriceT<float>(S, K, T, r, sigma, n, seed, mode)
+                     : mcCallPrice(S, K, T, r, sigma, n, seed, mode);
+        });
         const auto a1 = std::chrono::steady_clock::now();
 
         std::cout << std::left
@@ -45,6 +90,7 @@ static void bench_case(double S, double K, double T, double r, double sigma,
                   << std::setw(14) << std::setprecision(6) << mc.stderr
                   << std::setw(14) << std::setprecision(4) << ms_since(a0, a1)
                   << "\n";
+        print_counters(name, c, static_cast<double>(n), "path");
     };
 
     for (auto n : paths_list) {
@@ -52,10 +98,366 @@ static void bench_case(double S, double K, double T, double r, double sigma,
         run(MCMode::Antithetic, "anti",  n);
         run(MCMode::ControlVariateBS,    "cv",    n);
         run(MCMode::AntitheticControlBS, "anti+cv", n);
+        run(MCMode::Plain,      "plain/f32", n, true);
+    }
+}
+
+static void bench_fourier_chain(double S, double T, double r, std::size_t n_strikes, int reps) {
+    std::vector<double> strikes(n_strikes);
+    for (std::size_t j = 0; j < n_strikes; j++) {
+        strikes[j] = S * (0.6 + 0.8 * static_cast<double>(j) / static_cast<double>(n_strikes - 1));
+    }
+    const HestonParams hp{1.5768, 0.0398, 0.5751, -0.5711, 0.0175};
+    const CharFn cf = hestonCharFn(T, r, hp);
+
+    auto time_us = [&](auto&& fn) {
+        volatile double sink = 0.0;
+        const auto a0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; i++) sink = sink + fn()[n_strikes / 2];
+        const auto a1 = std::chrono::steady_clock::now();
+        return 1000.0 * ms_since(a0, a1) / reps;
+    };
+
+    const double cos_us = time_us([&] { return cosCallPrices(cf, S, strikes); });
+    const double cm_us  = time_us([&] { return carrMadanCallPrices(cf, S, strikes); });
+
+    std::cout << "\nHeston chain (" << n_strikes << " strikes, T=" << T << ")\n";
+    std::cout << std::left
+              << std::setw(14) << "method"
+              << std::setw(14) << "us/chain"
+              << "\n";
+    std::cout << std::setw(14) << "cos" << std::setw(14) << std::setprecision(4) << cos_us << "\n";
+    std::cout << std::setw(14) << "carr-madan" << std::setw(14) << std::setprecision(4) << cm_us << "\n";
+}
+
+static void bench_surface_calibration(double S, double r, std::size_t n_expiries, std::size_t n_strikes) {
+    std::vector<SliceQuotes> slices;
+    for (std::size_t j = 0; j < n_expiries; j++) {
+        SliceQuotes q;
+        q.T = 0.05 + 0.25 * static_cast<double>(j);
+        q.forward = S * std::exp(r * q.T);
+        const SVIParams p{0.02 * q.T, 0.08 * std::sqrt(q.T), -0.4, 0.02, 0.15};
+        for (std::size_t i = 0; i < n_strikes; i++) {
+            const double K = S * (0.6 + 0.8 * static_cast<double>(i) / static_cast<double>(n_strikes - 1));
+            q.strikes.push_back(K);
+            q.ivs.push_back(std::sqrt(sviTotalVariance(p, std::log(K / q.forward)) / q.T));
+        }
+        slices.push_back(q);
+    }
+
+    CalibrationReport rep;
+    const auto a0 = std::chrono::steady_clock::now();
+    const VolSurface surf = calibrateSurface(S, slices, {}, nullptr, &rep);
+    const auto a1 = std::chrono::steady_clock::now();
+    (void)calibrateSurface(S, slices, {}, &surf, &rep);
+    const auto a2 = std::chrono::steady_clock::now();
+
+    std::cout << "\nSVI surface (" << n_expiries << " expiries x " << n_strikes << " strikes)\n";
+    std::cout << "  cold_ms=" << std::setprecision(4) << ms_since(a0, a1)
+              << "  warm_ms=" << std::setprecision(4) << ms_since(a1, a2)
+              << "  max_rmse=" << std::setprecision(3) << rep.max_rmse << "\n";
+}
+
+static void bench_scenarios(std::size_t n_positions) {
+    std::vector<Position> book;
+    for (std::size_t i = 0; i < n_positions; i++) {
+        book.push_back({i % 2 == 0, 100.0, 60.0 + 0.08 * static_cast<double>(i % 1000),
+                        0.1 + 0.002 * static_cast<double>(i % 500), 0.02, 0.2, 1.0});
+    }
+    ShockGrid grid;
+    grid.spot = symmetricShocks(21, 0.2);
+    grid.vol = symmetricShocks(11, 0.1);
+    grid.time = {0.0, 1.0 / 252.0, 5.0 / 252.0};
+
+    // Naive: one callPrice/putPrice per position per scenario
+    const auto a0 = std::chrono::steady_clock::now();
+    volatile double sink = 0.0;
+    for (const Position& p : book) {
+        for (double dt : grid.time) for (double dv : grid.vol) for (double ds : grid.spot) {
+            const double S = p.S * (1.0 + ds);
+            sink = sink + (p.is_call ? callPrice(S, p.K, p.T - dt, p.r, p.sigma + dv)
+                                     : putPrice(S, p.K, p.T - dt, p.r, p.sigma + dv));
+        }
+    }
+    const auto a1 = std::chrono::steady_clock::now();
+    ScenarioCube cube;
+    const auto c = counted([&] { cube = runScenarios(book, grid); });
+    const auto a2 = std::chrono::steady_clock::now();
+
+    const double evals = static_cast<double>(n_positions * grid.spot.size() * grid.vol.size() * grid.time.size());
+    std::cout << "\nScenario grid (" << n_positions << " positions x 21x11x3)\n";
+    std::cout << "  naive_ms=" << std::setprecision(5) << ms_since(a0, a1)
+              << "  engine_ms=" << std::setprecision(5) << ms_since(a1, a2)
+              << "  ns/eval=" << std::setprecision(4) << 1e6 * ms_since(a1, a2) / evals
+              << "  base=" << std::setprecision(8) << cube.base_value << "\n";
+    print_counters("engine", c, evals, "eval");
+}
+
+static void bench_isa_levels(std::size_t n) {
+    std::vector<double> x(n), out(n), S(n, 100.0), K(n), T(n, 0.5), r(n, 0.02), v(n, 0.25);
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = -6.0 + 12.0 * static_cast<double>(i) / static_cast<double>(n);
+        K[i] = 60.0 + 80.0 * static_cast<double>(i) / static_cast<double>(n);
+    }
+
+    std::cout << "\nKernels by ISA level (n=" << n << ", ns/elem; detected "
+              << isaName(detectedIsa()) << ")\n";
+    const IsaLevel active = activeIsa();
+    for (IsaLevel level : {IsaLevel::Generic, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (!setActiveIsa(level)) continue;
+
+        MCResult mc;
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto c_cdf = counted([&] { normal_cdf_batch(x.data(), out.data(), n); });
+        const auto t1 = std::chrono::steady_clock::now();
+        std::uint64_t state = 1;
+        const auto c_rng = counted([&] { rand_standard_normal_fill(state, out.data(), n); });
+        const auto t2 = std::chrono::steady_clock::now();
+        const auto c_bs = counted([&] {
+            callPriceBatch(S.data(), K.data(), T.data(), r.data(), v.data(), out.data(), n);
+        });
+        const auto t3 = std::chrono::steady_clock::now();
+        const auto c_mc = counted([&] { mc = mcCallPrice(100, 100, 1.0, 0.05, 0.2, n, 7, MCMode::Antithetic); });
+        const auto t4 = std::chrono::steady_clock::now();
+
+        const double per = 1e6 / static_cast<double>(n);
+        std::cout << "  " << std::setw(8) << isaName(level)
+                  << "  cdf=" << std::setprecision(4) << per * ms_since(t0, t1)
+                  << "  normals=" << std::setprecision(4) << per * ms_since(t1, t2)
+                  << "  bs=" << std::setprecision(4) << per * ms_since(t2, t3)
+                  << "  mc_path=" << std::setprecision(4) << per * ms_since(t3, t4)
+                  << "  (mc=" << std::setprecision(8) << mc.price << ")\n";
+        const double elems = static_cast<double>(n);
+        print_counters("cdf", c_cdf, elems, "elem");
+        print_counters("normals", c_rng, elems, "normal");
+        print_counters("bs", c_bs, elems, "option");
+        print_counters("mc", c_mc, elems, "path");
+    }
+    setActiveIsa(active);
+}
+
+static void bench_aad(std::size_t paths) {
+    const double S = 100, K = 100, T = 1.0, r = 0.05, v = 0.2;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const MCResult plain = mcCallPrice(S, K, T, r, v, paths, 42, MCMode::Antithetic);
+    const auto t1 = std::chrono::steady_clock::now();
+    const MCSensitivities aad = mcCallAAD(S, K, T, r, v, paths, 42, MCMode::Antithetic);
+    const auto t2 = std::chrono::steady_clock::now();
+
+    // Bumping: one extra revaluation per risk factor (5 inputs, forward differences)
+    std::cout << "\nMC AAD (" << paths << " paths, antithetic)\n";
+    std::cout << "  price_ms=" << std::setprecision(5) << ms_since(t0, t1)
+              << "  aad_ms=" << std::setprecision(5) << ms_since(t1, t2)
+              << "  ratio=" << std::setprecision(3) << ms_since(t1, t2) / ms_since(t0, t1)
+              << "  (bump ratio=6)  price=" << std::setprecision(8) << plain.price
+              << "  delta=" << aad.greeks.dS << "  vega=" << aad.greeks.dsigma
+              << "  tape_nodes=" << aad.tape_peak_nodes << "\n";
+}
+
+static void bench_proxy(std::size_t paths) {
+    const double K = 100, r = 0.02;
+    const ProxyPricer mc = [&](double S, double sigma, double T) {
+        return mcCallPrice(S, K, T, r, sigma, paths, 42, MCMode::AntitheticControlBS).price;
+    };
+
+    ProxyAccuracy acc;
+    const auto t0 = std::chrono::steady_clock::now();
+    const ChebyshevProxy proxy = buildChebyshevProxy(mc, {70.0, 130.0, 24}, {0.1, 0.4, 12}, {1.0, 1.0, 1}, {}, &acc);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const int evals = 1000000;
+    volatile double sink = 0.0;
+    const auto t2 = std::chrono::steady_clock::now();
+    for (int i = 0; i < evals; i++) {
+        double p, d, g;
+        proxy.evaluate(75.0 + 50.0 * i / evals, 0.25, 1.0, p, d, g);
+        sink = sink + p + d + g;
+    }
+    const auto t3 = std::chrono::steady_clock::now();
+    const MCResult ref = mcCallPrice(100, K, 1.0, r, 0.25, paths, 42, MCMode::AntitheticControlBS);
+    const auto t4 = std::chrono::steady_clock::now();
+
+    std::cout << "\nChebyshev proxy of MC (" << paths << " paths, 24x12 spot x vol nodes)\n";
+    std::cout << "  build_ms=" << std::setprecision(5) << ms_since(t0, t1)
+              << "  eval_ns=" << std::setprecision(4) << 1e6 * ms_since(t2, t3) / evals
+              << " (price+delta+gamma)  mc_us=" << std::setprecision(4) << 1e3 * ms_since(t3, t4)
+              << "  max_err=" << std::setprecision(3) << acc.max_abs_error
+              << "  tail=" << acc.tail_estimate << "  mc_stderr=" << ref.stderr << "\n";
+}
+
+// Hedging backtest per path-step against the naive loop: scalar GBM step and
+// callDelta per path and step
+static void bench_hedging(std::size_t paths, std::size_t steps) {
+    HedgeConfig c;
+    c.n_paths = paths;
+    c.n_steps = steps;
+    c.n_threads = 1;
+    c.cost_rate = 0.001;
+    const auto t0 = std::chrono::steady_clock::now();
+    const HedgeResult h = runHedgeBacktest(c);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const std::size_t naive_paths = paths / 10;
+    const double dt = c.T / static_cast<double>(steps), vol = c.sigma * std::sqrt(dt);
+    std::uint64_t state = c.seed;
+    volatile double sink = 0.0;
+    for (std::size_t p = 0; p < naive_paths; p++) {
+        double S = c.S0, pos = 0.0;
+        for (std::size_t k = 0; k < steps; k++) {
+            const double d = callDelta(S, c.K, c.T - static_cast<double>(k) * dt, c.r, c.sigma);
+            sink = sink + (d - pos) * S;
+            pos = d;
+            S *= std::exp(-0.5 * vol * vol + vol * rand_standard_normal(state));
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const double units = static_cast<double>(paths * steps);
+    std::cout << "\nDelta-hedging backtest (" << paths << " paths x " << steps << " steps, 1 thread)\n";
+    std::cout << "  engine_ns=" << std::setprecision(4) << 1e6 * ms_since(t0, t1) / units
+              << " per path-step  naive_ns=" << 1e6 * ms_since(t1, t2) / (units / 10.0)
+              << "  mean_pnl=" << std::setprecision(3) << h.mean_pnl << "  stdev=" << h.stdev_pnl
+              << "  q05=" << h.distribution.quantile(0.05) << "  cost=" << h.mean_cost << "\n";
+}
+
+// Heston ATM call bias against the COS price by step count, QE-M against
+// full-truncation Euler, on Andersen's case I (xi = 1, rho = -0.9, T = 10)
+static void bench_heston(std::size_t paths) {
+    HestonOption o;
+    o.S = 100.0; o.K = 100.0; o.T = 10.0; o.r = 0.0;
+    o.params = {0.5, 0.04, 1.0, -0.9, 0.04};
+    const double ref = cosCallPrices(hestonCharFn(o.T, o.r, o.params), o.S, {o.K}, 4096, 40.0)[0];
+
+    std::cout << "\nHeston MC, Andersen case I (" << paths << " paths, COS price " << std::setprecision(6) << ref << ")\n";
+    for (HestonScheme scheme : {HestonScheme::QE, HestonScheme::Euler}) {
+        for (std::size_t steps : {5, 10, 20, 40, 80, 160}) {
+            if (scheme == HestonScheme::QE && steps > 40) continue;
+            HestonMCOptions opt;
+            opt.scheme = scheme;
+            opt.n_steps = steps;
+            const auto t0 = std::chrono::steady_clock::now();
+            const MCResult r = mcHestonPrice(o, paths, 7, MCMode::Plain, opt);
+            const auto t1 = std::chrono::steady_clock::now();
+            std::cout << "  " << (scheme == HestonScheme::QE ? "QE-M " : "Euler") << " steps=" << std::setw(3) << steps
+                      << "  bias=" << std::setprecision(3) << r.price - ref << "  stderr=" << r.stderr
+                      << "  ns=" << std::setprecision(3) << 1e6 * ms_since(t0, t1) / static_cast<double>(paths * steps)
+                      << " per path-step\n";
+        }
+    }
+}
+
+// Normal pool: generation and reopen time, and a seeded MC price with
+// the draws generated against the same price read from the mapped pool
+static void bench_normal_pool(std::size_t paths, int reps) {
+    const std::string path = "bench_normal_pool.bin";
+    std::remove(path.c_str());
+    NormalPool pool;
+    auto t0 = std::chrono::steady_clock::now();
+    const bool ok = pool.open(path, 7, paths);
+    auto t1 = std::chrono::steady_clock::now();
+    if (!ok) {
+        std::cout << "\nNormal pool: cannot create " << path << "\n";
+        return;
+    }
+    std::cout << "\nNormal pool (" << paths << " normals)\n  generate_ms=" << std::setprecision(3) << ms_since(t0, t1);
+    t0 = std::chrono::steady_clock::now();
+    NormalPool reopened;
+    reopened.open(path, 7, paths);
+    t1 = std::chrono::steady_clock::now();
+    std::cout << "  reopen_ms=" << ms_since(t0, t1) << "\n";
+
+    for (MCMode mode : {MCMode::Plain, MCMode::Antithetic}) {
+        double ms[2];
+        for (int pooled = 0; pooled < 2; pooled++) {
+            mcSetNormalPool(pooled ? &pool : nullptr);
+            volatile double sink = 0.0;
+            t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) sink = sink + mcCallPrice(100.0, 100.0, 1.0, 0.05, 0.2, paths, 7, mode).price;
+            t1 = std::chrono::steady_clock::now();
+            ms[pooled] = ms_since(t0, t1) / reps;
+        }
+        mcSetNormalPool(nullptr);
+        std::cout << "  " << std::left << std::setw(11) << (mode == MCMode::Plain ? "Plain" : "Antithetic") << std::right
+                  << " generated_ms=" << std::setprecision(3) << ms[0] << "  pooled_ms=" << ms[1]
+                  << "  speedup=" << ms[0] / ms[1] << "x\n";
+    }
+    pool.close();
+    reopened.close();
+    std::remove(path.c_str());
+}
+
+// Single- against double-precision MC of the same seeded run: the float
+// kernels hold twice the lanes per vector
+static void bench_float_mc(std::size_t paths, int reps) {
+    std::cout << "\nFloat vs double MC (" << paths << " paths, " << isaName(activeIsa()) << ")\n";
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::AntitheticControlBS};
+    const char* names[] = {"Plain", "Antithetic", "Anti+CV"};
+    for (int m = 0; m < 3; m++) {
+        MCResult res[2];
+        double ms[2];
+        for (int f32 = 0; f32 < 2; f32++) {
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) {
+                res[f32] = f32 ? mcCallPriceT<float>(100.0, 100.0, 1.0, 0.05, 0.2, paths, 7, modes[m])
+                               : mcCallPrice(100.0, 100.0, 1.0, 0.05, 0.2, paths, 7, modes[m]);
+            }
+            ms[f32] = ms_since(t0, std::chrono::steady_clock::now()) / reps;
+        }
+        std::cout << "  " << std::left << std::setw(11) << names[m] << std::right
+                  << " double_ms=" << std::setprecision(3) << ms[0] << "  float_ms=" << ms[1]
+                  << "  speedup=" << ms[0] / ms[1] << "x  |diff|/stderr="
+                  << std::fabs(res[1].price - res[0].price) / res[0].stderr << "\n";
+    }
+}
+
+// Block statistics of MC payoffs (two passes, centred co-moments) per sample
+static void bench_accumulation(int reps) {
+    std::vector<double> X(kMCBlockPaths), Y(kMCBlockPaths);
+    for (std::size_t i = 0; i < kMCBlockPaths; i++) {
+        X[i] = 100.0 + 1e-3 * static_cast<double>(i % 97);
+        Y[i] = 50.0 + 2e-3 * static_cast<double>(i % 89);
+    }
+    std::cout << "\nMC block accumulation (" << kMCBlockPaths << "-path blocks)\n ";
+    for (bool control : {false, true}) {
+        volatile double sink = 0.0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) sink = sink + mcAccumulate(X.data(), Y.data(), X.size(), control, 50.0).M2;
+        const auto t1 = std::chrono::steady_clock::now();
+        std::cout << (control ? "  control_ns=" : " plain_ns=") << std::setprecision(3)
+                  << 1e6 * ms_since(t0, t1) / (static_cast<double>(reps) * kMCBlockPaths);
     }
+    std::cout << " per sample\n";
 }
 
-int main() {
+int main(int argc, char** argv) {
+    bool want_counters = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        if (a == "--counters") want_counters = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--counters]\n";
+            return 1;
+        }
+    }
+
+    // Hardware counters are optional: without permission the timings still run
+    PerfCounters counters;
+    if (want_counters) {
+        if (counters.available()) {
+            g_counters = &counters;
+            std::cout << "Hardware counters:";
+            for (int e = 0; e < PerfCounters::kEventCount; e++) {
+                const auto ev = static_cast<PerfCounters::Event>(e);
+                if (!counters.has(ev)) std::cout << " " << PerfCounters::name(ev) << "=n/a";
+                else std::cout << " " << PerfCounters::name(ev);
+            }
+            std::cout << "\n";
+        } else {
+            std::cout << "Hardware counters unavailable: " << counters.unavailableReason() << "\n";
+        }
+    }
+
     const std::vector<std::size_t> paths = {1000, 5000, 20000, 100000, 200000};
     const std::uint64_t seed = 123456;
 
@@ -65,5 +467,28 @@ int main() {
     // secondary case to verify values 
     bench_case(100, 110, 0.5, 0.03, 0.25, seed, paths);
 
+    // Fourier chain pricing (calibration workload)
+    bench_fourier_chain(100, 1.0, 0.02, 50, 200);
+
+    // Full-surface recalibration (refresh window budget)
+    bench_surface_calibration(100, 0.02, 20, 41);
+
+    // End-of-day risk grid
+    bench_scenarios(2000);
+
+    // Same kernels at every ISA level this CPU runs
+    bench_isa_levels(1 << 20);
+    bench_float_mc(2000000, 5);
+    bench_accumulation(20000);
+
+    // Offline proxy of an MC pricer, evaluated per tick
+    bench_proxy(20000);
+    bench_hedging(100000, 52);
+    bench_heston(100000);
+    bench_normal_pool(1000000, 20);
+
+    // Price plus all first-order sensitivities in one reverse sweep
+    bench_aad(200000);
+
     return 0;
 }
@@ -0,0 +1,133 @@
+// Mixed-portfolio scaling: static thread split vs work-stealing scheduler
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include "black_scholes.h"
+#include "implied_vol.h"
+#include "monte_carlo.h"
+#include "scheduler.h"
+
+namespace {
+
+struct Portfolio {
+    std::vector<MCJob> mc;
+    std::vector<BSQuote> bs;
+    std::vector<IVQuote> iv;
+};
+
+// Skewed book: a few multi-million-path MC runs, many small ones, and a large
+// number of microsecond closed-form prices and implied vols.
+Portfolio make_portfolio() {
+    Portfolio p;
+    for (int i = 0; i < 4; i++)  p.mc.push_back({true, 100, 90.0 + 5 * i, 1.0, 0.03, 0.2, 2000000, 11u + i, MCMode::Antithetic});
+    for (int i = 0; i < 64; i++) p.mc.push_back({i % 2 == 0, 100, 80.0 + i, 0.5, 0.03, 0.25, 20000, 100u + i, MCMode::Plain});
+    for (int i = 0; i < 40000; i++) {
+        const double K = 50.0 + 0.0025 * i;
+        p.bs.push_back({i % 2 == 0, 100.0, K, 0.75, 0.02, 0.22});
+    }
+    for (int i = 0; i < 4000; i++) {
+        const double K = 70.0 + 0.015 * i;
+        p.iv.push_back({true, callPrice(100.0, K, 0.5, 0.02, 0.3), 100.0, K, 0.5, 0.02});
+    }
+    return p;
+}
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Naive pool: every job is one indivisible unit, split statically by index
+double run_static(const Portfolio& p, std::size_t n_threads) {
+    struct Unit { int kind; std::size_t idx; };
+    std::vector<Unit> units;
+    for (std::size_t i = 0; i < p.mc.size(); i++) units.push_back({0, i});
+    for (std::size_t i = 0; i < p.bs.size(); i += 512) units.push_back({1, i});
+    for (std::size_t i = 0; i < p.iv.size(); i += 64) units.push_back({2, i});
+
+    std::vector<double> sink(n_threads, 0.0);
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    const std::size_t per = (units.size() + n_threads - 1) / n_threads;
+    for (std::size_t t = 0; t < n_threads; t++) {
+        pool.emplace_back([&, t] {
+            const std::size_t lo = t * per, hi = std::min(units.size(), lo + per);
+            for (std::size_t u = lo; u < hi; u++) {
+                const Unit& w = units[u];
+                if (w.kind == 0) {
+                    const MCJob& j = p.mc[w.idx];
+                    sink[t] += (j.is_call ? mcCallPrice(j.S, j.K, j.T, j.r, j.sigma, j.n_paths, j.seed, j.mode)
+                                          : mcPutPrice(j.S, j.K, j.T, j.r, j.sigma, j.n_paths, j.seed, j.mode)).price;
+                } else if (w.kind == 1) {
+                    for (std::size_t i = w.idx; i < std::min(p.bs.size(), w.idx + 512); i++) {
+                        const BSQuote& q = p.bs[i];
+                        sink[t] += q.is_call ? callPrice(q.S, q.K, q.T, q.r, q.sigma) : putPrice(q.S, q.K, q.T, q.r, q.sigma);
+                    }
+                } else {
+                    for (std::size_t i = w.idx; i < std::min(p.iv.size(), w.idx + 64); i++) {
+                        const IVQuote& q = p.iv[i];
+                        sink[t] += impliedVolCall(q.market_price, q.S, q.K, q.T, q.r).sigma;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    return ms_since(t0);
+}
+
+double run_stealing(const Portfolio& p, std::size_t n_threads) {
+    TaskScheduler sched(n_threads);
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<JobHandle<MCResult>> mc;
+    for (const MCJob& j : p.mc) mc.push_back(submitMC(sched, j));
+    const auto bs = submitBSBatch(sched, p.bs);
+    const auto iv = submitIVBatch(sched, p.iv);
+
+    for (const auto& h : mc) h.wait();
+    bs.wait();
+    iv.wait();
+    return ms_since(t0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 2 && std::string(argv[1]) == "--threads") max_threads = std::stoul(argv[2]);
+
+    const Portfolio p = make_portfolio();
+    std::cout << "Mixed portfolio: " << p.mc.size() << " MC jobs, " << p.bs.size()
+              << " BS prices, " << p.iv.size() << " implied vols\n\n";
+
+    std::cout << std::left
+              << std::setw(10) << "threads"
+              << std::setw(14) << "static_ms"
+              << std::setw(14) << "stealing_ms"
+              << std::setw(16) << "static_speedup"
+              << std::setw(16) << "steal_speedup"
+              << "\n";
+
+    double base_static = 0.0, base_steal = 0.0;
+    for (std::size_t n = 1; n <= max_threads; n *= 2) {
+        const double ts = run_static(p, n);
+        const double tw = run_stealing(p, n);
+        if (n == 1) { base_static = ts; base_steal = tw; }
+
+        std::cout << std::left
+                  << std::setw(10) << n
+                  << std::setw(14) << std::setprecision(5) << ts
+                  << std::setw(14) << std::setprecision(5) << tw
+                  << std::setw(16) << std::setprecision(3) << base_static / ts
+                  << std::setw(16) << std::setprecision(3) << base_steal / tw
+                  << "\n";
+        if (n * 2 > max_threads && n != max_threads) n = max_threads / 2;
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+// Market-data replay: drives repricing of an option chain from a tick stream
+// (spot updates and option quotes) and reports the per-tick latency
+// distribution (p50/p99/p99.9/max) and throughput.
+//
+//   spot update -> reprice the whole chain at the new spot: price, delta,
+//                  gamma and vega of every option at its last implied vol
+//   quote       -> implied vol of the quoted option (warm-started from its
+//                  previous vol), then its price and Greeks
+//
+// Ticks are replayed back to back (--speed 0, the default) or paced at the
+// recorded timestamps, optionally accelerated (--speed 10 = 10x). When paced,
+// latency is also measured from each tick's scheduled arrival, so a slow tick
+// shows up in the latency of the ticks queued behind it.
+//
+// Tick file: one tick per line, '#' starts a comment
+//   spot,<time_s>,<spot>
+//   quote,<time_s>,<call|put>,<strike>,<expiry_years>,<price>
+// With no --ticks file a synthetic stream is generated (--generate FILE
+// writes it out for later replays).
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include "black_scholes.h"
+#include "greeks.h"
+#include "implied_vol.h"
+#include "utils.h"
+#include "latency_histogram.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct OptionSpec {
+    bool is_call;
+    double K, T;
+};
+
+struct Tick {
+    double time;        // seconds from the start of the recording
+    bool is_quote;
+    std::size_t option; // chain index (quotes only)
+    double value;       // spot, or the quoted option price
+};
+
+struct TickStream {
+    std::vector<OptionSpec> chain;
+    std::vector<Tick> ticks;
+};
+
+// Per-option state kept across ticks
+struct OptionState {
+    double iv = 0.2;
+    double price = 0.0, delta = 0.0, gamma = 0.0, vega = 0.0;
+};
+
+struct SynthConfig {
+    std::size_t n_ticks = 200000;
+    double ticks_per_second = 5000.0;
+    double quote_share = 0.8;       // the rest are spot updates
+    std::size_t n_strikes = 21;
+    std::size_t n_expiries = 4;
+    double spot = 100.0, rate = 0.02, vol = 0.2;
+    std::uint64_t seed = 7;
+};
+
+std::size_t chain_index(std::map<std::tuple<bool, double, double>, std::size_t>& index,
+                        std::vector<OptionSpec>& chain, bool is_call, double K, double T) {
+    const auto key = std::make_tuple(is_call, K, T);
+    const auto it = index.find(key);
+    if (it != index.end()) return it->second;
+    chain.push_back({is_call, K, T});
+    index.emplace(key, chain.size() - 1);
+    return chain.size() - 1;
+}
+
+// Skewed smile sigma(K, T) for the synthetic quotes
+double smile_vol(double base, double S, double K, double T) {
+    const double m = std::log(K / S) / std::sqrt(T);
+    return std::max(0.05, base - 0.1 * m + 0.15 * m * m);
+}
+
+TickStream generate(const SynthConfig& cfg) {
+    TickStream s;
+    for (std::size_t e = 0; e < cfg.n_expiries; e++) {
+        const double T = 0.1 + 0.3 * static_cast<double>(e);
+        for (std::size_t i = 0; i < cfg.n_strikes; i++) {
+            const double K = cfg.spot * (0.7 + 0.6 * static_cast<double>(i) / static_cast<double>(cfg.n_strikes - 1));
+            s.chain.push_back({true, K, T});
+            s.chain.push_back({false, K, T});
+        }
+    }
+
+    std::uint64_t state = cfg.seed;
+    double t = 0.0, S = cfg.spot;
+    s.ticks.reserve(cfg.n_ticks);
+    s.ticks.push_back({t, false, 0, S});
+    for (std::size_t n = 1; n < cfg.n_ticks; n++) {
+        // Poisson arrivals; the spot follows a driftless GBM in calendar time
+        const double dt = -std::log(1.0 - rand_uniform_01(state)) / cfg.ticks_per_second;
+        t += dt;
+        const double year_dt = dt / (252.0 * 6.5 * 3600.0);
+        S *= std::exp(-0.5 * cfg.vol * cfg.vol * year_dt + cfg.vol * std::sqrt(year_dt) * rand_standard_normal(state));
+
+        if (rand_uniform_01(state) >= cfg.quote_share) {
+            s.ticks.push_back({t, false, 0, S});
+            continue;
+        }
+        const std::size_t k = std::min(static_cast<std::size_t>(rand_uniform_01(state) * static_cast<double>(s.chain.size())),
+                                       s.chain.size() - 1);
+        const OptionSpec& o = s.chain[k];
+        // Quote noise in vol space keeps prices inside the no-arbitrage bounds
+        const double v = smile_vol(cfg.vol, S, o.K, o.T) * (1.0 + 0.01 * rand_standard_normal(state));
+        const double px = o.is_call ? callPrice(S, o.K, o.T, cfg.rate, v) : putPrice(S, o.K, o.T, cfg.rate, v);
+        s.ticks.push_back({t, true, k, px});
+    }
+    return s;
+}
+
+bool write_ticks(const std::string& path, const TickStream& s) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# spot,<time_s>,<spot> | quote,<time_s>,<call|put>,<strike>,<expiry_years>,<price>\n";
+    out << std::setprecision(17);
+    for (const Tick& t : s.ticks) {
+        if (!t.is_quote) {
+            out << "spot," << t.time << ',' << t.value << '\n';
+        } else {
+            const OptionSpec& o = s.chain[t.option];
+            out << "quote," << t.time << ',' << (o.is_call ? "call" : "put") << ',' << o.K << ',' << o.T
+                << ',' << t.value << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool read_ticks(const std::string& path, TickStream& s, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::map<std::tuple<bool, double, double>, std::size_t> index;
+    std::string line;
+    std::size_t line_no = 0;
+    while (std::getline(in, line)) {
+        line_no++;
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::vector<std::string> f;
+        std::stringstream ss(line);
+        for (std::string cell; std::getline(ss, cell, ',');) f.push_back(cell);
+        try {
+            if (f.size() == 3 && f[0] == "spot") {
+                s.ticks.push_back({std::stod(f[1]), false, 0, std::stod(f[2])});
+                continue;
+            }
+            if (f.size() == 6 && f[0] == "quote" && (f[2] == "call" || f[2] == "put")) {
+                const std::size_t k = chain_index(index, s.chain, f[2] == "call", std::stod(f[3]), std::stod(f[4]));
+                s.ticks.push_back({std::stod(f[1]), true, k, std::stod(f[5])});
+                continue;
+            }
+        } catch (const std::exception&) {
+        }
+        error = path + ":" + std::to_string(line_no) + ": malformed tick";
+        return false;
+    }
+    if (s.ticks.empty() || s.ticks.front().is_quote) {
+        error = path + ": the first tick must be a spot update";
+        return false;
+    }
+    return true;
+}
+
+void greeks_at(const OptionSpec& o, OptionState& st, double S, double r) {
+    st.price = o.is_call ? callPrice(S, o.K, o.T, r, st.iv) : putPrice(S, o.K, o.T, r, st.iv);
+    st.delta = o.is_call ? callDelta(S, o.K, o.T, r, st.iv) : putDelta(S, o.K, o.T, r, st.iv);
+    st.gamma = gamma(S, o.K, o.T, r, st.iv);
+    st.vega = vega(S, o.K, o.T, r, st.iv);
+}
+
+struct ReplayStats {
+    LatencyHistogram spot_ns, quote_ns, all_ns, response_ns;
+    std::size_t iv_failures = 0;   // e.g. quotes at intrinsic value; the previous vol is kept
+    double wall_s = 0.0;
+    double chain_value = 0.0;   // checksum so the work is not optimised away
+};
+
+void replay(const TickStream& s, double r, double speed, ReplayStats& out) {
+    std::vector<OptionState> book(s.chain.size());
+    double S = s.ticks.front().value;
+    for (std::size_t i = 0; i < book.size(); i++) greeks_at(s.chain[i], book[i], S, r);
+
+    const double t_first = s.ticks.front().time;
+    const Clock::time_point start = Clock::now();
+    for (const Tick& t : s.ticks) {
+        Clock::time_point due = start;
+        if (speed > 0.0) {
+            due += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((t.time - t_first) / speed));
+            while (Clock::now() < due) {
+            }
+        }
+
+        const Clock::time_point a = Clock::now();
+        if (t.is_quote) {
+            const OptionSpec& o = s.chain[t.option];
+            OptionState& st = book[t.option];
+            const IVResult iv = o.is_call ? impliedVolCall(t.value, S, o.K, o.T, r, st.iv)
+                                          : impliedVolPut(t.value, S, o.K, o.T, r, st.iv);
+            if (iv.converged && std::isfinite(iv.sigma)) st.iv = iv.sigma;
+            else out.iv_failures++;
+            greeks_at(o, st, S, r);
+        } else {
+            S = t.value;
+            for (std::size_t i = 0; i < book.size(); i++) greeks_at(s.chain[i], book[i], S, r);
+        }
+        const Clock::time_point b = Clock::now();
+
+        const auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+        (t.is_quote ? out.quote_ns : out.spot_ns).record(ns);
+        out.all_ns.record(ns);
+        if (speed > 0.0) {
+            out.response_ns.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(b - due).count()));
+        }
+    }
+    out.wall_s = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const OptionState& st : book) out.chain_value += st.price;
+}
+
+void print_row(const char* name, const LatencyHistogram& h) {
+    if (h.count() == 0) return;
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(10) << h.count()
+              << std::setw(11) << std::setprecision(4) << h.mean() * 1e-3
+              << std::setw(11) << std::setprecision(4) << h.percentile(50.0) * 1e-3
+              << std::setw(11) << std::setprecision(4) << h.percentile(99.0) * 1e-3
+              << std::setw(11) << std::setprecision(4) << h.percentile(99.9) * 1e-3
+              << std::setw(11) << std::setprecision(4) << h.max() * 1e-3 << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string ticks_path, generate_path;
+    double speed = 0.0, rate = 0.02;
+    SynthConfig synth;
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        if (a == "--ticks" && i + 1 < argc) ticks_path = argv[++i];
+        else if (a == "--generate" && i + 1 < argc) generate_path = argv[++i];
+        else if (a == "--speed" && i + 1 < argc) speed = std::stod(argv[++i]);
+        else if (a == "--rate" && i + 1 < argc) rate = std::stod(argv[++i]);
+        else if (a == "--synthetic" && i + 1 < argc) synth.n_ticks = std::stoul(argv[++i]);
+        else if (a == "--seed" && i + 1 < argc) synth.seed = std::stoull(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--ticks FILE | --synthetic N [--seed S] [--generate FILE]]"
+                      << " [--speed X] [--rate R]\n";
+            return 1;
+        }
+    }
+
+    TickStream stream;
+    if (!ticks_path.empty()) {
+        std::string error;
+        if (!read_ticks(ticks_path, stream, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    } else {
+        synth.rate = rate;
+        stream = generate(synth);
+        if (!generate_path.empty() && !write_ticks(generate_path, stream)) {
+            std::cerr << "cannot write " << generate_path << "\n";
+            return 1;
+        }
+    }
+
+    ReplayStats stats;
+    replay(stream, rate, speed, stats);
+
+    const double recorded_s = stream.ticks.back().time - stream.ticks.front().time;
+    std::cout << "Replayed " << stream.ticks.size() << " ticks over a " << stream.chain.size() << "-option chain ("
+              << (ticks_path.empty() ? "synthetic" : ticks_path) << "), "
+              << (speed > 0.0 ? "paced at " : "back to back");
+    if (speed > 0.0) std::cout << speed << "x";
+    std::cout << "\n";
+    std::cout << "  wall=" << std::setprecision(4) << stats.wall_s << "s  recorded=" << recorded_s
+              << "s  throughput=" << std::setprecision(6) << static_cast<double>(stream.ticks.size()) / stats.wall_s
+              << " ticks/s  iv_unsolved=" << stats.iv_failures
+              << "  chain_value=" << std::setprecision(8) << stats.chain_value << "\n\n";
+
+    std::cout << std::left << std::setw(12) << "latency_us" << std::right << std::setw(10) << "count"
+              << std::setw(11) << "mean" << std::setw(11) << "p50" << std::setw(11) << "p99"
+              << std::setw(11) << "p99.9" << std::setw(11) << "max" << "\n";
+    print_row("spot", stats.spot_ns);
+    print_row("quote", stats.quote_ns);
+    print_row("all", stats.all_ns);
+    print_row("response", stats.response_ns);
+    return 0;
+}
@@ -0,0 +1,237 @@
+// Variance-reduction efficiency: for every MC mode over a grid of path
+// counts, moneyness and maturities, repeated over seeds, reports
+//   efficiency = 1 / (stderr^2 * time)   and the gain over plain MC,
+//   CI coverage of the Black–Scholes price and empirical / reported stderr,
+//   time to reach a target relative stderr,
+// as CSV and JSON (one record per grid point) plus a best-mode summary.
+// A mode is only picked as best where its stderr is defined, rests on
+// enough independent batches, and its CIs cover close to 95%.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "black_scholes.h"
+#include "monte_carlo.h"
+
+namespace {
+
+struct ModeInfo {
+    MCMode mode;
+    const char* name;
+    bool batch_means;   // stderr from one batch per block, not per path
+};
+
+// New modes only need a line here
+const ModeInfo kModes[] = {
+    {MCMode::Plain, "plain", false},
+    {MCMode::Antithetic, "anti", false},
+    {MCMode::ControlVariateBS, "cv", false},
+    {MCMode::AntitheticControlBS, "anti+cv", false},
+    {MCMode::ImportanceSampling, "is", false},
+    {MCMode::AntitheticImportance, "anti+is", false},
+    {MCMode::MomentMatching, "mm", true},
+    {MCMode::AntitheticMomentMatching, "anti+mm", true},
+    {MCMode::MartingaleCorrection, "emc", true},
+    {MCMode::AntitheticMartingale, "anti+emc", true},
+};
+
+struct Moneyness {
+    const char* name;
+    double k_over_s;
+};
+
+const Moneyness kMoneyness[] = {{"itm", 0.8}, {"atm", 1.0}, {"otm", 1.25}, {"deep_otm", 1.6}};
+
+constexpr double kS = 100.0, kR = 0.03, kSigma = 0.2;
+constexpr double kTargetRelStderr = 1e-3;   // time-to-target: stderr = 0.1% of the price
+constexpr std::size_t kMinBatches = 20;     // fewer leave the stderr itself too noisy to rank by
+
+struct Point {
+    std::string mode, moneyness;
+    double K = 0.0, T = 0.0;
+    std::size_t paths = 0, seeds = 0;
+    std::size_t batches = 0;        // independent samples behind each stderr
+    double bs = 0.0;
+    double mean_price = 0.0;
+    double mean_stderr = 0.0;       // reported, RMS over seeds
+    double empirical_stderr = 0.0;  // sd of the price across seeds
+    double coverage = 0.0;          // share of 95% CIs containing the BS price
+    double mean_ms = 0.0;
+    double efficiency = 0.0;        // 1 / (stderr^2 * seconds)
+    double gain_vs_plain = 0.0;
+    double time_to_target_ms = 0.0;
+    bool valid = false;             // stderr defined and positive, >= kMinBatches batches
+};
+
+// Coverage within two binomial standard deviations of 95% for this many seeds
+bool coverage_ok(const Point& p) {
+    const double tol = std::max(2.0 * std::sqrt(0.95 * 0.05 / static_cast<double>(p.seeds)), 0.02);
+    return std::fabs(p.coverage - 0.95) <= tol;
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+Point measure(const ModeInfo& m, const Moneyness& mny, double T, std::size_t paths, std::size_t seeds) {
+    Point p;
+    p.mode = m.name;
+    p.moneyness = mny.name;
+    p.K = kS * mny.k_over_s;
+    p.T = T;
+    p.paths = paths;
+    p.seeds = seeds;
+    p.batches = m.batch_means ? mcBlockCount(paths) : paths;
+    p.bs = callPrice(kS, p.K, T, kR, kSigma);
+
+    double sum_p = 0.0, sum_pp = 0.0, sum_var = 0.0, total_ms = 0.0;
+    std::size_t covered = 0;
+    for (std::size_t s = 0; s < seeds; s++) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const MCResult r = mcCallPrice(kS, p.K, T, kR, kSigma, paths, 1000 + 7919 * s, m.mode);
+        total_ms += ms_since(t0);
+
+        sum_p += r.price;
+        sum_pp += r.price * r.price;
+        sum_var += r.stderr * r.stderr;
+        if (r.ci_low <= p.bs && p.bs <= r.ci_high) covered++;
+    }
+
+    const double n = static_cast<double>(seeds);
+    p.mean_price = sum_p / n;
+    p.mean_stderr = std::sqrt(sum_var / n);
+    p.empirical_stderr = (seeds > 1) ? std::sqrt(std::max(sum_pp - n * p.mean_price * p.mean_price, 0.0) / (n - 1.0)) : 0.0;
+    p.coverage = static_cast<double>(covered) / n;
+    p.mean_ms = total_ms / n;
+
+    // A zero or undefined stderr (a lone batch, a degenerate payoff) says
+    // nothing about efficiency: the point is kept but not ranked
+    const double var = p.mean_stderr * p.mean_stderr;
+    p.valid = var > 0.0 && std::isfinite(var) && p.mean_ms > 0.0 && p.batches >= kMinBatches;
+    p.efficiency = p.valid ? 1.0 / (var * p.mean_ms * 1e-3) : NAN;
+    const double target = kTargetRelStderr * p.bs;
+    p.time_to_target_ms = p.valid ? p.mean_ms * var / (target * target) : NAN;
+    return p;
+}
+
+void write_csv(const std::string& path, const std::vector<Point>& pts) {
+    std::ofstream out(path);
+    out << "mode,moneyness,K,T,paths,seeds,bs_price,mean_price,reported_stderr,empirical_stderr,"
+           "coverage_95,time_ms,efficiency,gain_vs_plain,time_to_target_ms,batches,valid\n";
+    out << std::setprecision(10);
+    for (const Point& p : pts) {
+        out << p.mode << ',' << p.moneyness << ',' << p.K << ',' << p.T << ',' << p.paths << ','
+            << p.seeds << ',' << p.bs << ',' << p.mean_price << ',' << p.mean_stderr << ','
+            << p.empirical_stderr << ',' << p.coverage << ',' << p.mean_ms << ',' << p.efficiency << ','
+            << p.gain_vs_plain << ',' << p.time_to_target_ms << ',' << p.batches << ','
+            << (p.valid ? 1 : 0) << '\n';
+    }
+}
+
+// JSON has no infinity: non-finite values are written as null
+void json_number(std::ofstream& out, double v) {
+    if (std::isfinite(v)) out << v;
+    else out << "null";
+}
+
+void write_json(const std::string& path, const std::vector<Point>& pts) {
+    std::ofstream out(path);
+    out << std::setprecision(10);
+    out << "{\n  \"spot\": " << kS << ", \"rate\": " << kR << ", \"sigma\": " << kSigma
+        << ", \"target_rel_stderr\": " << kTargetRelStderr << ",\n  \"points\": [\n";
+    for (std::size_t i = 0; i < pts.size(); i++) {
+        const Point& p = pts[i];
+        out << "    {\"mode\": \"" << p.mode << "\", \"moneyness\": \"" << p.moneyness << "\", \"K\": " << p.K
+            << ", \"T\": " << p.T << ", \"paths\": " << p.paths << ", \"seeds\": " << p.seeds
+            << ", \"bs_price\": " << p.bs << ", \"mean_price\": " << p.mean_price
+            << ", \"reported_stderr\": " << p.mean_stderr << ", \"empirical_stderr\": " << p.empirical_stderr
+            << ", \"coverage_95\": " << p.coverage << ", \"time_ms\": " << p.mean_ms << ", \"efficiency\": ";
+        json_number(out, p.efficiency);
+        out << ", \"gain_vs_plain\": ";
+        json_number(out, p.gain_vs_plain);
+        out << ", \"time_to_target_ms\": ";
+        json_number(out, p.time_to_target_ms);
+        out << ", \"batches\": " << p.batches << ", \"valid\": " << (p.valid ? "true" : "false");
+        out << "}" << (i + 1 < pts.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t seeds = 8;
+    std::string csv = "vr_efficiency.csv", json = "vr_efficiency.json";
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        if (a == "--quick") quick = true;
+        else if (a == "--seeds" && i + 1 < argc) seeds = std::max<std::size_t>(2, std::stoul(argv[++i]));
+        else if (a == "--csv" && i + 1 < argc) csv = argv[++i];
+        else if (a == "--json" && i + 1 < argc) json = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--seeds N] [--csv FILE] [--json FILE]\n";
+            return 1;
+        }
+    }
+
+    const std::vector<double> maturities = quick ? std::vector<double>{1.0} : std::vector<double>{0.25, 1.0, 3.0};
+    const std::vector<std::size_t> path_counts = quick ? std::vector<std::size_t>{1u << 14}
+                                                       : std::vector<std::size_t>{1u << 14, 1u << 16, 1u << 18};
+
+    std::vector<Point> pts;
+    for (const Moneyness& mny : kMoneyness) {
+        for (double T : maturities) {
+            for (std::size_t n : path_counts) {
+                const std::size_t first = pts.size();
+                for (const ModeInfo& m : kModes) pts.push_back(measure(m, mny, T, n, seeds));
+                // kModes[0] is plain MC, the baseline of this grid point
+                for (std::size_t i = first; i < pts.size(); i++) {
+                    pts[i].gain_vs_plain = (pts[i].valid && pts[first].valid)
+                        ? pts[i].efficiency / pts[first].efficiency : NAN;
+                }
+            }
+        }
+    }
+
+    write_csv(csv, pts);
+    write_json(json, pts);
+
+    // Best mode per instrument class at the largest path count, among
+    // modes whose stderr can be trusted there
+    std::cout << "Efficiency 1/(stderr^2 * s), " << seeds << " seeds per point, paths = "
+              << path_counts.back() << "; candidates need >= " << kMinBatches
+              << " batches and coverage near 0.95\n\n";
+    std::cout << std::left << std::setw(11) << "moneyness" << std::setw(7) << "T" << std::setw(10) << "best"
+              << std::setw(12) << "gain" << std::setw(10) << "coverage" << std::setw(14) << "to_target_ms"
+              << std::setw(16) << "plain_to_target" << "\n";
+    for (const Moneyness& mny : kMoneyness) {
+        for (double T : maturities) {
+            const Point* plain = nullptr;
+            const Point* best = nullptr;
+            for (const Point& p : pts) {
+                if (p.moneyness != mny.name || p.T != T || p.paths != path_counts.back()) continue;
+                if (p.mode == kModes[0].name) plain = &p;
+                if (!p.valid || !coverage_ok(p)) continue;
+                if (!best || p.efficiency > best->efficiency) best = &p;
+            }
+            if (!best) {
+                std::cout << std::left << std::setw(11) << mny.name << std::setw(7) << T << "no mode qualifies\n";
+                continue;
+            }
+            std::cout << std::left << std::setw(11) << mny.name << std::setw(7) << T << std::setw(10) << best->mode
+                      << std::setw(12) << std::setprecision(4) << best->gain_vs_plain
+                      << std::setw(10) << std::setprecision(3) << best->coverage
+                      << std::setw(14) << std::setprecision(4) << best->time_to_target_ms
+                      << std::setw(16) << std::setprecision(4) << plain->time_to_target_ms << "\n";
+        }
+    }
+    std::cout << "\nWrote " << pts.size() << " points to " << csv << " and " << json << "\n";
+    return 0;
+}
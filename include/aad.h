@@ -0,0 +1,167 @@
+// aad.h
+
+#ifndef AAD_H
+#define AAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "monte_carlo.h"
+#include "pricing_session.h"
+
+class Tape;
+
+// Active double for reverse-mode AAD. Each operation on an ADouble attached
+// to a tape records one node (value, up to two parents and the local
+// partials); plain constants carry no tape.
+struct ADouble {
+    double value = 0.0;
+    std::uint32_t node = kNoNode;
+    Tape* tape = nullptr;
+
+    static constexpr std::uint32_t kNoNode = 0xffffffffu;
+
+    ADouble() = default;
+    ADouble(double v) : value(v) {}   // NOLINT: constants convert implicitly
+    ADouble(double v, std::uint32_t n, Tape* t) : value(v), node(n), tape(t) {}
+};
+
+// Operation tape. Nodes live in fixed-size pages carved from a ScratchArena;
+// pages are kept on rewind, so recording the same computation again (the
+// next MC path block) does not allocate.
+class Tape {
+public:
+    struct Mark {
+        std::size_t nodes;
+    };
+
+    Tape();                                   // private arena
+    explicit Tape(ScratchArena& arena);       // pages from `arena`, which must outlive the tape
+
+    Tape(const Tape&) = delete;
+    Tape& operator=(const Tape&) = delete;
+
+    // New independent variable
+    ADouble input(double v);
+
+    // Records a node with up to two parents (ADouble::kNoNode for none)
+    std::uint32_t record(std::uint32_t p0, double d0, std::uint32_t p1 = ADouble::kNoNode, double d1 = 0.0) {
+        if (size_ == capacity_) add_page();
+        const std::uint32_t i = static_cast<std::uint32_t>(size_++);
+        if (size_ > peak_) peak_ = size_;
+        Node& n = at(i);
+        n.d[0] = d0; n.d[1] = d1;
+        n.p[0] = p0; n.p[1] = p1;
+        n.adj = 0.0;
+        return i;
+    }
+
+    Mark mark() const { return {size_}; }
+    void rewind(const Mark& m) { size_ = m.nodes; }   // drops every node recorded after m
+    std::size_t size() const { return size_; }
+    std::size_t peakSize() const { return peak_; }
+
+    double& adjoint(std::uint32_t node) { return at(node).adj; }
+    double adjoint(const ADouble& x) { return x.tape == this ? at(x.node).adj : 0.0; }
+
+    // Zeroes the adjoints of nodes [from.nodes, size())
+    void clearAdjoints(const Mark& from = Mark{0});
+
+    // Reverse sweep over nodes [to.nodes, size()), last to first, pushing
+    // each node's adjoint into its parents (parents below `to` accumulate)
+    void propagate(const Mark& to = Mark{0});
+
+private:
+    struct Node {
+        double d[2];
+        std::uint32_t p[2];
+        double adj;
+    };
+
+    static constexpr std::size_t kPageBits = 12;
+    static constexpr std::size_t kPageNodes = std::size_t(1) << kPageBits;
+
+    Node& at(std::uint32_t i) { return pages_[i >> kPageBits][i & (kPageNodes - 1)]; }
+    void add_page();
+
+    std::unique_ptr<ScratchArena> own_;
+    ScratchArena* arena_;
+    std::vector<Node*> pages_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t peak_ = 0;
+};
+
+namespace aad_detail {
+    inline ADouble unary(const ADouble& x, double v, double d) {
+        if (!x.tape) return ADouble(v);
+        return {v, x.tape->record(x.node, d), x.tape};
+    }
+
+    inline ADouble binary(const ADouble& a, const ADouble& b, double v, double da, double db) {
+        Tape* t = a.tape ? a.tape : b.tape;
+        if (!t) return ADouble(v);
+        return {v, t->record(a.tape ? a.node : ADouble::kNoNode, da,
+                             b.tape ? b.node : ADouble::kNoNode, db), t};
+    }
+}
+
+// Arithmetic is inline so recording costs little more than the double ops
+inline ADouble operator+(const ADouble& a, const ADouble& b) {
+    return aad_detail::binary(a, b, a.value + b.value, 1.0, 1.0);
+}
+inline ADouble operator-(const ADouble& a, const ADouble& b) {
+    return aad_detail::binary(a, b, a.value - b.value, 1.0, -1.0);
+}
+inline ADouble operator*(const ADouble& a, const ADouble& b) {
+    return aad_detail::binary(a, b, a.value * b.value, b.value, a.value);
+}
+inline ADouble operator/(const ADouble& a, const ADouble& b) {
+    const double q = a.value / b.value;
+    return aad_detail::binary(a, b, q, 1.0 / b.value, -q / b.value);
+}
+inline ADouble operator-(const ADouble& a) { return aad_detail::unary(a, -a.value, -1.0); }
+
+// derivative follows the larger argument
+inline ADouble max(const ADouble& a, const ADouble& b) {
+    const bool first = !(a.value < b.value);
+    return aad_detail::binary(a, b, first ? a.value : b.value, first ? 1.0 : 0.0, first ? 0.0 : 1.0);
+}
+
+ADouble exp(const ADouble& x);
+ADouble log(const ADouble& x);
+ADouble sqrt(const ADouble& x);
+ADouble normal_cdf(const ADouble& x);
+
+// Price and first-order sensitivities to every input. In Greek terms:
+// delta = dS, vega = dsigma, rho = dr, theta = -dT (per year).
+struct Sensitivities {
+    double price = 0.0;
+    double dS = 0.0, dK = 0.0, dT = 0.0, dr = 0.0, dsigma = 0.0;
+};
+
+// Black–Scholes by reverse sweep over one recorded price evaluation
+// (NAN fields where callPrice/putPrice are degenerate: T <= 0, sigma <= 0, ...)
+Sensitivities bsCallAAD(double S, double K, double T, double r, double sigma);
+Sensitivities bsPutAAD(double S, double K, double T, double r, double sigma);
+
+struct MCSensitivities {
+    MCResult result;                 // identical to mcCallPrice / mcPutPrice
+    Sensitivities greeks;            // pathwise, of the same estimator
+    std::size_t tape_peak_nodes = 0; // bounded by one slice's recording
+};
+
+// Monte Carlo price with pathwise AAD sensitivities. Run constants are
+// recorded once; each path block is recorded, swept back into them and
+// rewound (checkpointing, in cache-sized slices of a block), so tape memory
+// is bounded whatever n_paths is. With a control variate the coefficient b is held fixed:
+// d(price) = d(mean X) - b (d(mean Y) - dS). Importance-sampling modes are
+// priced but not differentiated (NAN sensitivities).
+MCSensitivities mcCallAAD(double S, double K, double T, double r, double sigma,
+                          std::size_t n_paths, std::uint64_t seed, MCMode mode = MCMode::Plain);
+MCSensitivities mcPutAAD(double S, double K, double T, double r, double sigma,
+                         std::size_t n_paths, std::uint64_t seed, MCMode mode = MCMode::Plain);
+
+#endif
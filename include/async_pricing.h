@@ -0,0 +1,96 @@
+// async_pricing.h
+
+#ifndef ASYNC_PRICING_H
+#define ASYNC_PRICING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "scheduler.h"
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+// Shared cancellation flag. Copies refer to the same flag, so a caller can
+// keep one copy and hand another to a job.
+class CancelToken {
+public:
+    CancelToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { flag_->store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+struct AsyncOptions {
+    Deadline deadline = Deadline::max();   // absolute, checked before each unit of work
+    CancelToken token;
+};
+
+enum class AsyncStatus {
+    Complete,
+    Cancelled,
+    DeadlineExpired
+};
+
+// MC result over the path blocks that ran before the job was stopped. With
+// fewer than 2 paths done the price fields are NAN.
+struct MCAsyncResult {
+    MCResult result;
+    std::size_t paths_done = 0;
+    std::size_t paths_requested = 0;
+    AsyncStatus status = AsyncStatus::Complete;
+};
+
+// Batch values of chunks that were skipped after a stop are left at their
+// default (NAN prices, unconverged IVResult).
+template <typename T>
+struct BatchAsyncResult {
+    std::vector<T> values;
+    std::size_t completed = 0;
+    AsyncStatus status = AsyncStatus::Complete;
+};
+
+// Handle to a running job: wait for it, poll it or cancel it
+template <typename T>
+class PricingFuture {
+public:
+    PricingFuture() = default;
+    PricingFuture(JobHandle<T> handle, CancelToken token)
+        : handle_(std::move(handle)), token_(std::move(token)) {}
+
+    bool valid() const { return handle_.valid(); }
+    bool ready() const { return handle_.ready(); }
+    void wait() const { handle_.wait(); }
+    bool waitUntil(Deadline t) const { return handle_.waitUntil(t); }
+    const T& get() const { return handle_.get(); }
+
+    // Cooperative: work already started finishes, queued work is skipped
+    void cancel() { token_.cancel(); }
+
+private:
+    JobHandle<T> handle_;
+    CancelToken token_;
+};
+
+// MC jobs check the token and deadline before every path block. Completed
+// blocks are merged in block order, so an uninterrupted job returns exactly
+// mcCallPrice / mcPutPrice, and a stopped one a valid estimate over the paths
+// it did simulate.
+PricingFuture<MCAsyncResult> mcPriceAsync(TaskScheduler& sched, const MCJob& job,
+                                          const AsyncOptions& opts = {});
+PricingFuture<MCAsyncResult> mcPriceAsync(const MCJob& job, const AsyncOptions& opts = {});
+
+// Batches check before every chunk of `batch` quotes
+PricingFuture<BatchAsyncResult<double>> bsBatchAsync(TaskScheduler& sched, std::vector<BSQuote> quotes,
+                                                     const AsyncOptions& opts = {},
+                                                     std::size_t batch = 512);
+PricingFuture<BatchAsyncResult<IVResult>> ivBatchAsync(TaskScheduler& sched, std::vector<IVQuote> quotes,
+                                                       const AsyncOptions& opts = {},
+                                                       std::size_t batch = 64);
+
+#endif
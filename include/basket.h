@@ -0,0 +1,72 @@
+// basket.h
+
+#ifndef BASKET_H
+#define BASKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "monte_carlo.h"
+
+class ScratchArena;
+
+// Factor A of a correlation matrix with A A^T = C, computed once per matrix.
+// Cholesky when C is positive definite; otherwise C is eigendecomposed
+// (cyclic Jacobi), negative eigenvalues are clipped to zero and the rows of
+// V sqrt(Lambda) rescaled to unit length, so A A^T is the nearest-by-clipping
+// valid correlation matrix (exactly C when C is only semidefinite, e.g. with
+// perfectly correlated assets).
+struct CorrelationFactor {
+    std::size_t dim = 0;
+    std::vector<double> matrix;     // dim x dim, row-major
+    bool lower = true;              // Cholesky factor (upper triangle zero)
+    bool repaired = false;          // C had a negative eigenvalue
+    double min_eigenvalue = 0.0;    // of C, set when Cholesky failed
+};
+
+// False (and `out` untouched) unless `corr` is a dim x dim row-major
+// symmetric matrix with unit diagonal and entries in [-1, 1]
+bool factorCorrelation(const std::vector<double>& corr, std::size_t dim, CorrelationFactor& out);
+
+// Payoffs on the weighted terminal prices w_i S_i(T):
+//   Basket   max(+-(sum_i w_i S_i - K), 0); a spread is a basket with weights (1, -1)
+//   BestOf   max(+-(max_i w_i S_i - K), 0)
+//   WorstOf  max(+-(min_i w_i S_i - K), 0)
+// (weights 1 / S_i(0) make best-of / worst-of act on performances)
+enum class BasketPayoff { Basket, BestOf, WorstOf };
+
+struct BasketOption {
+    BasketPayoff payoff = BasketPayoff::Basket;
+    bool is_call = true;
+    double K = 0.0, T = 0.0, r = 0.0;
+    std::vector<double> spots, vols, weights;
+    std::vector<double> dividends;  // continuous yields; empty = none
+};
+
+// Multi-asset GBM estimator (terminal values, one exact step). Path p draws
+// the normals [p * n, (p + 1) * n) of the stream for n assets; blocks of
+// kMCBlockPaths paths are processed in chunks whose structure-of-arrays
+// buffers stay near 64 KB each whatever the asset count, with the
+// correlation (a small dense multiply W = A Z) and the terminal prices in
+// dispatched kernels. Modes:
+//   Antithetic            negates every Z
+//   ControlVariateBS      positive-weight baskets: the geometric basket
+//                         option, lognormal with a Black–Scholes price;
+//                         best-of / worst-of / spreads: the discounted
+//                         weighted basket sum_i w_i S_i (mean
+//                         sum_i w_i S_i(0) e^{-q_i T})
+//   AntitheticControlBS   both
+// Importance-sampling modes and invalid inputs return NAN.
+MCResult mcBasketPrice(const BasketOption& option, const std::vector<double>& correlation,
+                       std::size_t n_paths, std::uint64_t seed, MCMode mode = MCMode::Plain);
+
+MCResult mcBasketPrice(const BasketOption& option, const CorrelationFactor& factor,
+                       std::size_t n_paths, std::uint64_t seed, MCMode mode, ScratchArena& arena);
+
+// Block b of the run above (same block contract as mcCallBlock)
+MCPartial mcBasketBlock(const BasketOption& option, const CorrelationFactor& factor,
+                        std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                        std::size_t block, ScratchArena& arena);
+
+#endif
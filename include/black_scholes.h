@@ -3,7 +3,34 @@
 #ifndef BLACK_SCHOLES_H
 #define BLACK_SCHOLES_H
 
+#include <cstddef>
+
+class MarketCurves;
+
 double callPrice(double S, double K, double T, double r, double sigma);
 double putPrice(double S, double K, double T, double r, double sigma);
 
+// Term-structure prices: discount, forward (yield curve and escrowed cash
+// dividends) and total variance to T from the curves, priced through the
+// flat formula at the equivalent inputs (MarketCurves::flatten)
+double callPrice(double S, double K, double T, const MarketCurves& curves);
+double putPrice(double S, double K, double T, const MarketCurves& curves);
+
+// Batch prices over struct-of-arrays inputs, out[i] = callPrice(S[i], ...).
+// Runs the CPU-dispatched kernel (within 1e-13 * max(S, K) of the scalar
+// functions); quotes the scalar functions treat as degenerate are delegated
+// to them.
+void callPriceBatch(const double* S, const double* K, const double* T, const double* r,
+                    const double* sigma, double* out, std::size_t n);
+void putPriceBatch(const double* S, const double* K, const double* T, const double* r,
+                   const double* sigma, double* out, std::size_t n);
+
+// Kernels templated on the floating type (float and double instantiated).
+// callPrice/putPrice are the double versions; callPriceT<float> is the opt-in
+// single-precision screening mode. Measured over S/K in [0.5, 2], T in
+// [0.05, 5], sigma in [0.05, 1], |r| <= 0.1 (tests/test_float_precision.cpp):
+//   |float - double| <= 5e-7 * max(S, K)   (observed max 1.5e-7)
+template <typename Real> Real callPriceT(Real S, Real K, Real T, Real r, Real sigma);
+template <typename Real> Real putPriceT(Real S, Real K, Real T, Real r, Real sigma);
+
 #endif
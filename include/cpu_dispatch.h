@@ -0,0 +1,109 @@
+// cpu_dispatch.h
+
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Instruction-set levels the hot kernels are compiled for. One binary carries
+// all of them; the best level the CPU supports is picked on first use
+// (cpuid), or forced with PRICER_ISA=generic|avx2|avx512. A forced level the
+// CPU cannot run falls back to the best supported one.
+enum class IsaLevel {
+    Generic,    // x86-64 baseline (SSE2), or the only level on other targets
+    AVX2,       // AVX2 + FMA
+    AVX512      // AVX-512 F/DQ
+};
+
+const char* isaName(IsaLevel level);
+
+IsaLevel detectedIsa();     // best level this CPU supports
+IsaLevel activeIsa();       // level the kernels currently run at
+
+// Switches the active level (tests, benchmarks); false if unsupported here
+bool setActiveIsa(IsaLevel level);
+
+// Per-run constants of one Heston step of length dt (heston_mc.cpp).
+// QE: the conditional variance mean is m = theta + (V - theta) e_kdt and
+// variance s^2 = V s2_v + s2_c; the log-spot moves by
+// drift + K0 + K1 V + K2 V' + sqrt(K3 V + K4 V') Zx. Euler: full truncation
+// with V+ = max(V, 0).
+struct HestonStepCoeffs {
+    bool qe = true;
+    bool martingale = true;          // QE: per-path K0* instead of K0
+    double theta = 0.0, psi_c = 1.5;
+    double e_kdt = 0.0, s2_v = 0.0, s2_c = 0.0;
+    double drift = 0.0;              // r dt
+    double K0 = 0.0, K1 = 0.0, K2 = 0.0, K3 = 0.0, K4 = 0.0;
+    double kappa_dt = 0.0, xi_sqrt_dt = 0.0, rho = 0.0, rho_bar = 0.0, dt = 0.0, sqrt_dt = 0.0;
+};
+
+// Kernel table of the active level. All levels compute bit-identical results:
+// the kernels share the branch-free math of simd_math.h and differ only in
+// vector width.
+struct KernelTable {
+    // out[i] = N(x[i])
+    void (*normal_cdf)(const double* x, double* out, std::size_t n);
+
+    // The n normals rand_standard_normal would draw from `state` (not advanced)
+    void (*normal_fill)(std::uint64_t state, double* out, std::size_t n);
+
+    // Black–Scholes prices of valid quotes (S, K, T, sigma > 0); other lanes
+    // hold garbage and are fixed up by callPriceBatch / putPriceBatch
+    void (*bs_price)(bool is_call, const double* S, const double* K, const double* T,
+                     const double* r, const double* sigma, double* out, std::size_t n);
+
+    // MC block: discounted payoff X and discounted terminal price Y per draw,
+    // antithetic pairs averaged. A nonzero shift samples Z + shift and
+    // weights both outputs by the likelihood ratio (importance sampling).
+    void (*mc_paths)(const double* Z, std::size_t n, double S, double K, double drift,
+                     double vol_sqrtT, double df, bool antithetic, bool is_call,
+                     double shift, double* X, double* Y);
+
+    // Multi-asset blocks, structure of arrays (row i of an n-path matrix at
+    // + i * n). W = A Z for the dim x dim row-major factor A; only the lower
+    // triangle is read when `lower`.
+    void (*correlate)(const double* A, std::size_t dim, bool lower, const double* Z,
+                      std::size_t n, double* W);
+
+    // Terminal prices S_i = exp(log_mean[i] + sign * vol_sqrtT[i] * W_i) per
+    // path, reduced to sum_i w_i S_i, max_i and min_i of w_i S_i and the log
+    // geometric basket sum_i a_i log S_i (sign = -1 is the antithetic leg)
+    void (*basket_paths)(const double* W, std::size_t dim, std::size_t n, const double* log_mean,
+                         const double* vol_sqrtT, const double* weights, const double* geo_weights,
+                         double sign, double* sum, double* best, double* worst, double* log_geo);
+
+    // One GBM step per path, S[i] *= exp(drift + vol * Z[i])
+    void (*gbm_step)(double* S, const double* Z, std::size_t n, double drift, double vol);
+
+    // Black–Scholes delta (and price, unless `price` is null) of n spots
+    // sharing K, tau, r and sigma, from one d1 per path (tau, sigma > 0)
+    void (*bs_price_delta)(bool is_call, const double* S, std::size_t n, double K, double tau,
+                           double r, double sigma, double* price, double* delta);
+
+    // Mean and centred second moments of a block (n > 0) by the corrected
+    // two-pass algorithm over a fixed set of partial-sum lanes: out = {mean,
+    // M2} with Y null, else {mean X, mean Y, M2 X, M2 Y, co-moment}
+    void (*block_moments)(const double* X, const double* Y, std::size_t n, double* out);
+
+    // One Heston step of n paths, structure of arrays: V by Andersen's QE
+    // scheme (quadratic branch for psi <= psi_c, else exponential with
+    // 1 - U = N(-Zv)) or full-truncation Euler, and log_S by the matching
+    // scheme, from the draws sign * Zv, sign * Zx (sign = -1 is the
+    // antithetic leg). With `sum` set, adds the new spot e^{log_S} to it.
+    void (*heston_step)(const HestonStepCoeffs& c, double sign, const double* Zv, const double* Zx,
+                        std::size_t n, double* V, double* log_S, double* sum);
+
+    // Single-precision normal_fill and mc_paths (mcCallPriceT<float>): the
+    // same splitmix64 stream with 24-bit uniforms, and the float overloads
+    // of simd_math, so a vector holds twice the lanes
+    void (*normal_fill_f)(std::uint64_t state, float* out, std::size_t n);
+    void (*mc_paths_f)(const float* Z, std::size_t n, float S, float K, float drift,
+                       float vol_sqrtT, float df, bool antithetic, bool is_call,
+                       float shift, float* X, float* Y);
+};
+
+const KernelTable& kernels();
+
+#endif
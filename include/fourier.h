@@ -0,0 +1,54 @@
+// fourier.h
+
+#ifndef FOURIER_H
+#define FOURIER_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+struct HestonParams {
+    double kappa;   // mean reversion speed of variance
+    double theta;   // long-run variance
+    double xi;      // vol of variance
+    double rho;     // spot/variance correlation
+    double v0;      // initial variance
+};
+
+// Characteristic function of x = ln(S_T / S_0) under the risk-neutral measure.
+// Cheap to copy; evaluate with operator().
+struct CharFn {
+    enum class Model { BlackScholes, Heston };
+
+    Model model = Model::BlackScholes;
+    double T = 0.0;
+    double r = 0.0;
+    double sigma = 0.0;       // BlackScholes only
+    HestonParams heston{};    // Heston only
+
+    std::complex<double> operator()(std::complex<double> u) const;
+
+    // First, second and fourth cumulants of x (used for the COS truncation range)
+    void cumulants(double& c1, double& c2, double& c4) const;
+};
+
+CharFn bsCharFn(double T, double r, double sigma);
+CharFn hestonCharFn(double T, double r, const HestonParams& p);
+
+// COS method (Fang & Oosterlee). The characteristic function is evaluated once
+// per cosine term and shared by all strikes: cost O(n_terms * n_strikes).
+std::vector<double> cosCallPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                  std::size_t n_terms = 256, double L = 20.0);
+std::vector<double> cosPutPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                 std::size_t n_terms = 256, double L = 20.0);
+
+// Carr–Madan FFT. Prices a log-strike grid of N points with one FFT
+// (O(N log N)), then interpolates onto the requested strikes. N must be a power of 2.
+std::vector<double> carrMadanCallPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                        std::size_t N = 4096, double eta = 0.25, double alpha = 1.5);
+
+// Single-strike Heston European prices (COS)
+double hestonCallPrice(double S, double K, double T, double r, const HestonParams& p);
+double hestonPutPrice(double S, double K, double T, double r, const HestonParams& p);
+
+#endif
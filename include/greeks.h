@@ -3,11 +3,21 @@
 #ifndef GREEKS_H
 #define GREEKS_H
 
+class MarketCurves;
+
 double callDelta(double S, double K, double T, double r, double sigma);
 double putDelta(double S, double K, double T, double r, double sigma);
 
 double gamma(double S, double K, double T, double r, double sigma);
 double vega(double S, double K, double T, double r, double sigma);
 
+// Term-structure Greeks. Delta and gamma are with respect to the spot S (the
+// escrowed dividends do not move with S); vega is with respect to the
+// effective vol sqrt(w(T) / T), the quantity impliedVol*(curves) solves for.
+double callDelta(double S, double K, double T, const MarketCurves& curves);
+double putDelta(double S, double K, double T, const MarketCurves& curves);
+double gamma(double S, double K, double T, const MarketCurves& curves);
+double vega(double S, double K, double T, const MarketCurves& curves);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+// hedging.h
+
+#ifndef HEDGING_H
+#define HEDGING_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Discrete delta-hedging backtest of a short European option. The option is
+// sold at its Black–Scholes price under hedge_vol and hedged with the BS
+// delta at hedge_vol, rebalanced at t_k = k T / n_steps (k < n_steps). Cash
+// accrues at r; each trade of q shares at S pays cost_rate * |q| * S; the
+// hedge is unwound at T (also at cost) and the payoff paid. Per path:
+//   P&L = cash(T) + delta S_T - cost_rate |delta| S_T - payoff(S_T)
+// in time-T money; with no costs and hedge_vol = sigma its mean tends to 0
+// and its stdev falls like 1 / sqrt(n_steps).
+//
+// Paths run in blocks of kHedgeBlockPaths. A block keeps only the current
+// spot, position, cash and cost of its paths (and the (n_steps + 1) x block
+// spot rows of a user path source), so memory is bounded by the block size
+// and thread count, not by n_paths. At every step the spot update and the
+// fused price/delta of all paths of the block run in the dispatched kernels.
+constexpr std::size_t kHedgeBlockPaths = 1024;
+
+// Fills the spot paths first_path .. first_path + n - 1 as rows: S[k * n + i]
+// is path first_path + i at t_k, k = 0 .. n_steps (row 0 is the initial spot).
+// Called concurrently for different blocks.
+using HedgePathSource = std::function<void(std::size_t first_path, std::size_t n,
+                                           std::size_t n_steps, double* S)>;
+
+struct HedgeConfig {
+    bool is_call = true;
+    double S0 = 100.0, K = 100.0, T = 1.0, r = 0.0;
+    double sigma = 0.2;          // GBM path vol
+    double mu = NAN;             // GBM path drift (real-world); NAN = r
+    double hedge_vol = NAN;      // vol for premium and deltas; NAN = sigma
+    double cost_rate = 0.0;      // proportional cost per unit of notional traded
+    std::size_t n_steps = 52;
+    std::size_t n_paths = 10000;
+    std::uint64_t seed = 1;
+    std::size_t n_threads = 0;   // 0 = hardware concurrency
+    bool track_drawdown = false; // mark to market every step (adds the option price to the step kernel)
+    HedgePathSource paths;       // replaces the GBM paths when set (S0 is then row 0)
+};
+
+// P&L histogram: bins of equal width over a range set from the first block
+// (its span widened by half on both sides); values outside it are counted in
+// the edge bins. Counts are exact, so quantiles are accurate to a bin width.
+struct HedgeDistribution {
+    double lo = 0.0, width = 0.0;
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total = 0;
+
+    double quantile(double p) const;            // linear within the bin
+    double expectedShortfall(double p) const;   // mean of the worst p fraction (bin midpoints)
+};
+
+struct HedgeResult {
+    std::size_t paths = 0;           // 0 (and NAN fields) for invalid configs
+    double premium = NAN;            // received at t = 0
+    double mean_pnl = NAN, stdev_pnl = NAN, stderr_pnl = NAN;
+    double min_pnl = NAN, max_pnl = NAN;
+    double mean_cost = NAN;          // transaction costs, time-T money
+    double mean_turnover = NAN;      // shares traded per path, unwind included
+    double mean_max_drawdown = NAN;  // of the hedged book's mark-to-market (track_drawdown)
+    HedgeDistribution distribution;
+};
+
+// Deterministic for a seed: the same result for any n_threads. The GBM block
+// of paths [first, first + n) draws the normals [first * n_steps,
+// (first + n) * n_steps) of the seed's stream, step k taking the n at k * n.
+HedgeResult runHedgeBacktest(const HedgeConfig& config);
+
+#endif
@@ -0,0 +1,63 @@
+// heston_mc.h
+
+#ifndef HESTON_MC_H
+#define HESTON_MC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fourier.h"
+#include "monte_carlo.h"
+
+class ScratchArena;
+
+// Variance discretizations of the Heston path engine:
+//   QE     Andersen's quadratic-exponential step: V' is drawn from a moment-
+//          matched squared Gaussian (psi = s^2 / m^2 <= psi_c) or a point
+//          mass at 0 plus an exponential, the log-spot by the central
+//          discretization of int V dt, optionally with the martingale
+//          correction (QE-M) that makes E[S_{t+dt} | S_t] = S_t e^{r dt}
+//          exact. The bias stays small at steps of a year or more.
+//   Euler  full-truncation Euler on V and log-Euler on S, the naive
+//          baseline; needs many more steps for the same bias, worst when
+//          the Feller condition fails.
+enum class HestonScheme { QE, Euler };
+
+struct HestonMCOptions {
+    HestonScheme scheme = HestonScheme::QE;
+    std::size_t n_steps = 8;            // uniform steps over [0, T]
+    bool martingale_correction = true;  // QE only
+    double psi_c = 1.5;                 // QE branch switch, in [1, 2]
+};
+
+// European or arithmetic-average (trapezoid over the n_steps grid of
+// [0, T]) call / put under Heston dynamics, no dividends
+struct HestonOption {
+    bool is_call = true;
+    bool asian = false;
+    double S = 0.0, K = 0.0, T = 0.0, r = 0.0;
+    HestonParams params{};
+};
+
+// Path p draws the normals [2 p n_steps, 2 (p + 1) n_steps) of the seed's
+// stream, the pair (Zv, Zx) of step k at 2 k; blocks of kMCBlockPaths paths
+// are processed in chunks whose variance and log-spot are held as structure
+// of arrays and stepped in the dispatched heston_step kernel. Modes:
+//   Antithetic            negates both normals of every step
+//   ControlVariateBS      European: the discounted S_T (mean S); Asian: the
+//                         discounted European payoff at the same strike,
+//                         with its semi-analytic Heston price (COS) as mean
+//   AntitheticControlBS   both
+// Other modes and invalid inputs return NAN.
+MCResult mcHestonPrice(const HestonOption& option, std::size_t n_paths, std::uint64_t seed,
+                       MCMode mode = MCMode::Plain, const HestonMCOptions& options = {});
+
+MCResult mcHestonPrice(const HestonOption& option, std::size_t n_paths, std::uint64_t seed,
+                       MCMode mode, const HestonMCOptions& options, ScratchArena& arena);
+
+// Block b of the run above (same block contract as mcCallBlock)
+MCPartial mcHestonBlock(const HestonOption& option, const HestonMCOptions& options,
+                        std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                        std::size_t block, ScratchArena& arena);
+
+#endif
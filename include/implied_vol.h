@@ -1,6 +1,8 @@
 #ifndef IMPLIED_VOL_H
 #define IMPLIED_VOL_H
 
+class MarketCurves;
+
 struct IVResult {
     double sigma;
     int iterations;
@@ -13,4 +15,12 @@ IVResult impliedVolCall(double market_price, double S, double K, double T, doubl
 IVResult impliedVolPut(double market_price, double S, double K, double T, double r,
                        double init_sigma = 0.2, double tol = 1e-8, int max_iter = 100);
 
+// Effective (term) vol sqrt(w(T) / T) that reprices the quote with the rates
+// and dividends of `curves`; the vol term structure of `curves` is ignored.
+IVResult impliedVolCall(double market_price, double S, double K, double T, const MarketCurves& curves,
+                        double init_sigma = 0.2, double tol = 1e-8, int max_iter = 100);
+
+IVResult impliedVolPut(double market_price, double S, double K, double T, const MarketCurves& curves,
+                       double init_sigma = 0.2, double tol = 1e-8, int max_iter = 100);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+// mc_cache.h
+
+#ifndef MC_CACHE_H
+#define MC_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "monte_carlo.h"
+#include "pricing_session.h"
+
+// Exact identity of a seeded European run: the engine version tag, call/put,
+// mode, the bit patterns of S, K, T, r and sigma, n_paths and seed. Inputs
+// that compare equal as doubles but differ in bits (0.0 and -0.0) are
+// different keys, so a hit is always the bits the engine would return.
+struct MCCacheKey {
+    std::uint64_t w[9];
+
+    bool operator==(const MCCacheKey& o) const;
+};
+
+struct MCCacheKeyHash {
+    std::size_t operator()(const MCCacheKey& k) const;
+};
+
+MCCacheKey mcCacheKey(const MCJob& job, std::uint32_t version = kMCEngineVersion);
+
+struct MCCacheStats {
+    std::uint64_t lookups = 0;
+    std::uint64_t hits = 0;           // memory + store
+    std::uint64_t store_hits = 0;     // found in the mapped store, promoted to memory
+    std::uint64_t misses = 0;
+    std::uint64_t inserts = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t lookup_ns = 0;      // total time spent in lookups
+    std::uint64_t compute_ns = 0;     // total time of the engine runs behind misses in price()
+    std::size_t store_records = 0;    // records in the persistent store
+
+    double hitRate() const { return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0; }
+};
+
+// Memoizes seeded mcCallPrice / mcPutPrice results. The in-memory level is an
+// LRU split into independently locked shards (by key hash), so concurrent
+// callers rarely contend. Optionally backed by a persistent store: a file of
+// fixed-size records that is memory-mapped at openStore() and indexed, with
+// new results appended to it (they are seen by the next process that opens
+// the store). Processes may share a store: opens and appends hold an
+// exclusive flock on it and records are appended with O_APPEND. A store
+// written under another version tag is replaced on open by an empty one
+// (written aside and renamed, so processes that have the old one mapped keep
+// reading it); a torn trailing record (interrupted write) is dropped.
+// Non-finite results (invalid inputs) are never cached.
+class MCResultCache {
+public:
+    explicit MCResultCache(std::size_t capacity = 1 << 16, std::uint32_t version = kMCEngineVersion);
+    ~MCResultCache();
+
+    MCResultCache(const MCResultCache&) = delete;
+    MCResultCache& operator=(const MCResultCache&) = delete;
+
+    // Maps (creating if needed) the store at `path`; false if the file cannot
+    // be opened or is not a store. Replaces a previously opened store.
+    bool openStore(const std::string& path);
+    void closeStore();
+
+    bool lookup(const MCJob& job, MCResult& out);
+    void insert(const MCJob& job, const MCResult& result);
+
+    // Cached result, or runs the engine (on `arena`, or the per-thread
+    // default) and caches it. Two threads missing on the same key both run
+    // it; the runs are deterministic, so either result is the same.
+    MCResult price(const MCJob& job);
+    MCResult price(const MCJob& job, ScratchArena& arena);
+
+    void clear();   // memory level only; the store is kept
+    MCCacheStats stats() const;
+    std::uint32_t version() const { return version_; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    struct Entry {
+        MCCacheKey key;
+        MCResult result;
+    };
+    struct alignas(kCacheLine) Shard {
+        std::mutex m;
+        std::list<Entry> lru;   // most recent first
+        std::unordered_map<MCCacheKey, std::list<Entry>::iterator, MCCacheKeyHash> index;
+    };
+    struct Store;
+
+    Shard& shard_of(std::size_t hash);
+    bool lookup_key(const MCCacheKey& key, std::size_t hash, MCResult& out);
+    void insert_memory(const MCCacheKey& key, std::size_t hash, const MCResult& result);
+    template <typename Run>
+    MCResult price_with(const MCJob& job, Run&& run);
+
+    std::uint32_t version_;
+    std::size_t capacity_;
+    std::size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    mutable std::mutex store_m_;
+    std::unique_ptr<Store> store_;
+
+    std::atomic<std::uint64_t> lookups_{0}, hits_{0}, store_hits_{0}, misses_{0};
+    std::atomic<std::uint64_t> inserts_{0}, evictions_{0}, lookup_ns_{0}, compute_ns_{0};
+};
+
+#endif
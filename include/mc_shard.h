@@ -0,0 +1,49 @@
+// mc_shard.h
+
+#ifndef MC_SHARD_H
+#define MC_SHARD_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "monte_carlo.h"
+
+// Accumulator state of part of a seeded MC run: the run it belongs to and
+// the partials of a contiguous range of path blocks. Partials are kept per
+// block, not folded, so states merge associatively (range concatenation)
+// and any split of a run (shards on other processes or machines, or a
+// checkpoint plus the remainder) finalizes to exactly the single-process
+// mcCallPrice / mcPutPrice result.
+struct MCShardState {
+    MCJob job;
+    std::size_t first_block = 0;
+    std::vector<MCPartial> blocks;   // blocks [first_block, first_block + blocks.size())
+
+    std::size_t endBlock() const { return first_block + blocks.size(); }
+    bool complete() const { return first_block == 0 && blocks.size() == mcBlockCount(job.n_paths); }
+};
+
+// Block range [first, last) of shard `shard` of `n_shards`, balanced and contiguous
+void mcShardRange(std::size_t n_paths, std::size_t shard, std::size_t n_shards,
+                  std::size_t& first, std::size_t& last);
+
+// Simulates blocks [first_block, last_block) of the job (clamped to the run)
+MCShardState mcRunBlocks(const MCJob& job, std::size_t first_block, std::size_t last_block,
+                         ScratchArena& arena);
+
+// Appends or prepends `from`; false (and `into` unchanged) unless both
+// states belong to the same run and their block ranges are adjacent
+bool mcMergeShards(MCShardState& into, const MCShardState& from);
+
+// Folds the covered blocks in block order; when complete() this is the
+// run's mcCallPrice / mcPutPrice result (for T > 0, where paths are simulated)
+MCResult mcFinalize(const MCShardState& state);
+
+// Line-based text format, doubles as hex floats so a round trip is exact.
+// The header carries kMCEngineVersion: shards from another engine build, and
+// block counts the run or the text cannot hold, are refused.
+std::string mcSerializeShard(const MCShardState& state);
+bool mcParseShard(const std::string& text, MCShardState& out);
+
+#endif
@@ -5,14 +5,43 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
+
+class PricingSession;
+class ScratchArena;
+class MarketCurves;
 
 enum class MCMode {
     Plain,
     Antithetic,
     ControlVariateBS,     // uses BS as control variate (European only)
-    AntitheticControlBS  
+    AntitheticControlBS,
+    ImportanceSampling,   // Z drawn around an automatic shift, likelihood-ratio weighted
+    AntitheticImportance, // importance sampling with antithetic pairs about the shifted mean
+    MomentMatching,       // each block's normals rescaled to sample mean 0, variance 1
+    AntitheticMomentMatching,
+    MartingaleCorrection, // each block's S_T rescaled so the discounted mean is exactly spot
+    AntitheticMartingale
 };
 
+// Importance sampling: Z ~ N(mu, 1) instead of N(0, 1), each payoff weighted
+// by exp(-mu Z' - mu^2 / 2) with Z' = Z - mu. mu is the maximiser of
+// log(payoff(z)) - z^2 / 2, the mode of the zero-variance sampling density,
+// so deep out-of-the-money paths land near and past the strike; it is found
+// per run from S, K, T, r and sigma.
+//
+// Moment matching and the empirical martingale correction (Duan–Simonato)
+// post-process each path block of kMCBlockPaths: the block's normals are
+// standardised with their own mean and (population) standard deviation —
+// with antithetics the pairs already have mean 0 and only the scale is
+// matched — or its terminal prices are scaled by E[df S_T] / (block mean of
+// df S_T), which is the same block simulated from a rescaled spot. Paths of
+// a block are then no longer independent, so the stderr comes from batch
+// means, one batch per block: stderr^2 = sum_b n_b (m_b - m)^2 / (N (B - 1)),
+// and the 95% CI uses the Student-t quantile with B - 1 degrees of freedom
+// (4.30 stderr for 3 blocks, 2.09 for 20). Runs of a single block
+// (n_paths <= kMCBlockPaths) report a NAN stderr.
+
 struct MCResult {
     double price;     
     double stderr;    
@@ -28,5 +57,162 @@ MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
                     std::size_t n_paths, std::uint64_t seed,
                     MCMode mode = MCMode::Plain);
 
+// Term-structure estimators: cash dividends are escrowed out of the spot,
+// and ControlVariateBS uses the discounted S_T (mean S e^{-int q} net of
+// dividend PV) as the control. The payoff only sees S_T, whose log-return
+// over any time grid is normal with drift int (r - q - sigma^2 / 2) and
+// variance int sigma^2 to expiry, so no grid is built: path p draws the
+// single normal p of the stream (in blocks of kMCBlockPaths).
+MCResult mcCallPrice(double S, double K, double T, const MarketCurves& curves,
+                     std::size_t n_paths, std::uint64_t seed,
+                     MCMode mode = MCMode::Plain);
+
+MCResult mcPutPrice(double S, double K, double T, const MarketCurves& curves,
+                    std::size_t n_paths, std::uint64_t seed,
+                    MCMode mode = MCMode::Plain);
+
+// Paths of a seeded run are simulated in blocks of kMCBlockPaths: block b
+// covers paths [b * kMCBlockPaths, min((b + 1) * kMCBlockPaths, n_paths)) and
+// can be computed on any thread (the RNG stream is skipped ahead in O(1)).
+// Merging block partials in block order and finalizing gives exactly the
+// mcCallPrice / mcPutPrice result; this is how the scheduler splits MC jobs.
+constexpr std::size_t kMCBlockPaths = 4096;
+
+// Tag of the numerical behaviour of the seeded European estimators. Bump it
+// whenever a change alters the result bits of any (inputs, seed, mode) run:
+// cached results (mc_cache.h) are keyed by it and dropped on a mismatch.
+constexpr std::uint32_t kMCEngineVersion = 4;
+
+// Means and centred co-moments, never raw power sums: a block's are
+// computed in two passes over its stored samples (independent partial sums,
+// no division per sample, corrected for the rounding of the mean) and
+// partials merge by Chan et al.'s pairwise update, so the variance and
+// covariance stay accurate for tiny-variance payoffs at any path count.
+struct MCPartial {
+    bool control = false;       // control-variate modes also carry Y and the X-Y co-moment
+    double control_mean = 0.0;  // E[Y] of the control, the discounted S_T mean (= S)
+    std::size_t n = 0;
+    double mean = 0.0, M2 = 0.0;             // X: mean, sum of (X - mean)^2
+    double meanY = 0.0, M2Y = 0.0, C = 0.0;  // control modes: Y likewise, sum of (X - mean)(Y - meanY)
+    std::size_t batches = 0;    // batch-means modes: blocks merged; M2 is then between block means
+};
+
+std::size_t mcBlockCount(std::size_t n_paths);
+
+// A seeded European run: the unit the scheduler, async pricing and sharded
+// runs (mc_shard.h) split into blocks
+struct MCJob {
+    bool is_call = true;
+    double S, K, T, r, sigma;
+    std::size_t n_paths;
+    std::uint64_t seed;
+    MCMode mode = MCMode::Plain;
+};
+
+MCPartial mcCallBlock(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                      std::size_t block, ScratchArena& arena);
+
+MCPartial mcPutBlock(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     std::size_t block, ScratchArena& arena);
+
+void mcMerge(MCPartial& into, const MCPartial& from);
+MCResult mcFinalize(const MCPartial& p);
+
+// Partial of one block of discounted payoffs X (and, when `control`, the
+// controls Y with known mean control_mean) for engines outside this file
+MCPartial mcAccumulate(const double* X, const double* Y, std::size_t n,
+                       bool control, double control_mean);
+
+// Same estimators, with block scratch buffers taken from the session's arena
+// (or a given arena, e.g. a worker arena) instead of per-thread defaults.
+MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     PricingSession& session);
+
+MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
+                    std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                    PricingSession& session);
+
+MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     ScratchArena& arena);
+
+MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
+                    std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                    ScratchArena& arena);
+
+// Path simulation templated on the floating type (float and double
+// instantiated). Normals, terminal prices and payoffs run in Real; the
+// accumulators always stay in double so float results remain unbiased.
+// mcCallPriceT<float> is the opt-in single-precision mode: the dispatched
+// float kernels (normal_fill_f, mc_paths_f) hold twice the lanes of the
+// double ones, about 2x faster at AVX-512. Its normals come from 24-bit
+// uniforms (tails cut at |Z| = 5.77) and ignore an installed normal pool;
+// at equal seed |float - double| <= 0.05 * stderr across the grid in
+// tests/test_float_precision.cpp (observed max ~0.01 * stderr).
+template <typename Real>
+MCResult mcCallPriceT(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode = MCMode::Plain);
+
+template <typename Real>
+MCResult mcPutPriceT(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode = MCMode::Plain);
+
+template <typename Real>
+MCResult mcCallPriceT(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                      ScratchArena& arena);
+
+template <typename Real>
+MCResult mcPutPriceT(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     ScratchArena& arena);
+
+// Multilevel Monte Carlo for payoffs that need time stepping. Level l
+// simulates coarse_steps * 2^l GBM steps with the chosen scheme, coupled
+// with the 2^(l-1)-refined coarse path driven by the same Brownian
+// increments (summed in pairs), and estimates E[P_l - P_{l-1}]. Levels and
+// samples per level are chosen adaptively (Giles, 2008): samples minimise
+// cost for variance eps^2 / 2 from online level variances, and levels are
+// added until the bias estimate from the finest corrections drops below
+// eps / sqrt(2). With Milstein the level variances decay faster than the
+// cost grows, so total cost is O(eps^-2).
+enum class MLMCScheme { Euler, Milstein };
+
+enum class MLMCPayoff {
+    EuropeanCall, EuropeanPut,
+    AsianCall, AsianPut       // arithmetic average of S over [0, T], trapezoid on each level's grid
+};
+
+struct MLMCOptions {
+    MLMCScheme scheme = MLMCScheme::Milstein;
+    double target_rmse = 0.01;
+    std::size_t coarse_steps = 1;        // steps on level 0
+    std::size_t initial_paths = 10000;   // pilot samples for each new level
+    std::size_t min_levels = 3;          // at least 3: levels 0-2 before the first bias test
+    std::size_t max_levels = 12;
+};
+
+struct MLMCLevel {
+    std::size_t steps = 0;       // fine steps per sample
+    std::size_t samples = 0;
+    double mean = 0.0;           // of P_l - P_{l-1} (P_0 on level 0), discounted
+    double variance = 0.0;
+    double cost = 0.0;           // samples * (fine + coarse steps)
+};
+
+struct MLMCResult {
+    MCResult result;                  // stderr from the sampling variance only
+    std::vector<MLMCLevel> levels;
+    double total_cost = 0.0;          // path steps over all levels
+    double bias_estimate = 0.0;
+    bool converged = false;           // false if max_levels stopped refinement
+};
+
+MLMCResult mlmcPrice(MLMCPayoff payoff, double S, double K, double T, double r, double sigma,
+                     std::uint64_t seed, const MLMCOptions& options = {});
+
 #endif
 
@@ -0,0 +1,61 @@
+// normal_pool.h
+
+#ifndef NORMAL_POOL_H
+#define NORMAL_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The first `count` normals of one seed's stream (exactly what
+// rand_standard_normal_fill returns), in a file that is memory-mapped
+// read-only. Processes opening the same file share its pages through the
+// page cache; runs with a fixed seed read their draws from it instead of
+// generating them.
+//
+// File: a 64-byte header (magic, format, engine version tag, seed, count)
+// followed by the doubles. A file for another seed, count or engine version,
+// or a truncated one, is regenerated: the normals are filled on n_threads
+// threads into a temporary file that is then renamed into place, so a
+// concurrent opener maps either a complete pool or generates its own.
+class NormalPool {
+public:
+    NormalPool() = default;
+    ~NormalPool();
+
+    NormalPool(const NormalPool&) = delete;
+    NormalPool& operator=(const NormalPool&) = delete;
+
+    // Maps the pool at `path`, generating it first if needed
+    // (n_threads = 0: hardware concurrency). False if the file cannot be
+    // written or mapped; the pool is then closed.
+    bool open(const std::string& path, std::uint64_t seed, std::size_t count, std::size_t n_threads = 0);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    bool generated() const { return generated_; }   // the last open() wrote the file
+    std::uint64_t seed() const { return seed_; }
+    std::size_t count() const { return count_; }
+    const double* data() const { return data_; }
+
+    // Normals [first, first + n) of `seed`'s stream, or null unless held here
+    const double* normals(std::uint64_t seed, std::uint64_t first, std::size_t n) const;
+
+private:
+    void* map_ = nullptr;
+    std::size_t map_size_ = 0;
+    const double* data_ = nullptr;
+    std::uint64_t seed_ = 0;
+    std::size_t count_ = 0;
+    bool generated_ = false;
+};
+
+// Pool read by the European MC engine (mcCallPrice / mcPutPrice, flat and
+// term-structure, double precision) for every block whose draws it holds;
+// other blocks, other seeds and single precision generate as before, so
+// results are bit-identical with or without it. Null (the default) turns
+// it off. The pool must stay open while installed.
+void mcSetNormalPool(const NormalPool* pool);
+const NormalPool* mcNormalPool();
+
+#endif
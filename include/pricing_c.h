@@ -0,0 +1,110 @@
+/* pricing_c.h — C ABI of libpricing */
+
+#ifndef PRICING_C_H
+#define PRICING_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ABI version. Within a major version functions are only added, never
+ * changed or removed, and struct layouts and enum values are frozen; a
+ * caller built against major M must check pricing_abi_version() >> 16 == M
+ * before the first call. */
+#define PRICING_ABI_VERSION_MAJOR 1
+#define PRICING_ABI_VERSION_MINOR 1
+
+#if defined(__GNUC__)
+#define PRICING_API __attribute__((visibility("default")))
+#else
+#define PRICING_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    PRICING_OK = 0,
+    PRICING_ERR_ARGUMENT = 1,   /* null pointer or unknown mode; bad numbers give NAN */
+    PRICING_ERR_INTERNAL = 2    /* allocation failure or other internal error */
+} pricing_status;
+
+typedef enum {
+    PRICING_MC_PLAIN = 0,
+    PRICING_MC_ANTITHETIC = 1,
+    PRICING_MC_CONTROL_BS = 2,
+    PRICING_MC_ANTITHETIC_CONTROL_BS = 3,
+    PRICING_MC_IMPORTANCE = 4,
+    PRICING_MC_ANTITHETIC_IMPORTANCE = 5,
+    PRICING_MC_MOMENT_MATCHING = 6,              /* since 1.1; stderr from batch means */
+    PRICING_MC_ANTITHETIC_MOMENT_MATCHING = 7,   /* since 1.1 */
+    PRICING_MC_MARTINGALE_CORRECTION = 8,        /* since 1.1 */
+    PRICING_MC_ANTITHETIC_MARTINGALE = 9         /* since 1.1 */
+} pricing_mc_mode;
+
+typedef struct {
+    double price;
+    double std_error;
+    double ci_low;
+    double ci_high;
+} pricing_mc_result;
+
+typedef struct {
+    double delta;
+    double gamma;
+    double vega;
+} pricing_greeks;
+
+/* (major << 16) | minor of the loaded library */
+PRICING_API uint32_t pricing_abi_version(void);
+
+/* Active SIMD kernel level ("generic", "avx2", "avx512"); static storage */
+PRICING_API const char* pricing_kernel_level(void);
+
+/* Context: a worker pool and scratch memory, reused across calls; every
+ * function taking one also accepts NULL and then runs on the calling thread.
+ * n_threads = 0 uses the hardware concurrency; 1 runs every call on the
+ * calling thread. A context may be used from one thread at a time; give
+ * each calling thread its own, or serialize. NULL on failure. */
+typedef struct pricing_context pricing_context;
+
+PRICING_API pricing_context* pricing_context_create(size_t n_threads, size_t scratch_bytes);
+PRICING_API void pricing_context_destroy(pricing_context* ctx);
+PRICING_API size_t pricing_context_threads(const pricing_context* ctx);
+
+/* Scalar functions: NAN for invalid inputs, as in the C++ API */
+PRICING_API double pricing_bs_price(int is_call, double S, double K, double T, double r, double sigma);
+PRICING_API pricing_status pricing_bs_greeks(int is_call, double S, double K, double T, double r, double sigma,
+                                             pricing_greeks* out);
+
+/* Implied vol by Newton from init_sigma (<= 0 selects 0.2); NAN when the
+ * solver does not converge. iterations may be NULL. */
+PRICING_API double pricing_implied_vol(int is_call, double market_price, double S, double K, double T,
+                                       double r, double init_sigma, int* iterations);
+
+/* Seeded European MC: the result bits of mcCallPrice / mcPutPrice for the
+ * same inputs, whatever the context's thread count. */
+PRICING_API pricing_status pricing_mc_price(pricing_context* ctx, int is_call, double S, double K, double T,
+                                            double r, double sigma, size_t n_paths, uint64_t seed,
+                                            pricing_mc_mode mode, pricing_mc_result* out);
+
+/* Batch entry points work in place on caller-owned struct-of-arrays of
+ * length n: inputs are read and outputs written directly, without copies,
+ * split across the context's workers. is_call[i] != 0 selects a call.
+ * Output arrays may be NULL to skip that output. */
+PRICING_API pricing_status pricing_bs_batch(pricing_context* ctx, size_t n, const uint8_t* is_call,
+                                            const double* S, const double* K, const double* T,
+                                            const double* r, const double* sigma, double* price,
+                                            double* delta, double* gamma, double* vega);
+
+/* sigma[i] is NAN where the solver did not converge */
+PRICING_API pricing_status pricing_iv_batch(pricing_context* ctx, size_t n, const uint8_t* is_call,
+                                            const double* market_price, const double* S, const double* K,
+                                            const double* T, const double* r, double* sigma,
+                                            int32_t* iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
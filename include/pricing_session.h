@@ -0,0 +1,94 @@
+// pricing_session.h
+
+#ifndef PRICING_SESSION_H
+#define PRICING_SESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+constexpr std::size_t kCacheLine = 64;
+
+// Monotonic bump allocator for hot-path scratch buffers. Memory is handed out
+// in cache-line aligned slices and only returned by rewind()/reset(), both O(1).
+// Chunks are kept across resets, so steady-state requests never hit the heap.
+class alignas(kCacheLine) ScratchArena {
+public:
+    struct Marker {
+        std::size_t chunk;
+        std::size_t offset;
+        std::size_t used_before;
+    };
+
+    explicit ScratchArena(std::size_t initial_bytes = std::size_t(1) << 20, bool huge_pages = false);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t align = kCacheLine);
+
+    template <typename T>
+    T* allocArray(std::size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        const std::size_t align = alignof(T) > kCacheLine ? alignof(T) : kCacheLine;
+        return static_cast<T*>(allocate(n * sizeof(T), align));
+    }
+
+    Marker mark() const { return {current_, offset_, used_before_}; }
+    void rewind(const Marker& m);
+    void reset() { rewind({0, 0, 0}); }
+
+    std::size_t bytesInUse() const { return used_before_ + offset_; }
+    std::size_t peakBytes() const { return peak_; }
+    std::size_t reservedBytes() const;
+
+private:
+    struct Chunk {
+        char* base;
+        std::size_t size;
+        bool mapped;
+    };
+
+    void add_chunk(std::size_t min_bytes);
+
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0;
+    std::size_t offset_ = 0;
+    std::size_t used_before_ = 0;
+    std::size_t peak_ = 0;
+    bool huge_pages_;
+};
+
+struct PricingSessionOptions {
+    std::size_t arena_bytes = std::size_t(1) << 20;
+    std::size_t worker_bytes = std::size_t(1) << 16;
+    std::size_t n_workers = 0;     // 0 = hardware concurrency
+    bool huge_pages = false;       // back chunks with transparent huge pages where available
+};
+
+// Scratch memory context for batch, grid and multi-step engines: one shared
+// arena for the calling thread plus one private arena per worker thread.
+// Not thread-safe except that distinct workers may use distinct workerArena()s.
+class PricingSession {
+public:
+    explicit PricingSession(const PricingSessionOptions& opts = {});
+
+    ScratchArena& arena() { return *main_; }
+    ScratchArena& workerArena(std::size_t worker) { return *workers_[worker % workers_.size()]; }
+    std::size_t workers() const { return workers_.size(); }
+
+    // Releases every scratch buffer of the previous request; memory is kept
+    void reset();
+
+    // High-water mark of scratch in use (sum over arenas); use to size deployments
+    std::size_t peakScratchBytes() const;
+    std::size_t reservedBytes() const;
+
+private:
+    std::unique_ptr<ScratchArena> main_;
+    std::vector<std::unique_ptr<ScratchArena>> workers_;
+};
+
+#endif
@@ -0,0 +1,59 @@
+// scenario.h
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstddef>
+#include <vector>
+
+class PricingSession;
+
+struct Position {
+    bool is_call = true;
+    double S, K, T, r, sigma;
+    double quantity = 1.0;
+};
+
+// Shock axes of the risk grid
+struct ShockGrid {
+    std::vector<double> spot;   // relative: S' = S * (1 + ds)
+    std::vector<double> vol;    // absolute: sigma' = sigma + dv (floored at 0)
+    std::vector<double> time;   // elapsed years: T' = T - dt (intrinsic once expired)
+};
+
+// n points spaced evenly on [-max_abs, +max_abs] (includes 0 when n is odd)
+std::vector<double> symmetricShocks(std::size_t n, double max_abs);
+
+struct ScenarioOptions {
+    std::size_t n_threads = 0;        // 0 = hardware concurrency
+    bool keep_positions = false;      // also return the per-position cubes
+};
+
+struct ScenarioCube {
+    std::size_t n_spot = 0, n_vol = 0, n_time = 0;
+    double base_value = 0.0;          // unshocked portfolio value
+
+    // Portfolio P&L versus base, index (t * n_vol + v) * n_spot + s
+    std::vector<double> pnl;
+    // Same layout per position, position-major (only with keep_positions)
+    std::vector<double> position_pnl;
+
+    // P&L along one axis with the other two at their shock closest to zero
+    std::vector<double> spot_ladder;
+    std::vector<double> vol_ladder;
+    std::vector<double> time_ladder;
+
+    double at(std::size_t s, std::size_t v, std::size_t t) const {
+        return pnl[(t * n_vol + v) * n_spot + s];
+    }
+};
+
+// Reprices every position under every spot x vol x time shock. Terms that do
+// not depend on the inner spot axis (log K, discount factor and sqrt(T') per
+// time shock, vol terms) are hoisted; the spot loop runs over contiguous
+// arrays with a branch-free normal CDF. Positions are split across threads,
+// each using its worker arena from `session` (or a private session).
+ScenarioCube runScenarios(const std::vector<Position>& book, const ShockGrid& grid,
+                          const ScenarioOptions& opts = {}, PricingSession* session = nullptr);
+
+#endif
@@ -0,0 +1,153 @@
+// scheduler.h
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "implied_vol.h"
+#include "monte_carlo.h"
+#include "pricing_session.h"
+
+// Work-stealing task scheduler. Each worker owns a deque: it pushes and pops
+// its own tasks LIFO (cache-warm, depth-first splitting) while idle workers
+// steal FIFO from the other end, taking the largest remaining pieces first.
+class TaskScheduler {
+public:
+    using Task = std::function<void(std::size_t worker)>;
+
+    explicit TaskScheduler(std::size_t n_workers = 0);   // 0 = hardware concurrency
+    ~TaskScheduler();                                    // drains queued work, then joins
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // From a worker thread the task goes to that worker's own deque,
+    // otherwise deques are fed round-robin.
+    void submit(Task task);
+
+    std::size_t workers() const { return queues_.size(); }
+
+    // Per-worker scratch memory, for use by the task running on that worker
+    ScratchArena& workerArena(std::size_t worker) { return session_.workerArena(worker); }
+
+    std::uint64_t tasksExecuted() const { return executed_.load(); }
+    std::uint64_t steals() const { return steals_.load(); }
+
+private:
+    struct alignas(kCacheLine) WorkerQueue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(std::size_t id);
+    bool pop_local(std::size_t id, Task& out);
+    bool steal(std::size_t thief, Task& out);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    PricingSession session_;
+
+    std::mutex idle_m_;
+    std::condition_variable idle_cv_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    std::atomic<std::uint64_t> executed_{0};
+    std::atomic<std::uint64_t> steals_{0};
+    bool stop_ = false;
+};
+
+// Result handle of a submitted job. Do not wait() on a handle from inside a
+// scheduler task: block on handles from outside the pool.
+template <typename T>
+class JobHandle {
+public:
+    struct State {
+        std::mutex m;
+        std::condition_variable cv;
+        bool done = false;
+        T value{};
+    };
+
+    JobHandle() = default;
+    explicit JobHandle(std::shared_ptr<State> s) : state_(std::move(s)) {}
+
+    bool valid() const { return static_cast<bool>(state_); }
+
+    bool ready() const {
+        std::lock_guard<std::mutex> lk(state_->m);
+        return state_->done;
+    }
+
+    void wait() const {
+        std::unique_lock<std::mutex> lk(state_->m);
+        state_->cv.wait(lk, [&] { return state_->done; });
+    }
+
+    // Returns false if the deadline passed before the result was ready
+    bool waitUntil(std::chrono::steady_clock::time_point deadline) const {
+        std::unique_lock<std::mutex> lk(state_->m);
+        return state_->cv.wait_until(lk, deadline, [&] { return state_->done; });
+    }
+
+    const T& get() const {
+        wait();
+        return state_->value;
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+// Process-wide scheduler (hardware concurrency workers), created on first use
+TaskScheduler& defaultScheduler();
+
+// Runs body(i, worker) for every i in [0, n) as stealable tasks: the index
+// range is split recursively, upper halves pushed for thieves. on_done runs
+// once, on the worker that finishes the last index.
+void parallelFor(TaskScheduler& sched, std::size_t n,
+                 std::function<void(std::size_t i, std::size_t worker)> body,
+                 std::function<void()> on_done);
+
+template <typename T>
+void completeJob(typename JobHandle<T>::State& st, T value) {
+    {
+        std::lock_guard<std::mutex> lk(st.m);
+        st.value = std::move(value);
+        st.done = true;
+    }
+    st.cv.notify_all();
+}
+
+struct BSQuote {
+    bool is_call = true;
+    double S, K, T, r, sigma;
+};
+
+struct IVQuote {
+    bool is_call = true;
+    double market_price, S, K, T, r;
+};
+
+// MC jobs are split into stealable path blocks (kMCBlockPaths each). Block
+// partials are merged in block order, so the result is identical to
+// mcCallPrice / mcPutPrice no matter which workers ran which blocks.
+JobHandle<MCResult> submitMC(TaskScheduler& sched, const MCJob& job);
+
+// Cheap closed-form work is batched: one task per `batch` quotes
+JobHandle<std::vector<double>> submitBSBatch(TaskScheduler& sched, std::vector<BSQuote> quotes,
+                                             std::size_t batch = 512);
+JobHandle<std::vector<IVResult>> submitIVBatch(TaskScheduler& sched, std::vector<IVQuote> quotes,
+                                               std::size_t batch = 64);
+
+#endif
@@ -0,0 +1,143 @@
+// term_structure.h
+
+#ifndef TERM_STRUCTURE_H
+#define TERM_STRUCTURE_H
+
+#include <cstddef>
+#include <vector>
+
+// Piecewise-constant instantaneous quantity f(t): values[i] applies on
+// (times[i-1], times[i]] (times[-1] = 0) and the last value extends past the
+// last knot. The integral of f from 0 to each knot is precomputed, so
+// integral(T) is one knot search plus one multiply-add.
+class PiecewiseCurve {
+public:
+    PiecewiseCurve() : PiecewiseCurve(0.0) {}
+    explicit PiecewiseCurve(double flat);
+    PiecewiseCurve(std::vector<double> times, std::vector<double> values);   // times increasing, > 0
+
+    double value(double t) const;
+    double integral(double T) const;                     // int_0^T f(s) ds
+    double integral(double t0, double t1) const { return integral(t1) - integral(t0); }
+
+    const std::vector<double>& times() const { return times_; }
+
+private:
+    std::size_t segment(double t) const;
+
+    std::vector<double> times_;
+    std::vector<double> values_;
+    std::vector<double> cum_;      // cum_[i] = int_0^{times_[i]} f
+};
+
+// Discounting from piecewise-constant instantaneous forward rates
+class DiscountCurve {
+public:
+    DiscountCurve(double flat_rate = 0.0) : fwd_(flat_rate) {}   // NOLINT: a flat rate converts
+    DiscountCurve(std::vector<double> times, std::vector<double> forward_rates)
+        : fwd_(std::move(times), std::move(forward_rates)) {}
+
+    // Forwards that reprice the given continuously compounded zero rates at their pillars
+    static DiscountCurve fromZeroRates(const std::vector<double>& times, const std::vector<double>& zero_rates);
+
+    double rateIntegral(double T) const { return fwd_.integral(T); }
+    double discount(double T) const;
+    double zeroRate(double T) const;             // instantaneous rate at T = 0
+    const PiecewiseCurve& forwards() const { return fwd_; }
+
+private:
+    PiecewiseCurve fwd_;
+};
+
+struct CashDividend {
+    double time;
+    double amount;
+};
+
+// Continuous dividend yield term structure plus discrete cash dividends
+class DividendCurve {
+public:
+    DividendCurve(double flat_yield = 0.0) : yield_(flat_yield) {}   // NOLINT: a flat yield converts
+    DividendCurve(PiecewiseCurve yield, std::vector<CashDividend> cash = {});
+
+    double yieldIntegral(double T) const { return yield_.integral(T); }
+    const PiecewiseCurve& yield() const { return yield_; }
+    const std::vector<CashDividend>& cash() const { return cash_; }   // sorted by time
+
+private:
+    PiecewiseCurve yield_;
+    std::vector<CashDividend> cash_;
+};
+
+// Piecewise-constant instantaneous volatility; the variance rate sigma^2 is
+// integrated, so total variance is cumulative like the rate curves.
+class VolTermStructure {
+public:
+    VolTermStructure(double flat_vol = 0.0);   // NOLINT: a flat vol converts
+    VolTermStructure(std::vector<double> times, std::vector<double> vols);
+
+    double totalVariance(double T) const { return var_.integral(T); }
+    double totalVariance(double t0, double t1) const { return var_.integral(t0, t1); }
+    double effectiveVol(double T) const;         // sqrt(w(T) / T), instantaneous vol at T = 0
+
+private:
+    PiecewiseCurve var_;
+};
+
+// Per-step terms of a simulation time grid, computed once per grid:
+//   log S_{i+1} = log S_i + drift[i] + diffusion[i] * Z
+// drift[i] = int (r - q - sigma^2 / 2), diffusion[i] = sqrt(int sigma^2)
+// over step i. Discrete dividends are carried by the escrowed spot instead.
+struct MCTimeGrid {
+    std::vector<double> times;       // n_steps + 1 points, times[0] = 0
+    std::vector<double> drift;
+    std::vector<double> diffusion;
+    double total_drift = 0.0;        // sum of drift
+    double total_variance = 0.0;     // sum of diffusion^2
+
+    std::size_t steps() const { return drift.size(); }
+};
+
+// Rates, dividends and vol for one underlying. Discrete dividends use the
+// escrowed model: the diffusing spot is S minus the PV of the cash dividends
+// paid up to the expiry, and the cumulative PVs are precomputed at the
+// dividend dates.
+class MarketCurves {
+public:
+    explicit MarketCurves(DiscountCurve rates = {}, DividendCurve dividends = {}, VolTermStructure vol = {});
+
+    static MarketCurves flat(double r, double sigma, double q = 0.0) {
+        return MarketCurves(DiscountCurve(r), DividendCurve(q), VolTermStructure(sigma));
+    }
+
+    double discount(double T) const { return rates_.discount(T); }
+    double zeroRate(double T) const { return rates_.zeroRate(T); }
+    double totalVariance(double T) const { return vol_.totalVariance(T); }
+    double effectiveVol(double T) const { return vol_.effectiveVol(T); }
+
+    double dividendPV(double T) const;                 // PV of cash dividends paid in (0, T]
+    double forward(double S, double T) const;          // (S - dividendPV(T)) e^{int (r - q)}
+
+    // Constant-parameter equivalent at expiry T: the flat engines priced at
+    // (spot, T, rate, vol) reproduce the curve price exactly.
+    // d(spot)/dS = spot_scale for the Greeks.
+    struct FlatInputs {
+        double spot, rate, vol, spot_scale;
+    };
+    FlatInputs flatten(double S, double T) const;
+
+    // Uniform grid of n_steps on [0, T]
+    MCTimeGrid timeGrid(double T, std::size_t n_steps) const;
+
+    const DiscountCurve& rates() const { return rates_; }
+    const DividendCurve& dividends() const { return dividends_; }
+    const VolTermStructure& vol() const { return vol_; }
+
+private:
+    DiscountCurve rates_;
+    DividendCurve dividends_;
+    VolTermStructure vol_;
+    std::vector<double> div_cum_pv_;   // PV of cash dividends up to and including each one
+};
+
+#endif
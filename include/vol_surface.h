@@ -0,0 +1,90 @@
+// vol_surface.h
+
+#ifndef VOL_SURFACE_H
+#define VOL_SURFACE_H
+
+#include <cstddef>
+#include <vector>
+
+// Raw SVI total implied variance: w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + s^2)),
+// with k = ln(K / F) and w = sigma^2 T.
+struct SVIParams {
+    double a;
+    double b;
+    double rho;
+    double m;
+    double s;
+};
+
+double sviTotalVariance(const SVIParams& p, double k);
+
+// Implied vol quotes for one expiry (e.g. from impliedVolCall / impliedVolPut)
+struct SliceQuotes {
+    double T;
+    double forward;
+    std::vector<double> strikes;
+    std::vector<double> ivs;
+    std::vector<double> weights;   // optional, empty = equal weights
+};
+
+struct SVIFit {
+    SVIParams params;
+    double rmse;       // in total variance
+    int iterations;
+    bool converged;
+    bool stalled;      // stopped because no damped step reduced the cost
+};
+
+// Levenberg–Marquardt fit of raw SVI to one slice, analytic Jacobian
+SVIFit fitSVISlice(const SliceQuotes& q, const SVIParams& init, int max_iter = 200, double tol = 1e-14);
+
+// Heuristic starting point when no previous calibration is available
+SVIParams sviInitialGuess(const SliceQuotes& q);
+
+class VolSurface {
+public:
+    VolSurface() = default;
+    VolSurface(double spot, std::vector<double> expiries, std::vector<double> forwards,
+               std::vector<SVIParams> params);
+
+    // Black–Scholes implied vol for strike K and maturity T. Total variance is
+    // interpolated linearly in T at fixed log-moneyness; flat vol beyond the ends.
+    double sigma(double K, double T) const;
+    double totalVariance(double k, double T) const;
+    double forward(double T) const;
+
+    bool empty() const { return expiries_.empty(); }
+    std::size_t size() const { return expiries_.size(); }
+    const std::vector<double>& expiries() const { return expiries_; }
+    const std::vector<SVIParams>& params() const { return params_; }
+
+private:
+    double spot_ = 0.0;
+    std::vector<double> expiries_;
+    std::vector<double> forwards_;
+    std::vector<SVIParams> params_;
+};
+
+struct CalibrationOptions {
+    std::size_t n_threads = 0;     // 0 = hardware concurrency
+    int max_iter = 200;
+    double tol = 1e-14;
+    bool ssvi = false;             // fit one SSVI surface across expiries instead of raw SVI per slice
+    double warm_start_tolerance = 1.0 / 365.0;   // max expiry gap (years) to a previous slice
+};
+
+struct CalibrationReport {
+    std::vector<SVIFit> fits;      // per expiry, in the order of the input slices
+    double max_rmse;
+    bool all_converged;
+};
+
+// Calibrate every expiry slice in parallel. If `previous` is given, each slice
+// is warm-started from the previous surface's parameters at the nearest
+// expiry within opts.warm_start_tolerance (T shrinks between refreshes).
+VolSurface calibrateSurface(double spot, const std::vector<SliceQuotes>& slices,
+                            const CalibrationOptions& opts = {},
+                            const VolSurface* previous = nullptr,
+                            CalibrationReport* report = nullptr);
+
+#endif
@@ -0,0 +1,264 @@
+// aad.cpp
+
+#include "aad.h"
+#include "black_scholes.h"
+#include "simd_math.h"
+#include "utils.h"
+
+#include <cmath>
+#include <algorithm>
+
+Tape::Tape() : own_(std::make_unique<ScratchArena>(std::size_t(1) << 18)), arena_(own_.get()) {}
+
+Tape::Tape(ScratchArena& arena) : arena_(&arena) {}
+
+ADouble Tape::input(double v) {
+    return {v, record(ADouble::kNoNode, 0.0), this};
+}
+
+void Tape::add_page() {
+    pages_.push_back(arena_->allocArray<Node>(kPageNodes));
+    capacity_ += kPageNodes;
+}
+
+void Tape::clearAdjoints(const Mark& from) {
+    for (std::size_t i = from.nodes; i < size_; i++) at(static_cast<std::uint32_t>(i)).adj = 0.0;
+}
+
+void Tape::propagate(const Mark& to) {
+    for (std::size_t i = size_; i-- > to.nodes;) {
+        const Node& n = at(static_cast<std::uint32_t>(i));
+        if (n.adj == 0.0) continue;
+        if (n.p[0] != ADouble::kNoNode) at(n.p[0]).adj += n.d[0] * n.adj;
+        if (n.p[1] != ADouble::kNoNode) at(n.p[1]).adj += n.d[1] * n.adj;
+    }
+}
+
+using aad_detail::unary;
+
+ADouble exp(const ADouble& x) {
+    const double e = std::exp(x.value);
+    return unary(x, e, e);
+}
+
+ADouble log(const ADouble& x) { return unary(x, std::log(x.value), 1.0 / x.value); }
+
+ADouble sqrt(const ADouble& x) {
+    const double s = std::sqrt(x.value);
+    return unary(x, s, 0.5 / s);
+}
+
+ADouble normal_cdf(const ADouble& x) { return unary(x, normal_cdf(x.value), normal_pdf(x.value)); }
+
+namespace {
+    // One tape per thread, rewound at the start of every call
+    Tape& scratch_tape() {
+        thread_local Tape tape;
+        return tape;
+    }
+
+    Sensitivities nan_sensitivities(double price) {
+        Sensitivities s;
+        s.price = price;
+        s.dS = s.dK = s.dT = s.dr = s.dsigma = NAN;
+        return s;
+    }
+
+    struct Inputs {
+        ADouble S, K, T, r, sigma;
+    };
+
+    Inputs record_inputs(Tape& tape, double S, double K, double T, double r, double sigma) {
+        return {tape.input(S), tape.input(K), tape.input(T), tape.input(r), tape.input(sigma)};
+    }
+
+    Sensitivities read_sensitivities(Tape& tape, const Inputs& in, double price) {
+        Sensitivities s;
+        s.price = price;
+        s.dS = tape.adjoint(in.S);
+        s.dK = tape.adjoint(in.K);
+        s.dT = tape.adjoint(in.T);
+        s.dr = tape.adjoint(in.r);
+        s.dsigma = tape.adjoint(in.sigma);
+        return s;
+    }
+
+    Sensitivities bs_aad(bool is_call, double S, double K, double T, double r, double sigma) {
+        if (S <= 0.0 || K <= 0.0 || T <= 0.0 || sigma <= 0.0) {
+            return nan_sensitivities(is_call ? callPrice(S, K, T, r, sigma) : putPrice(S, K, T, r, sigma));
+        }
+
+        Tape& tape = scratch_tape();
+        tape.rewind(Tape::Mark{0});
+        const Inputs in = record_inputs(tape, S, K, T, r, sigma);
+
+        // Same operation order as callPrice / putPrice, so the price matches bitwise
+        const ADouble vol_sqrtT = in.sigma * sqrt(in.T);
+        const ADouble d1 = (log(in.S / in.K) + (in.r + 0.5 * in.sigma * in.sigma) * in.T) / vol_sqrtT;
+        const ADouble d2 = d1 - vol_sqrtT;
+        const ADouble df = exp(-in.r * in.T);
+        const ADouble price = is_call
+            ? in.S * normal_cdf(d1) - in.K * df * normal_cdf(d2)
+            : in.K * df * normal_cdf(-d2) - in.S * normal_cdf(-d1);
+
+        tape.adjoint(price.node) = 1.0;
+        tape.propagate();
+        return read_sensitivities(tape, in, price.value);
+    }
+
+    // Paths recorded per reverse sweep: keeps the live tape in L2
+    constexpr std::size_t kSweepPaths = 512;
+
+    struct PathNodes {
+        double x, y;
+        std::uint32_t xn, yn;
+    };
+
+    // One leg of a path recorded as fused statements (one node each for the
+    // exponent, S_T, the payoff, X and Y) with the same value arithmetic as
+    // the dispatched MC kernel, so values match it bitwise.
+    inline PathNodes record_leg(Tape& t, bool is_call, const Inputs& in, const ADouble& df,
+                                const ADouble& drift, const ADouble& vol_sqrtT, double z) {
+        const double a = drift.value + vol_sqrtT.value * z;
+        const std::uint32_t an = t.record(drift.node, 1.0, vol_sqrtT.node, z);
+
+        const double g = simd_math::exp(a);
+        const double ST = in.S.value * g;
+        const std::uint32_t stn = t.record(in.S.node, g, an, ST);
+
+        const double intrinsic = is_call ? ST - in.K.value : in.K.value - ST;
+        const double pay = std::max(intrinsic, 0.0);
+        const double itm = (intrinsic < 0.0) ? 0.0 : 1.0;
+        const std::uint32_t pn = is_call ? t.record(stn, itm, in.K.node, -itm)
+                                         : t.record(stn, -itm, in.K.node, itm);
+
+        return {df.value * pay, df.value * ST,
+                t.record(df.node, pay, pn, df.value), t.record(df.node, ST, stn, df.value)};
+    }
+
+    MCSensitivities mc_aad(bool is_call, double S, double K, double T, double r, double sigma,
+                           std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+        MCSensitivities out;
+        // Importance weights and the block-wise moment / martingale rescaling
+        // are not differentiated: price only
+        const bool supported = mode == MCMode::Plain || mode == MCMode::Antithetic ||
+                               mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS;
+        if (S <= 0.0 || K <= 0.0 || T <= 0.0 || sigma < 0.0 || n_paths < 2 || !supported) {
+            out.result = is_call ? mcCallPrice(S, K, T, r, sigma, n_paths, seed, mode)
+                                 : mcPutPrice(S, K, T, r, sigma, n_paths, seed, mode);
+            out.greeks = nan_sensitivities(out.result.price);
+            return out;
+        }
+
+        const bool useAnti = (mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS);
+        const bool useCV   = (mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS);
+
+        Tape& tape = scratch_tape();
+        tape.rewind(Tape::Mark{0});
+        const Inputs in = record_inputs(tape, S, K, T, r, sigma);
+
+        // Run constants, recorded once (same expressions as the MC engine)
+        const ADouble df = exp(-in.r * in.T);
+        const ADouble drift = (in.r - 0.5 * in.sigma * in.sigma) * in.T;
+        const ADouble vol_sqrtT = in.sigma * sqrt(in.T);
+        const Tape::Mark head = tape.mark();
+
+        // Head adjoints accumulated over blocks: from sum X and from sum Y
+        std::vector<double> gX(head.nodes, 0.0), gY(head.nodes, 0.0);
+        auto harvest = [&](std::vector<double>& g) {
+            for (std::size_t i = 0; i < head.nodes; i++) {
+                double& a = tape.adjoint(static_cast<std::uint32_t>(i));
+                g[i] += a;
+                a = 0.0;
+            }
+        };
+
+        std::vector<double> Z(kMCBlockPaths), xv(kMCBlockPaths), yv(kMCBlockPaths);
+        std::vector<std::uint32_t> xn(kMCBlockPaths), yn(kMCBlockPaths);
+        MCPartial total;
+
+        const std::size_t blocks = mcBlockCount(n_paths);
+        for (std::size_t b = 0; b < blocks; b++) {
+            const std::size_t first = b * kMCBlockPaths;
+            const std::size_t n = std::min(kMCBlockPaths, n_paths - first);
+
+            std::uint64_t state = seed;
+            rand_skip_normals(state, first);
+            rand_standard_normal_fill(state, Z.data(), n);
+
+            // Record, sweep back into the run constants and drop the block in
+            // cache-sized slices
+            for (std::size_t lo = 0; lo < n; lo += kSweepPaths) {
+                const std::size_t hi = std::min(n, lo + kSweepPaths);
+                for (std::size_t i = lo; i < hi; i++) {
+                    PathNodes p = record_leg(tape, is_call, in, df, drift, vol_sqrtT, Z[i]);
+                    if (useAnti) {
+                        const PathNodes q = record_leg(tape, is_call, in, df, drift, vol_sqrtT, -Z[i]);
+                        p = {0.5 * (p.x + q.x), 0.5 * (p.y + q.y),
+                             tape.record(p.xn, 0.5, q.xn, 0.5), tape.record(p.yn, 0.5, q.yn, 0.5)};
+                    }
+                    xv[i] = p.x; xn[i] = p.xn;
+                    yv[i] = p.y; yn[i] = p.yn;
+                }
+                out.tape_peak_nodes = std::max(out.tape_peak_nodes, tape.size());
+
+                for (std::size_t i = lo; i < hi; i++) tape.adjoint(xn[i]) = 1.0;
+                tape.propagate(head);
+                harvest(gX);
+                if (useCV) {
+                    tape.clearAdjoints(head);
+                    for (std::size_t i = lo; i < hi; i++) tape.adjoint(yn[i]) = 1.0;
+                    tape.propagate(head);
+                    harvest(gY);
+                }
+                tape.rewind(head);
+            }
+
+            // Block statistics, accumulated exactly as the MC engine does
+            const MCPartial part = mcAccumulate(xv.data(), yv.data(), n, useCV, S);
+            mcMerge(total, part);
+        }
+
+        out.result = mcFinalize(total);
+
+        // Finish each gradient through the run constants down to the inputs
+        const double N = static_cast<double>(total.n);
+        auto finish = [&](const std::vector<double>& g) {
+            for (std::size_t i = 0; i < head.nodes; i++) tape.adjoint(static_cast<std::uint32_t>(i)) = g[i] / N;
+            tape.propagate();
+            return read_sensitivities(tape, in, out.result.price);
+        };
+
+        out.greeks = finish(gX);
+        if (useCV) {
+            // b = cov(X, Y) / var(Y), as in the estimator, held fixed
+            const double beta = (total.M2Y > 0.0) ? total.C / total.M2Y : 0.0;
+
+            const Sensitivities gy = finish(gY);
+            out.greeks.dS -= beta * (gy.dS - 1.0);
+            out.greeks.dK -= beta * gy.dK;
+            out.greeks.dT -= beta * gy.dT;
+            out.greeks.dr -= beta * gy.dr;
+            out.greeks.dsigma -= beta * gy.dsigma;
+        }
+        return out;
+    }
+}
+
+Sensitivities bsCallAAD(double S, double K, double T, double r, double sigma) {
+    return bs_aad(true, S, K, T, r, sigma);
+}
+
+Sensitivities bsPutAAD(double S, double K, double T, double r, double sigma) {
+    return bs_aad(false, S, K, T, r, sigma);
+}
+
+MCSensitivities mcCallAAD(double S, double K, double T, double r, double sigma,
+                          std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mc_aad(true, S, K, T, r, sigma, n_paths, seed, mode);
+}
+
+MCSensitivities mcPutAAD(double S, double K, double T, double r, double sigma,
+                         std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mc_aad(false, S, K, T, r, sigma, n_paths, seed, mode);
+}
@@ -0,0 +1,120 @@
+// async_pricing.cpp
+
+#include "async_pricing.h"
+#include "black_scholes.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // True once the job should stop taking on new work
+    inline bool should_stop(const AsyncOptions& opts) {
+        if (opts.token.cancelled()) return true;
+        return opts.deadline != Deadline::max() && std::chrono::steady_clock::now() >= opts.deadline;
+    }
+
+    inline AsyncStatus stop_status(const AsyncOptions& opts, bool skipped) {
+        if (!skipped) return AsyncStatus::Complete;
+        return opts.token.cancelled() ? AsyncStatus::Cancelled : AsyncStatus::DeadlineExpired;
+    }
+
+    template <typename T, typename Fn>
+    PricingFuture<BatchAsyncResult<T>> batch_async(TaskScheduler& sched, std::size_t n, std::size_t batch,
+                                                   const AsyncOptions& opts, T skipped_value, Fn fn) {
+        using Result = BatchAsyncResult<T>;
+        auto result = std::make_shared<typename JobHandle<Result>::State>();
+        batch = std::max<std::size_t>(batch, 1);
+        const std::size_t chunks = (n + batch - 1) / batch;
+
+        auto out = std::make_shared<Result>();
+        out->values.assign(n, skipped_value);
+        auto done = std::make_shared<std::vector<char>>(chunks, 0);
+
+        parallelFor(sched, chunks,
+            [out, done, fn, opts, n, batch](std::size_t c, std::size_t) {
+                if (should_stop(opts)) return;
+                const std::size_t lo = c * batch, hi = std::min(n, lo + batch);
+                for (std::size_t i = lo; i < hi; i++) out->values[i] = fn(i);
+                (*done)[c] = 1;
+            },
+            [out, done, opts, n, batch, result] {
+                bool skipped = false;
+                for (std::size_t c = 0; c < done->size(); c++) {
+                    if (!(*done)[c]) { skipped = true; continue; }
+                    out->completed += std::min(n, (c + 1) * batch) - c * batch;
+                }
+                out->status = stop_status(opts, skipped);
+                completeJob<Result>(*result, std::move(*out));
+            });
+        return PricingFuture<Result>(JobHandle<Result>(result), opts.token);
+    }
+}
+
+PricingFuture<MCAsyncResult> mcPriceAsync(TaskScheduler& sched, const MCJob& job, const AsyncOptions& opts) {
+    auto result = std::make_shared<JobHandle<MCAsyncResult>::State>();
+
+    // Degenerate inputs are answered inline by the serial engine
+    if (job.S <= 0.0 || job.K <= 0.0 || job.T <= 0.0 || job.sigma < 0.0 || job.n_paths < 2) {
+        MCAsyncResult out;
+        out.result = job.is_call
+            ? mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode)
+            : mcPutPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode);
+        out.paths_done = out.paths_requested = job.n_paths;
+        completeJob<MCAsyncResult>(*result, out);
+        return PricingFuture<MCAsyncResult>(JobHandle<MCAsyncResult>(result), opts.token);
+    }
+
+    const std::size_t blocks = mcBlockCount(job.n_paths);
+    auto parts = std::make_shared<std::vector<MCPartial>>(blocks);
+    auto done = std::make_shared<std::vector<char>>(blocks, 0);
+
+    parallelFor(sched, blocks,
+        [&sched, job, opts, parts, done](std::size_t b, std::size_t w) {
+            if (should_stop(opts)) return;
+            ScratchArena& arena = sched.workerArena(w);
+            (*parts)[b] = job.is_call
+                ? mcCallBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena)
+                : mcPutBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena);
+            (*done)[b] = 1;
+        },
+        [job, opts, parts, done, result] {
+            MCAsyncResult out;
+            out.paths_requested = job.n_paths;
+
+            // Skipped blocks contribute nothing; the rest merge in block order
+            MCPartial total;
+            bool skipped = false;
+            for (std::size_t b = 0; b < parts->size(); b++) {
+                if (!(*done)[b]) { skipped = true; continue; }
+                mcMerge(total, (*parts)[b]);
+                out.paths_done += std::min(job.n_paths, (b + 1) * kMCBlockPaths) - b * kMCBlockPaths;
+            }
+            out.result = mcFinalize(total);
+            out.status = stop_status(opts, skipped);
+            completeJob<MCAsyncResult>(*result, out);
+        });
+    return PricingFuture<MCAsyncResult>(JobHandle<MCAsyncResult>(result), opts.token);
+}
+
+PricingFuture<MCAsyncResult> mcPriceAsync(const MCJob& job, const AsyncOptions& opts) {
+    return mcPriceAsync(defaultScheduler(), job, opts);
+}
+
+PricingFuture<BatchAsyncResult<double>> bsBatchAsync(TaskScheduler& sched, std::vector<BSQuote> quotes,
+                                                     const AsyncOptions& opts, std::size_t batch) {
+    auto q = std::make_shared<const std::vector<BSQuote>>(std::move(quotes));
+    return batch_async<double>(sched, q->size(), batch, opts, NAN, [q](std::size_t i) {
+        const BSQuote& b = (*q)[i];
+        return b.is_call ? callPrice(b.S, b.K, b.T, b.r, b.sigma) : putPrice(b.S, b.K, b.T, b.r, b.sigma);
+    });
+}
+
+PricingFuture<BatchAsyncResult<IVResult>> ivBatchAsync(TaskScheduler& sched, std::vector<IVQuote> quotes,
+                                                       const AsyncOptions& opts, std::size_t batch) {
+    auto q = std::make_shared<const std::vector<IVQuote>>(std::move(quotes));
+    return batch_async<IVResult>(sched, q->size(), batch, opts, IVResult{NAN, 0, false}, [q](std::size_t i) {
+        const IVQuote& v = (*q)[i];
+        return v.is_call ? impliedVolCall(v.market_price, v.S, v.K, v.T, v.r)
+                         : impliedVolPut(v.market_price, v.S, v.K, v.T, v.r);
+    });
+}
@@ -0,0 +1,305 @@
+// basket.cpp
+
+#include "basket.h"
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "pricing_session.h"
+#include "utils.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // Paths per chunk: each dim x chunk buffer stays near 64 KB
+    constexpr std::size_t kChunkDoubles = 8192;
+
+    std::size_t chunk_paths(std::size_t dim) {
+        const std::size_t c = std::max<std::size_t>(kChunkDoubles / dim, 64) & ~std::size_t(7);
+        return std::min(c, kMCBlockPaths);
+    }
+
+    bool valid_correlation(const std::vector<double>& c, std::size_t dim) {
+        if (dim == 0 || c.size() != dim * dim) return false;
+        for (std::size_t i = 0; i < dim; i++) {
+            if (!(std::fabs(c[i * dim + i] - 1.0) <= 1e-12)) return false;
+            for (std::size_t j = 0; j < i; j++) {
+                const double a = c[i * dim + j], b = c[j * dim + i];
+                if (!(std::fabs(a - b) <= 1e-12) || !(std::fabs(a) <= 1.0)) return false;
+            }
+        }
+        return true;
+    }
+
+    bool cholesky(const std::vector<double>& c, std::size_t dim, std::vector<double>& L) {
+        L.assign(dim * dim, 0.0);
+        for (std::size_t i = 0; i < dim; i++) {
+            for (std::size_t j = 0; j <= i; j++) {
+                double s = c[i * dim + j];
+                for (std::size_t k = 0; k < j; k++) s -= L[i * dim + k] * L[j * dim + k];
+                if (i == j) {
+                    if (!(s > 1e-14)) return false;
+                    L[i * dim + i] = std::sqrt(s);
+                } else {
+                    L[i * dim + j] = s / L[j * dim + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    // Cyclic Jacobi: a is overwritten with (nearly) diag(lambda), v with the eigenvectors (columns)
+    void jacobi_eigen(std::vector<double>& a, std::size_t dim, std::vector<double>& v) {
+        v.assign(dim * dim, 0.0);
+        for (std::size_t i = 0; i < dim; i++) v[i * dim + i] = 1.0;
+
+        for (int sweep = 0; sweep < 100; sweep++) {
+            double off = 0.0;
+            for (std::size_t p = 0; p < dim; p++)
+                for (std::size_t q = p + 1; q < dim; q++) off += a[p * dim + q] * a[p * dim + q];
+            if (off < 1e-30) break;
+
+            for (std::size_t p = 0; p < dim; p++) {
+                for (std::size_t q = p + 1; q < dim; q++) {
+                    const double apq = a[p * dim + q];
+                    if (std::fabs(apq) < 1e-300) continue;
+                    // Rotation zeroing a_pq: cot(2 phi) = theta, t = tan(phi)
+                    const double theta = (a[q * dim + q] - a[p * dim + p]) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                    for (std::size_t k = 0; k < dim; k++) {
+                        const double akp = a[k * dim + p], akq = a[k * dim + q];
+                        a[k * dim + p] = c * akp - s * akq;
+                        a[k * dim + q] = s * akp + c * akq;
+                    }
+                    for (std::size_t k = 0; k < dim; k++) {
+                        const double apk = a[p * dim + k], aqk = a[q * dim + k];
+                        a[p * dim + k] = c * apk - s * aqk;
+                        a[q * dim + k] = s * apk + c * aqk;
+                    }
+                    for (std::size_t k = 0; k < dim; k++) {
+                        const double vkp = v[k * dim + p], vkq = v[k * dim + q];
+                        v[k * dim + p] = c * vkp - s * vkq;
+                        v[k * dim + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    bool valid_option(const BasketOption& o, const CorrelationFactor& f) {
+        const std::size_t n = o.spots.size();
+        if (n == 0 || f.dim != n || o.vols.size() != n || o.weights.size() != n) return false;
+        if (!o.dividends.empty() && o.dividends.size() != n) return false;
+        if (!(o.K >= 0.0) || !(o.T >= 0.0)) return false;
+        for (std::size_t i = 0; i < n; i++) {
+            if (!(o.spots[i] > 0.0) || !(o.vols[i] >= 0.0) || !std::isfinite(o.weights[i])) return false;
+        }
+        return true;
+    }
+
+    double underlying(BasketPayoff payoff, double sum, double best, double worst) {
+        switch (payoff) {
+            case BasketPayoff::BestOf:  return best;
+            case BasketPayoff::WorstOf: return worst;
+            default:                    return sum;
+        }
+    }
+
+    // Per-run constants shared by every block
+    struct BasketRun {
+        std::vector<double> log_mean;     // E[log S_i(T)]
+        std::vector<double> vol_sqrtT;
+        std::vector<double> geo_weights;  // w_i / sum w, geometric control only
+        double df = 1.0;
+        double sign = 1.0;                // +1 call, -1 put
+        bool geometric = false;
+        double weight_sum = 0.0;
+        double control_mean = 0.0;
+    };
+
+    BasketRun setup(const BasketOption& o, const CorrelationFactor& f) {
+        const std::size_t n = o.spots.size();
+        BasketRun run;
+        run.df = std::exp(-o.r * o.T);
+        run.sign = o.is_call ? 1.0 : -1.0;
+        run.log_mean.resize(n);
+        run.vol_sqrtT.resize(n);
+        run.geo_weights.assign(n, 0.0);
+
+        bool positive = true;
+        double arithmetic_mean = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            const double q = o.dividends.empty() ? 0.0 : o.dividends[i];
+            const double s = o.vols[i];
+            run.log_mean[i] = std::log(o.spots[i]) + (o.r - q - 0.5 * s * s) * o.T;
+            run.vol_sqrtT[i] = s * std::sqrt(o.T);
+            run.weight_sum += o.weights[i];
+            arithmetic_mean += o.weights[i] * o.spots[i] * std::exp(-q * o.T);
+            positive = positive && o.weights[i] > 0.0;
+        }
+
+        run.geometric = (o.payoff == BasketPayoff::Basket) && positive && o.K > 0.0;
+        if (!run.geometric) {
+            run.control_mean = arithmetic_mean;
+            return run;
+        }
+
+        // sum w * G, G = prod S_i^{a_i}, is lognormal: log-mean m, log-variance
+        // v = sum_k (sum_i a_i sigma_i sqrt(T) A_ik)^2 under the factored correlation
+        double m = std::log(run.weight_sum), v = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            run.geo_weights[i] = o.weights[i] / run.weight_sum;
+            m += run.geo_weights[i] * run.log_mean[i];
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            double u = 0.0;
+            for (std::size_t i = 0; i < n; i++) u += run.geo_weights[i] * run.vol_sqrtT[i] * f.matrix[i * n + k];
+            v += u * u;
+        }
+        // Black–Scholes with the forward e^{m + v / 2} and total variance v
+        const double S_eff = std::exp(m + 0.5 * v - o.r * o.T);
+        const double sigma_eff = std::sqrt(v / o.T);
+        run.control_mean = o.is_call ? callPrice(S_eff, o.K, o.T, o.r, sigma_eff)
+                                     : putPrice(S_eff, o.K, o.T, o.r, sigma_eff);
+        return run;
+    }
+
+    ScratchArena& default_arena() {
+        thread_local ScratchArena arena(std::size_t(1) << 20);
+        return arena;
+    }
+}
+
+bool factorCorrelation(const std::vector<double>& corr, std::size_t dim, CorrelationFactor& out) {
+    if (!valid_correlation(corr, dim)) return false;
+
+    CorrelationFactor f;
+    f.dim = dim;
+    if (cholesky(corr, dim, f.matrix)) {
+        out = std::move(f);
+        return true;
+    }
+
+    std::vector<double> a = corr, v;
+    jacobi_eigen(a, dim, v);
+    f.lower = false;
+    f.min_eigenvalue = a[0];
+    for (std::size_t k = 1; k < dim; k++) f.min_eigenvalue = std::min(f.min_eigenvalue, a[k * dim + k]);
+    f.repaired = f.min_eigenvalue < -1e-12;
+
+    // A = V sqrt(max(Lambda, 0)), rows rescaled to unit length (unit diagonal of A A^T)
+    f.matrix.assign(dim * dim, 0.0);
+    for (std::size_t i = 0; i < dim; i++) {
+        double norm2 = 0.0;
+        for (std::size_t k = 0; k < dim; k++) {
+            const double b = v[i * dim + k] * std::sqrt(std::max(a[k * dim + k], 0.0));
+            f.matrix[i * dim + k] = b;
+            norm2 += b * b;
+        }
+        if (!(norm2 > 0.0)) return false;
+        const double inv = 1.0 / std::sqrt(norm2);
+        for (std::size_t k = 0; k < dim; k++) f.matrix[i * dim + k] *= inv;
+    }
+    out = std::move(f);
+    return true;
+}
+
+MCPartial mcBasketBlock(const BasketOption& option, const CorrelationFactor& factor,
+                        std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                        std::size_t block, ScratchArena& arena) {
+    const bool useAnti = mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS;
+    const bool useCV = mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS;
+    const BasketRun run = setup(option, factor);
+
+    MCPartial out;
+    out.control = useCV;
+    out.control_mean = run.control_mean;
+
+    const std::size_t first = block * kMCBlockPaths;
+    if (first >= n_paths) return out;
+    const std::size_t n = std::min(kMCBlockPaths, n_paths - first);
+    const std::size_t dim = factor.dim;
+    const std::size_t chunk = chunk_paths(dim);
+
+    const ScratchArena::Marker mark = arena.mark();
+    double* draws = arena.allocArray<double>(chunk * dim);   // path-major, as drawn
+    double* Z = arena.allocArray<double>(dim * chunk);       // asset-major
+    double* W = arena.allocArray<double>(dim * chunk);
+    double* sum = arena.allocArray<double>(chunk);
+    double* best = arena.allocArray<double>(chunk);
+    double* worst = arena.allocArray<double>(chunk);
+    double* log_geo = arena.allocArray<double>(chunk);
+    double* X = arena.allocArray<double>(n);
+    double* Y = arena.allocArray<double>(n);
+
+    std::uint64_t state = seed;
+    rand_skip_normals(state, static_cast<std::uint64_t>(first) * dim);
+    const KernelTable& k = kernels();
+
+    for (std::size_t c0 = 0; c0 < n; c0 += chunk) {
+        const std::size_t m = std::min(chunk, n - c0);
+        rand_standard_normal_fill(state, draws, m * dim);
+        for (std::size_t p = 0; p < m; p++)
+            for (std::size_t j = 0; j < dim; j++) Z[j * m + p] = draws[p * dim + j];
+        k.correlate(factor.matrix.data(), dim, factor.lower, Z, m, W);
+
+        for (int leg = 0; leg < (useAnti ? 2 : 1); leg++) {
+            k.basket_paths(W, dim, m, run.log_mean.data(), run.vol_sqrtT.data(), option.weights.data(),
+                           run.geo_weights.data(), leg == 0 ? 1.0 : -1.0, sum, best, worst, log_geo);
+            for (std::size_t p = 0; p < m; p++) {
+                const double u = underlying(option.payoff, sum[p], best[p], worst[p]);
+                const double x = run.df * std::max(run.sign * (u - option.K), 0.0);
+                const double y = run.geometric
+                    ? run.df * std::max(run.sign * (run.weight_sum * std::exp(log_geo[p]) - option.K), 0.0)
+                    : run.df * sum[p];
+                if (leg == 0) {
+                    X[c0 + p] = x;
+                    Y[c0 + p] = y;
+                } else {
+                    X[c0 + p] = 0.5 * (X[c0 + p] + x);
+                    Y[c0 + p] = 0.5 * (Y[c0 + p] + y);
+                }
+            }
+        }
+    }
+
+    out = mcAccumulate(X, Y, n, useCV, run.control_mean);
+    arena.rewind(mark);
+    return out;
+}
+
+MCResult mcBasketPrice(const BasketOption& option, const CorrelationFactor& factor,
+                       std::size_t n_paths, std::uint64_t seed, MCMode mode, ScratchArena& arena) {
+    if (!valid_option(option, factor) || n_paths < 2 ||
+        (mode != MCMode::Plain && mode != MCMode::Antithetic &&
+         mode != MCMode::ControlVariateBS && mode != MCMode::AntitheticControlBS)) {
+        return {NAN, NAN, NAN, NAN};
+    }
+
+    if (option.T == 0.0) {
+        double sum = 0.0, best = -HUGE_VAL, worst = HUGE_VAL;
+        for (std::size_t i = 0; i < option.spots.size(); i++) {
+            const double s = option.weights[i] * option.spots[i];
+            sum += s;
+            best = std::max(best, s);
+            worst = std::min(worst, s);
+        }
+        const double u = underlying(option.payoff, sum, best, worst);
+        const double p = std::max((option.is_call ? 1.0 : -1.0) * (u - option.K), 0.0);
+        return {p, 0.0, p, p};
+    }
+
+    MCPartial total;
+    const std::size_t blocks = mcBlockCount(n_paths);
+    for (std::size_t b = 0; b < blocks; b++) {
+        mcMerge(total, mcBasketBlock(option, factor, n_paths, seed, mode, b, arena));
+    }
+    return mcFinalize(total);
+}
+
+MCResult mcBasketPrice(const BasketOption& option, const std::vector<double>& correlation,
+                       std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    CorrelationFactor factor;
+    if (!factorCorrelation(correlation, option.spots.size(), factor)) return {NAN, NAN, NAN, NAN};
+    return mcBasketPrice(option, factor, n_paths, seed, mode, default_arena());
+}
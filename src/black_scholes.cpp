@@ -2,69 +2,102 @@
 
 #include "black_scholes.h"
 #include "utils.h"
+#include "cpu_dispatch.h"
+#include "term_structure.h"
 
 #include <cmath>
 #include <algorithm>
 
 namespace {
-    inline double call_intrinsic(double S, double K) {
-        return std::max(S - K, 0.0);
+    template <typename Real>
+    inline Real call_intrinsic(Real S, Real K) {
+        return std::max(S - K, Real(0));
     }
 
-    inline double put_intrinsic(double S, double K) {
-        return std::max(K - S, 0.0);
+    template <typename Real>
+    inline Real put_intrinsic(Real S, Real K) {
+        return std::max(K - S, Real(0));
     }
 
-    inline double d1(double S, double K, double T, double r, double sigma) {
-        const double vol_sqrtT = sigma * std::sqrt(T);
-        return (std::log(S/K) + (r + 0.5 * sigma * sigma)*T) / vol_sqrtT;
-    }
-
-    inline double d2(double d1_val, double T, double sigma) {
-        return (d1_val - sigma * std::sqrt(T));
+    inline bool regular_quote(double S, double K, double T, double sigma) {
+        return S > 0.0 && K > 0.0 && T > 0.0 && sigma > 0.0;
     }
 }
 
 
-double callPrice(double S, double K, double T, double r, double sigma) {
-    if (S <= 0.0 || K<=0.0 || T <= 0.0 || sigma < 0.0 ) {
-        return NAN;
+template <typename Real>
+Real callPriceT(Real S, Real K, Real T, Real r, Real sigma) {
+    if (S <= Real(0) || K <= Real(0) || T <= Real(0) || sigma < Real(0)) {
+        return static_cast<Real>(NAN);
     }
-    if (T == 0.0) { 
-        return call_intrinsic(S,K);
+    if (T == Real(0)) {
+        return call_intrinsic(S, K);
     }
-    if (sigma==0.0) {
-        return std::max(S - K * std::exp(-r * T),0.0);
+    if (sigma == Real(0)) {
+        return std::max(S - K * std::exp(-r * T), Real(0));
     }
 
-    const double d1_val = bs_d1(S, K, T, r, sigma);
-    const double d2_val = bs_d2_from_d1(d1_val,T,sigma);
-    const double df = std::exp(-r * T);
+    const Real d1_val = bs_d1_t<Real>(S, K, T, r, sigma);
+    const Real d2_val = bs_d2_from_d1_t<Real>(d1_val, T, sigma);
+    const Real df = std::exp(-r * T);
 
-    return S * normal_cdf(d1_val) - K * df * normal_cdf(d2_val);
+    return S * normal_cdf_t<Real>(d1_val) - K * df * normal_cdf_t<Real>(d2_val);
 }
 
-double putPrice(double S, double K, double T, double r, double sigma) {
-    if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0) {
-     return NAN;
+template <typename Real>
+Real putPriceT(Real S, Real K, Real T, Real r, Real sigma) {
+    if (S <= Real(0) || K <= Real(0) || T < Real(0) || sigma < Real(0)) {
+        return static_cast<Real>(NAN);
     }
-
-    if (T == 0.0) { 
-    return put_intrinsic(S, K);
+    if (T == Real(0)) {
+        return put_intrinsic(S, K);
     }
-
-    if (sigma == 0.0) {
-        return std::max(K * std::exp(-r * T) - S, 0.0);
+    if (sigma == Real(0)) {
+        return std::max(K * std::exp(-r * T) - S, Real(0));
     }
 
-    const double d1_val = bs_d1(S, K, T, r, sigma);
-    const double d2_val = bs_d2_from_d1(d1_val, T, sigma);
-    const double df = std::exp(-r * T);
+    const Real d1_val = bs_d1_t<Real>(S, K, T, r, sigma);
+    const Real d2_val = bs_d2_from_d1_t<Real>(d1_val, T, sigma);
+    const Real df = std::exp(-r * T);
+
+    return K * df * normal_cdf_t<Real>(-d2_val) - S * normal_cdf_t<Real>(-d1_val);
+}
+
+template float  callPriceT<float>(float, float, float, float, float);
+template double callPriceT<double>(double, double, double, double, double);
+template float  putPriceT<float>(float, float, float, float, float);
+template double putPriceT<double>(double, double, double, double, double);
 
-    return K * df * normal_cdf(-d2_val) - S * normal_cdf(-d1_val);
+double callPrice(double S, double K, double T, double r, double sigma) {
+    return callPriceT<double>(S, K, T, r, sigma);
 }
 
+double putPrice(double S, double K, double T, double r, double sigma) {
+    return putPriceT<double>(S, K, T, r, sigma);
+}
 
+double callPrice(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return callPrice(f.spot, K, T, f.rate, f.vol);
+}
 
+double putPrice(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return putPrice(f.spot, K, T, f.rate, f.vol);
+}
 
+void callPriceBatch(const double* S, const double* K, const double* T, const double* r,
+                    const double* sigma, double* out, std::size_t n) {
+    kernels().bs_price(true, S, K, T, r, sigma, out, n);
+    for (std::size_t i = 0; i < n; i++) {
+        if (!regular_quote(S[i], K[i], T[i], sigma[i])) out[i] = callPrice(S[i], K[i], T[i], r[i], sigma[i]);
+    }
+}
 
+void putPriceBatch(const double* S, const double* K, const double* T, const double* r,
+                   const double* sigma, double* out, std::size_t n) {
+    kernels().bs_price(false, S, K, T, r, sigma, out, n);
+    for (std::size_t i = 0; i < n; i++) {
+        if (!regular_quote(S[i], K[i], T[i], sigma[i])) out[i] = putPrice(S[i], K[i], T[i], r[i], sigma[i]);
+    }
+}
@@ -0,0 +1,312 @@
+// chebyshev_proxy.cpp
+
+#include "chebyshev_proxy.h"
+#include "utils.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace {
+    constexpr const char* kMagic = "chebproxy";
+    constexpr int kFormatVersion = 1;
+    constexpr std::size_t kMaxNodes = 128;       // per axis; evaluation keeps its tables on the stack
+    constexpr std::size_t kMaxInnerNodes = 4096;  // vol x time nodes (weights of one spot row)
+    constexpr double kPi = 3.14159265358979323846;
+
+    bool valid_axis(const ChebyshevAxis& a) {
+        if (a.nodes == 0 || a.nodes > kMaxNodes || !std::isfinite(a.lo)) return false;
+        return a.nodes == 1 || (std::isfinite(a.hi) && a.hi > a.lo);
+    }
+
+    double node(const ChebyshevAxis& a, std::size_t m) {
+        if (a.nodes == 1) return a.lo;
+        const double t = std::cos(kPi * static_cast<double>(m) / static_cast<double>(a.nodes - 1));
+        return a.lo + 0.5 * (a.hi - a.lo) * (1.0 + t);
+    }
+
+    // x mapped to [-1, 1]; false outside the axis (a fixed axis takes anything)
+    bool to_unit(const ChebyshevAxis& a, double x, double& t) {
+        if (a.nodes == 1) {
+            t = 0.0;
+            return true;
+        }
+        if (!(x >= a.lo && x <= a.hi)) return false;
+        t = (2.0 * x - a.lo - a.hi) / (a.hi - a.lo);
+        return true;
+    }
+
+    bool valid_grid(const ChebyshevAxis& spot, const ChebyshevAxis& vol, const ChebyshevAxis& time) {
+        return valid_axis(spot) && spot.nodes >= 2 && valid_axis(vol) && valid_axis(time) &&
+               vol.nodes * time.nodes <= kMaxInnerNodes;
+    }
+
+    // Four independent partial sums: the add latency, not the multiplies, bounds a plain loop
+    inline double dot(const double* a, const double* b, std::size_t n) {
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; i++) s0 += a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    void chebyshev_values(double t, std::size_t n, double* T) {
+        T[0] = 1.0;
+        if (n > 1) T[1] = t;
+        for (std::size_t k = 2; k < n; k++) T[k] = 2.0 * t * T[k - 1] - T[k - 2];
+    }
+
+    // Values at Lobatto nodes -> coefficients, along one axis of the tensor:
+    // c_k = 2 / (n - 1) sum_m'' f_m cos(pi k m / (n - 1)), ends halved
+    void transform_axis(std::vector<double>& a, std::size_t outer, std::size_t n, std::size_t stride) {
+        if (n == 1) return;
+        std::vector<double> cosines(n * n), line(n), out(n);
+        for (std::size_t k = 0; k < n; k++)
+            for (std::size_t m = 0; m < n; m++)
+                cosines[k * n + m] = std::cos(kPi * static_cast<double>(k * m) / static_cast<double>(n - 1));
+
+        const double scale = 2.0 / static_cast<double>(n - 1);
+        for (std::size_t o = 0; o < outer; o++) {
+            for (std::size_t r = 0; r < stride; r++) {
+                double* base = a.data() + o * n * stride + r;
+                for (std::size_t m = 0; m < n; m++) line[m] = base[m * stride];
+                line[0] *= 0.5;
+                line[n - 1] *= 0.5;
+                for (std::size_t k = 0; k < n; k++) {
+                    double s = 0.0;
+                    for (std::size_t m = 0; m < n; m++) s += cosines[k * n + m] * line[m];
+                    out[k] = scale * s;
+                }
+                out[0] *= 0.5;
+                out[n - 1] *= 0.5;
+                for (std::size_t k = 0; k < n; k++) base[k * stride] = out[k];
+            }
+        }
+    }
+
+    // Runs fn(i) for i in [0, n) on up to n_threads threads pulling from a shared counter
+    template <typename Fn>
+    void parallel_for(std::size_t n, std::size_t n_threads, Fn fn) {
+        std::atomic<std::size_t> next{0};
+        auto worker = [&]() {
+            for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) fn(i);
+        };
+        if (n_threads == 0) n_threads = std::thread::hardware_concurrency();
+        n_threads = std::max<std::size_t>(1, std::min(n_threads, n));
+
+        std::vector<std::thread> pool;
+        for (std::size_t t = 1; t < n_threads; t++) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+    }
+
+    void put_double(std::ostringstream& os, double v) {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), " %a", v);
+        os << buf;
+    }
+
+    bool get_double(std::istringstream& is, double& v) {
+        std::string tok;
+        if (!(is >> tok)) return false;
+        char* end = nullptr;
+        v = std::strtod(tok.c_str(), &end);
+        return end == tok.c_str() + tok.size();
+    }
+}
+
+bool ChebyshevProxy::inDomain(double S, double sigma, double T) const {
+    double t;
+    return !empty() && to_unit(axes_[0], S, t) && to_unit(axes_[1], sigma, t) && to_unit(axes_[2], T, t);
+}
+
+void ChebyshevProxy::evaluate(double S, double sigma, double T, double& price, double& delta, double& gamma) const {
+    double s, v, u;
+    if (empty() || !to_unit(axes_[0], S, s) || !to_unit(axes_[1], sigma, v) || !to_unit(axes_[2], T, u)) {
+        price = delta = gamma = NAN;
+        return;
+    }
+    const std::size_t ns = axes_[0].nodes, nv = axes_[1].nodes, nt = axes_[2].nodes;
+    const std::size_t inner = nv * nt;
+    double Tv[kMaxNodes], Tt[kMaxNodes], w[kMaxInnerNodes];
+    chebyshev_values(v, nv, Tv);
+    chebyshev_values(u, nt, Tt);
+    for (std::size_t j = 0; j < nv; j++)
+        for (std::size_t k = 0; k < nt; k++) w[j * nt + k] = Tv[j] * Tt[k];
+
+    // Along spot: T_k, T_k' and T_k'' by their three-term recurrences
+    double p = 0.0, d = 0.0, g = 0.0;
+    double T0 = 1.0, T1 = s, D0 = 0.0, D1 = 1.0, G0 = 0.0, G1 = 0.0;
+    const double* c = coeffs_.data();
+    for (std::size_t i = 0; i < ns; i++) {
+        const double a = dot(c + i * inner, w, inner);
+
+        double Ti, Di, Gi;
+        if (i == 0) {
+            Ti = T0; Di = D0; Gi = G0;
+        } else if (i == 1) {
+            Ti = T1; Di = D1; Gi = G1;
+        } else {
+            Ti = 2.0 * s * T1 - T0;
+            Di = 2.0 * T1 + 2.0 * s * D1 - D0;
+            Gi = 4.0 * D1 + 2.0 * s * G1 - G0;
+            T0 = T1; T1 = Ti;
+            D0 = D1; D1 = Di;
+            G0 = G1; G1 = Gi;
+        }
+        p += a * Ti;
+        d += a * Di;
+        g += a * Gi;
+    }
+
+    const double dt_dS = 2.0 / (axes_[0].hi - axes_[0].lo);
+    price = p;
+    delta = d * dt_dS;
+    gamma = g * dt_dS * dt_dS;
+}
+
+double ChebyshevProxy::price(double S, double sigma, double T) const {
+    double p, d, g;
+    evaluate(S, sigma, T, p, d, g);
+    return p;
+}
+
+double ChebyshevProxy::delta(double S, double sigma, double T) const {
+    double p, d, g;
+    evaluate(S, sigma, T, p, d, g);
+    return d;
+}
+
+double ChebyshevProxy::gamma(double S, double sigma, double T) const {
+    double p, d, g;
+    evaluate(S, sigma, T, p, d, g);
+    return g;
+}
+
+double ChebyshevProxy::errorEstimate() const {
+    if (empty()) return NAN;
+    const std::size_t n[3] = {axes_[0].nodes, axes_[1].nodes, axes_[2].nodes};
+    double tail = 0.0;
+    for (std::size_t i = 0; i < n[0]; i++) {
+        for (std::size_t j = 0; j < n[1]; j++) {
+            for (std::size_t k = 0; k < n[2]; k++) {
+                const bool last = (n[0] > 1 && i == n[0] - 1) || (n[1] > 1 && j == n[1] - 1) ||
+                                  (n[2] > 1 && k == n[2] - 1);
+                if (last) tail += std::fabs(coeffs_[(i * n[1] + j) * n[2] + k]);
+            }
+        }
+    }
+    return tail;
+}
+
+ChebyshevProxy buildChebyshevProxy(const ProxyPricer& pricer, const ChebyshevAxis& spot,
+                                   const ChebyshevAxis& vol, const ChebyshevAxis& time,
+                                   const ProxyBuildOptions& opts, ProxyAccuracy* accuracy) {
+    ChebyshevProxy proxy;
+    if (!pricer || !valid_grid(spot, vol, time)) return proxy;
+
+    const std::size_t ns = spot.nodes, nv = vol.nodes, nt = time.nodes;
+    std::vector<double> values(ns * nv * nt);
+    std::atomic<bool> finite{true};
+    parallel_for(values.size(), opts.n_threads, [&](std::size_t idx) {
+        const std::size_t k = idx % nt, j = (idx / nt) % nv, i = idx / (nt * nv);
+        values[idx] = pricer(node(spot, i), node(vol, j), node(time, k));
+        if (!std::isfinite(values[idx])) finite.store(false);
+    });
+    if (!finite.load()) return proxy;
+
+    transform_axis(values, 1, ns, nv * nt);
+    transform_axis(values, ns, nv, nt);
+    transform_axis(values, ns * nv, nt, 1);
+
+    proxy.axes_[0] = spot;
+    proxy.axes_[1] = vol;
+    proxy.axes_[2] = time;
+    proxy.coeffs_ = std::move(values);
+
+    if (accuracy) {
+        ProxyAccuracy acc;
+        acc.points = opts.test_points;
+        acc.tail_estimate = proxy.errorEstimate();
+        acc.pricer_calls = ns * nv * nt + opts.test_points;
+
+        // Points drawn up front so the report does not depend on thread timing
+        std::vector<double> pts(3 * opts.test_points), err(opts.test_points), ref(opts.test_points);
+        std::uint64_t state = opts.seed;
+        const ChebyshevAxis* axes[3] = {&spot, &vol, &time};
+        for (std::size_t p = 0; p < opts.test_points; p++) {
+            for (std::size_t d = 0; d < 3; d++) {
+                const ChebyshevAxis& a = *axes[d];
+                const double u = rand_uniform_01(state);
+                pts[3 * p + d] = (a.nodes == 1) ? a.lo : std::min(a.lo + u * (a.hi - a.lo), a.hi);
+            }
+        }
+        parallel_for(opts.test_points, opts.n_threads, [&](std::size_t p) {
+            ref[p] = pricer(pts[3 * p], pts[3 * p + 1], pts[3 * p + 2]);
+            err[p] = proxy.price(pts[3 * p], pts[3 * p + 1], pts[3 * p + 2]) - ref[p];
+        });
+
+        double sum2 = 0.0;
+        for (std::size_t p = 0; p < opts.test_points; p++) {
+            const double e = std::fabs(err[p]);
+            acc.max_abs_error = std::max(acc.max_abs_error, e);
+            acc.max_rel_error = std::max(acc.max_rel_error, e / std::max(std::fabs(ref[p]), 1e-8));
+            sum2 += e * e;
+        }
+        acc.rms_error = opts.test_points ? std::sqrt(sum2 / static_cast<double>(opts.test_points)) : 0.0;
+        *accuracy = acc;
+    }
+    return proxy;
+}
+
+std::string serializeChebyshevProxy(const ChebyshevProxy& proxy) {
+    std::ostringstream os;
+    os << kMagic << ' ' << kFormatVersion << '\n';
+    for (std::size_t d = 0; d < 3; d++) {
+        const ChebyshevAxis& a = proxy.axis(d);
+        os << "axis";
+        put_double(os, a.lo);
+        put_double(os, a.hi);
+        os << ' ' << a.nodes << '\n';
+    }
+    os << "coeffs " << proxy.coefficients().size() << '\n';
+    for (double c : proxy.coefficients()) {
+        put_double(os, c);
+        os << '\n';
+    }
+    return os.str();
+}
+
+bool parseChebyshevProxy(const std::string& text, ChebyshevProxy& out) {
+    std::istringstream is(text);
+    std::string word;
+    int version = 0;
+    if (!(is >> word >> version) || word != kMagic || version != kFormatVersion) return false;
+
+    ChebyshevProxy p;
+    for (std::size_t d = 0; d < 3; d++) {
+        ChebyshevAxis& a = p.axes_[d];
+        if (!(is >> word) || word != "axis" || !get_double(is, a.lo) || !get_double(is, a.hi) ||
+            !(is >> a.nodes) || !valid_axis(a)) return false;
+    }
+    std::size_t count = 0;
+    if (!(is >> word >> count) || word != "coeffs") return false;
+    if (!valid_grid(p.axes_[0], p.axes_[1], p.axes_[2]) ||
+        count != p.axes_[0].nodes * p.axes_[1].nodes * p.axes_[2].nodes) return false;
+
+    p.coeffs_.resize(count);
+    for (double& c : p.coeffs_) {
+        if (!get_double(is, c)) return false;
+    }
+    out = std::move(p);
+    return true;
+}
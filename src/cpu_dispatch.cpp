@@ -0,0 +1,570 @@
+// cpu_dispatch.cpp
+
+#include "cpu_dispatch.h"
+#include "simd_math.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Each kernel body below is written once and force-inlined into one entry
+// point per ISA level; the target attribute of the entry point decides the
+// vector width the loop is compiled for.
+#if defined(__GNUC__)
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE inline
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PRICER_X86_DISPATCH 1
+#define TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma")))
+#endif
+
+namespace {
+    // Same rational / continued-fraction pair as normal_cdf_batch documents
+    KERNEL_INLINE double cdf(double x) {
+        const double a = std::fabs(x);
+        const double e = simd_math::exp(-0.5 * a * a);
+
+        double num = 3.52624965998911e-02 * a + 0.700383064443688;
+        num = num * a + 6.37396220353165;
+        num = num * a + 33.912866078383;
+        num = num * a + 112.079291497871;
+        num = num * a + 221.213596169931;
+        num = num * a + 220.206867912376;
+        double den = 8.83883476483184e-02 * a + 1.75566716318264;
+        den = den * a + 16.064177579207;
+        den = den * a + 86.7807322029461;
+        den = den * a + 296.564248779674;
+        den = den * a + 637.333633378831;
+        den = den * a + 793.826512519948;
+        den = den * a + 440.413735824752;
+        const double near = e * num / den;
+
+        double cf = a + 0.65;
+        cf = a + 4.0 / cf;
+        cf = a + 3.0 / cf;
+        cf = a + 2.0 / cf;
+        cf = a + 1.0 / cf;
+        const double far = e / cf / 2.506628274631;
+
+        const double tail = (a < 7.07106781186547) ? near : far;
+        return (x > 0.0) ? 1.0 - tail : tail;
+    }
+
+    KERNEL_INLINE void normal_cdf_body(const double* x, double* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) out[i] = cdf(x[i]);
+    }
+
+    // splitmix64 output mapped to (0, 1] exactly as rand_uniform_01 does; the
+    // 53-bit integer is converted through two exact 32-bit halves because
+    // AVX2 has no 64-bit integer to double conversion.
+    KERNEL_INLINE double uniform_at(std::uint64_t x) {
+        std::uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+
+        const std::uint64_t m = z >> 11;
+        const double lo = simd_math::from_bits(0x4330000000000000ull | (m & 0xffffffffull)) - 4503599627370496.0;
+        const double hi = simd_math::from_bits(0x4530000000000000ull | (m >> 32)) - 19342813113834066795298816.0;
+        return ((hi + lo) + 1.0) * (1.0 / 9007199254740992.0);
+    }
+
+    KERNEL_INLINE void normal_fill_body(std::uint64_t state, double* out, std::size_t n) {
+        const std::uint64_t g = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < n; i++) {
+            const std::uint64_t base = state + 2u * static_cast<std::uint64_t>(i) * g;
+            const double u1 = uniform_at(base + g);
+            const double u2 = uniform_at(base + 2u * g);
+            out[i] = std::sqrt(-2.0 * simd_math::log(u1)) * simd_math::cos2pi(u2);
+        }
+    }
+
+    // Single precision: the top 24 bits of the same splitmix64 output, mapped
+    // to (0, 1] exactly; a 32-bit integer converts natively at every level
+    KERNEL_INLINE float uniform_at_f(std::uint64_t x) {
+        std::uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+
+        const std::int32_t m = static_cast<std::int32_t>(z >> 40);
+        return (static_cast<float>(m) + 1.0f) * (1.0f / 16777216.0f);
+    }
+
+    KERNEL_INLINE void normal_fill_f_body(std::uint64_t state, float* out, std::size_t n) {
+        const std::uint64_t g = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < n; i++) {
+            const std::uint64_t base = state + 2u * static_cast<std::uint64_t>(i) * g;
+            const float u1 = uniform_at_f(base + g);
+            const float u2 = uniform_at_f(base + 2u * g);
+            out[i] = std::sqrt(-2.0f * simd_math::log(u1)) * simd_math::cos2pi(u2);
+        }
+    }
+
+    KERNEL_INLINE void bs_price_body(bool is_call, const double* S, const double* K, const double* T,
+                                     const double* r, const double* sigma, double* out, std::size_t n) {
+        const double sign = is_call ? 1.0 : -1.0;
+        for (std::size_t i = 0; i < n; i++) {
+            const double vol_sqrtT = sigma[i] * std::sqrt(T[i]);
+            const double d1 = (simd_math::log(S[i] / K[i]) + (r[i] + 0.5 * sigma[i] * sigma[i]) * T[i]) / vol_sqrtT;
+            const double d2 = d1 - vol_sqrtT;
+            const double df = simd_math::exp(-r[i] * T[i]);
+
+            // call: S N(d1) - K df N(d2); put: K df N(-d2) - S N(-d1)
+            out[i] = sign * (S[i] * cdf(sign * d1) - K[i] * df * cdf(sign * d2));
+        }
+    }
+
+    // Shifted draws Z + shift carry the likelihood ratio exp(-shift Z - shift^2 / 2);
+    // the antithetic leg reflects about the shifted mean (shift - Z). Real is
+    // double, or float for the single-precision engine.
+    template <typename Real, bool Call, bool Anti, bool Shift>
+    KERNEL_INLINE void mc_paths_loop(const Real* Z, std::size_t n, Real S, Real K, Real drift,
+                                     Real vol_sqrtT, Real df, Real shift, Real* X, Real* Y) {
+        const Real zero = Real(0);
+        const Real half_shift2 = Real(0.5) * shift * shift;
+        for (std::size_t i = 0; i < n; i++) {
+            const Real z1 = Shift ? shift + Z[i] : Z[i];
+            const Real w1 = Shift ? simd_math::exp(-shift * Z[i] - half_shift2) : Real(1);
+            const Real ST1 = S * simd_math::exp(drift + vol_sqrtT * z1);
+            Real x = df * (Call ? std::max(ST1 - K, zero) : std::max(K - ST1, zero));
+            Real y = df * ST1;
+            if (Shift) {
+                x *= w1;
+                y *= w1;
+            }
+
+            if (Anti) {
+                const Real z2 = Shift ? shift - Z[i] : -Z[i];
+                const Real ST2 = S * simd_math::exp(drift + vol_sqrtT * z2);
+                Real x2 = df * (Call ? std::max(ST2 - K, zero) : std::max(K - ST2, zero));
+                Real y2 = df * ST2;
+                if (Shift) {
+                    const Real w2 = simd_math::exp(shift * Z[i] - half_shift2);
+                    x2 *= w2;
+                    y2 *= w2;
+                }
+
+                x = Real(0.5) * (x + x2);
+                y = Real(0.5) * (y + y2);
+            }
+
+            X[i] = x;
+            Y[i] = y;
+        }
+    }
+
+    template <typename Real, bool Call>
+    KERNEL_INLINE void mc_paths_payoff(const Real* Z, std::size_t n, Real S, Real K, Real drift,
+                                       Real vol_sqrtT, Real df, bool anti, Real shift,
+                                       Real* X, Real* Y) {
+        if (shift != Real(0)) {
+            if (anti) mc_paths_loop<Real, Call, true, true>(Z, n, S, K, drift, vol_sqrtT, df, shift, X, Y);
+            else      mc_paths_loop<Real, Call, false, true>(Z, n, S, K, drift, vol_sqrtT, df, shift, X, Y);
+        } else {
+            if (anti) mc_paths_loop<Real, Call, true, false>(Z, n, S, K, drift, vol_sqrtT, df, Real(0), X, Y);
+            else      mc_paths_loop<Real, Call, false, false>(Z, n, S, K, drift, vol_sqrtT, df, Real(0), X, Y);
+        }
+    }
+
+    template <typename Real>
+    KERNEL_INLINE void mc_paths_body(const Real* Z, std::size_t n, Real S, Real K, Real drift,
+                                     Real vol_sqrtT, Real df, bool anti, bool is_call, Real shift,
+                                     Real* X, Real* Y) {
+        if (is_call) mc_paths_payoff<Real, true>(Z, n, S, K, drift, vol_sqrtT, df, anti, shift, X, Y);
+        else         mc_paths_payoff<Real, false>(Z, n, S, K, drift, vol_sqrtT, df, anti, shift, X, Y);
+    }
+
+    KERNEL_INLINE void correlate_body(const double* A, std::size_t dim, bool lower, const double* Z,
+                                      std::size_t n, double* W) {
+        for (std::size_t i = 0; i < dim; i++) {
+            const double* a = A + i * dim;
+            double* w = W + i * n;
+            const std::size_t cols = lower ? i + 1 : dim;
+            for (std::size_t p = 0; p < n; p++) w[p] = a[0] * Z[p];
+            for (std::size_t j = 1; j < cols; j++) {
+                const double aj = a[j];
+                const double* z = Z + j * n;
+                for (std::size_t p = 0; p < n; p++) w[p] += aj * z[p];
+            }
+        }
+    }
+
+    KERNEL_INLINE void basket_paths_body(const double* W, std::size_t dim, std::size_t n, const double* log_mean,
+                                         const double* vol_sqrtT, const double* weights, const double* geo_weights,
+                                         double sign, double* sum, double* best, double* worst, double* log_geo) {
+        for (std::size_t p = 0; p < n; p++) {
+            sum[p] = 0.0;
+            best[p] = -HUGE_VAL;
+            worst[p] = HUGE_VAL;
+            log_geo[p] = 0.0;
+        }
+        for (std::size_t i = 0; i < dim; i++) {
+            const double m = log_mean[i], v = sign * vol_sqrtT[i], w = weights[i], a = geo_weights[i];
+            const double* row = W + i * n;
+            for (std::size_t p = 0; p < n; p++) {
+                const double x = m + v * row[p];
+                const double s = w * simd_math::exp(x);
+                sum[p] += s;
+                best[p] = std::max(best[p], s);
+                worst[p] = std::min(worst[p], s);
+                log_geo[p] += a * x;
+            }
+        }
+    }
+
+    KERNEL_INLINE void gbm_step_body(double* S, const double* Z, std::size_t n, double drift, double vol) {
+        for (std::size_t i = 0; i < n; i++) S[i] *= simd_math::exp(drift + vol * Z[i]);
+    }
+
+    template <bool Price>
+    KERNEL_INLINE void bs_price_delta_loop(double sign, const double* S, std::size_t n, double K, double tau,
+                                           double r, double sigma, double* price, double* delta) {
+        const double vol_sqrtT = sigma * std::sqrt(tau);
+        const double carry = (r + 0.5 * sigma * sigma) * tau;
+        const double K_df = K * simd_math::exp(-r * tau);
+        const double put_shift = sign > 0.0 ? 0.0 : -1.0;
+        for (std::size_t i = 0; i < n; i++) {
+            const double d1 = (simd_math::log(S[i] / K) + carry) / vol_sqrtT;
+            const double n1 = cdf(d1);
+            delta[i] = n1 + put_shift;
+            if (Price) {
+                const double d2 = d1 - vol_sqrtT;
+                price[i] = sign * (S[i] * cdf(sign * d1) - K_df * cdf(sign * d2));
+            }
+        }
+    }
+
+    KERNEL_INLINE void bs_price_delta_body(bool is_call, const double* S, std::size_t n, double K, double tau,
+                                           double r, double sigma, double* price, double* delta) {
+        const double sign = is_call ? 1.0 : -1.0;
+        if (price) bs_price_delta_loop<true>(sign, S, n, K, tau, r, sigma, price, delta);
+        else       bs_price_delta_loop<false>(sign, S, n, K, tau, r, sigma, price, delta);
+    }
+
+    // Partial sums of the block moments run in kMomentLanes lanes with the
+    // same per-lane order (hence bits) at every ISA level, held as pairs: a
+    // 16-byte vector is native to every level, and GCC keeps several
+    // lane-array reductions in registers only as vector types.
+    constexpr std::size_t kMomentPairs = 2;
+    constexpr std::size_t kMomentLanes = 2 * kMomentPairs;
+#if defined(__GNUC__)
+    typedef double LanePair __attribute__((vector_size(2 * sizeof(double))));
+#else
+    struct LanePair {
+        double v[2];
+        double operator[](std::size_t k) const { return v[k]; }
+        LanePair operator-(double m) const { return {{v[0] - m, v[1] - m}}; }
+        LanePair operator*(const LanePair& o) const { return {{v[0] * o.v[0], v[1] * o.v[1]}}; }
+        LanePair& operator+=(const LanePair& o) {
+            v[0] += o.v[0];
+            v[1] += o.v[1];
+            return *this;
+        }
+    };
+#endif
+
+    KERNEL_INLINE LanePair load_pair(const double* x) {
+        LanePair v;
+        std::memcpy(&v, x, sizeof v);
+        return v;
+    }
+
+    KERNEL_INLINE double lane_total(const LanePair (&a)[kMomentPairs]) {
+        return (a[0][0] + a[0][1]) + (a[1][0] + a[1][1]);
+    }
+
+    // Pass 1 gives the mean m, pass 2 sums d = x - m; sum d is zero up to the
+    // rounding of m and corrects both the mean and sum d^2. The n % lanes
+    // tail is summed separately.
+    KERNEL_INLINE void block_moments_body(const double* X, const double* Y, std::size_t n, double* out) {
+        constexpr std::size_t P = kMomentPairs, L = kMomentLanes;
+        const std::size_t body = n - n % L;
+        const double dn = static_cast<double>(n);
+
+        if (!Y) {
+            LanePair s[P] = {};
+            double ts = 0.0;
+            for (std::size_t i = 0; i < body; i += L) {
+                for (std::size_t j = 0; j < P; j++) s[j] += load_pair(X + i + 2 * j);
+            }
+            for (std::size_t i = body; i < n; i++) ts += X[i];
+            const double m = (lane_total(s) + ts) / dn;
+
+            LanePair sd[P] = {}, sdd[P] = {};
+            double td = 0.0, tdd = 0.0;
+            for (std::size_t i = 0; i < body; i += L) {
+                for (std::size_t j = 0; j < P; j++) {
+                    const LanePair d = load_pair(X + i + 2 * j) - m;
+                    sd[j] += d;
+                    sdd[j] += d * d;
+                }
+            }
+            for (std::size_t i = body; i < n; i++) {
+                const double d = X[i] - m;
+                td += d;
+                tdd += d * d;
+            }
+            const double e = lane_total(sd) + td;
+            out[0] = m + e / dn;
+            out[1] = std::max(lane_total(sdd) + tdd - e * e / dn, 0.0);
+            return;
+        }
+
+        LanePair sx[P] = {}, sy[P] = {};
+        double tx = 0.0, ty = 0.0;
+        for (std::size_t i = 0; i < body; i += L) {
+            for (std::size_t j = 0; j < P; j++) {
+                sx[j] += load_pair(X + i + 2 * j);
+                sy[j] += load_pair(Y + i + 2 * j);
+            }
+        }
+        for (std::size_t i = body; i < n; i++) {
+            tx += X[i];
+            ty += Y[i];
+        }
+        const double mx = (lane_total(sx) + tx) / dn, my = (lane_total(sy) + ty) / dn;
+
+        LanePair dx[P] = {}, dy[P] = {}, dxx[P] = {}, dyy[P] = {}, dxy[P] = {};
+        for (std::size_t i = 0; i < body; i += L) {
+            for (std::size_t j = 0; j < P; j++) {
+                const LanePair a = load_pair(X + i + 2 * j) - mx, b = load_pair(Y + i + 2 * j) - my;
+                dx[j] += a; dy[j] += b;
+                dxx[j] += a * a; dyy[j] += b * b; dxy[j] += a * b;
+            }
+        }
+        double t[5] = {};
+        for (std::size_t i = body; i < n; i++) {
+            const double a = X[i] - mx, b = Y[i] - my;
+            t[0] += a; t[1] += b;
+            t[2] += a * a; t[3] += b * b; t[4] += a * b;
+        }
+        const double ex = lane_total(dx) + t[0], ey = lane_total(dy) + t[1];
+        out[0] = mx + ex / dn;
+        out[1] = my + ey / dn;
+        out[2] = std::max(lane_total(dxx) + t[2] - ex * ex / dn, 0.0);
+        out[3] = std::max(lane_total(dyy) + t[3] - ey * ey / dn, 0.0);
+        out[4] = lane_total(dxy) + t[4] - ex * ey / dn;
+    }
+
+    // Andersen (2008). Both QE branches are evaluated for every path and
+    // one selected, so the loop vectorizes: quadratic V' = a (b + Zv)^2,
+    // exponential V' = 0 if U <= p else log((1 - p) / (1 - U)) / beta. The
+    // martingale correction replaces K0 by K0* = -log E[e^{A V'} | V]
+    // - (K1 + K3 / 2) V with A = K2 + K4 / 2, where that expectation is
+    // finite (2 A a < 1, resp. A < beta); both branches share one log, as
+    // GCC does not if-convert a select between two. The coefficients are
+    // copied to locals: loads through `c` could alias the outputs.
+    template <bool Martingale, bool Sum>
+    KERNEL_INLINE void heston_qe_loop(const HestonStepCoeffs& c, double sign, const double* Zv, const double* Zx,
+                                      std::size_t n, double* V, double* log_S, double* sum) {
+        const double theta = c.theta, e_kdt = c.e_kdt, s2_v = c.s2_v, s2_c = c.s2_c, psi_c = c.psi_c;
+        const double drift = c.drift, K0 = c.drift + c.K0, K1 = c.K1, K2 = c.K2, K3 = c.K3, K4 = c.K4;
+        const double A = K2 + 0.5 * K4, K13 = K1 + 0.5 * K3;
+        for (std::size_t i = 0; i < n; i++) {
+            const double v = V[i], zv = sign * Zv[i], zx = sign * Zx[i];
+            const double m = theta + (v - theta) * e_kdt;
+            const double psi = (v * s2_v + s2_c) / (m * m);
+            const bool quadratic = psi <= psi_c;
+
+            const double inv = 2.0 / psi;
+            const double b2 = inv - 1.0 + std::sqrt(inv) * std::sqrt(std::max(inv - 1.0, 0.0));
+            const double a = m / (1.0 + b2);
+            const double bz = std::sqrt(std::max(b2, 0.0)) + zv;
+            const double v_quad = a * bz * bz;
+
+            const double p = (psi - 1.0) / (psi + 1.0);
+            const double beta = (1.0 - p) / m;
+            const double tail = cdf(-zv);
+            const double v_exp = (tail >= 1.0 - p) ? 0.0 : simd_math::log((1.0 - p) / tail) / beta;
+            const double vn = quadratic ? v_quad : v_exp;
+
+            double k0 = K0;
+            if (Martingale) {
+                // log E[e^{A V'}]: -log(q) / 2 + A b^2 a / q, resp. log(mgf_exp)
+                const double q = 1.0 - 2.0 * A * a;
+                const double mgf_exp = p + beta * (1.0 - p) / (beta - A);
+                const double lg = simd_math::log(quadratic ? q : mgf_exp);
+                const double log_mgf = quadratic ? A * b2 * a / q - 0.5 * lg : lg;
+                const double finite = quadratic ? q : beta - A;
+                k0 = (finite > 0.0) ? drift - log_mgf - K13 * v : K0;
+            }
+            const double x = log_S[i] + k0 + K1 * v + K2 * vn + std::sqrt(K3 * v + K4 * vn) * zx;
+            V[i] = vn;
+            log_S[i] = x;
+            if (Sum) sum[i] += simd_math::exp(x);
+        }
+    }
+
+    template <bool Sum>
+    KERNEL_INLINE void heston_euler_loop(const HestonStepCoeffs& c, double sign, const double* Zv, const double* Zx,
+                                         std::size_t n, double* V, double* log_S, double* sum) {
+        const double drift = c.drift, half_dt = 0.5 * c.dt, sqrt_dt = c.sqrt_dt, rho = c.rho, rho_bar = c.rho_bar;
+        const double theta = c.theta, kappa_dt = c.kappa_dt, xi_sqrt_dt = c.xi_sqrt_dt;
+        for (std::size_t i = 0; i < n; i++) {
+            const double zv = sign * Zv[i], zx = sign * Zx[i];
+            const double vp = std::max(V[i], 0.0);
+            const double sv = std::sqrt(vp);
+            const double x = log_S[i] + drift - half_dt * vp + sv * sqrt_dt * (rho * zv + rho_bar * zx);
+            V[i] = V[i] + kappa_dt * (theta - vp) + xi_sqrt_dt * sv * zv;
+            log_S[i] = x;
+            if (Sum) sum[i] += simd_math::exp(x);
+        }
+    }
+
+    KERNEL_INLINE void heston_step_body(const HestonStepCoeffs& c, double sign, const double* Zv, const double* Zx,
+                                        std::size_t n, double* V, double* log_S, double* sum) {
+        if (!c.qe) {
+            if (sum) heston_euler_loop<true>(c, sign, Zv, Zx, n, V, log_S, sum);
+            else     heston_euler_loop<false>(c, sign, Zv, Zx, n, V, log_S, sum);
+        } else if (c.martingale) {
+            if (sum) heston_qe_loop<true, true>(c, sign, Zv, Zx, n, V, log_S, sum);
+            else     heston_qe_loop<true, false>(c, sign, Zv, Zx, n, V, log_S, sum);
+        } else {
+            if (sum) heston_qe_loop<false, true>(c, sign, Zv, Zx, n, V, log_S, sum);
+            else     heston_qe_loop<false, false>(c, sign, Zv, Zx, n, V, log_S, sum);
+        }
+    }
+
+// One set of entry points per ISA level
+#define DEFINE_KERNELS(SUFFIX, ATTR)                                                              \
+    ATTR void normal_cdf_##SUFFIX(const double* x, double* out, std::size_t n) {                  \
+        normal_cdf_body(x, out, n);                                                               \
+    }                                                                                             \
+    ATTR void normal_fill_##SUFFIX(std::uint64_t state, double* out, std::size_t n) {             \
+        normal_fill_body(state, out, n);                                                          \
+    }                                                                                             \
+    ATTR void bs_price_##SUFFIX(bool is_call, const double* S, const double* K, const double* T,  \
+                                const double* r, const double* sigma, double* out, std::size_t n) { \
+        bs_price_body(is_call, S, K, T, r, sigma, out, n);                                        \
+    }                                                                                             \
+    ATTR void mc_paths_##SUFFIX(const double* Z, std::size_t n, double S, double K, double drift, \
+                                double vol_sqrtT, double df, bool anti, bool is_call,             \
+                                double shift, double* X, double* Y) {                             \
+        mc_paths_body(Z, n, S, K, drift, vol_sqrtT, df, anti, is_call, shift, X, Y);              \
+    }                                                                                             \
+    ATTR void correlate_##SUFFIX(const double* A, std::size_t dim, bool lower, const double* Z,   \
+                                 std::size_t n, double* W) {                                      \
+        correlate_body(A, dim, lower, Z, n, W);                                                   \
+    }                                                                                             \
+    ATTR void basket_paths_##SUFFIX(const double* W, std::size_t dim, std::size_t n,              \
+                                    const double* log_mean, const double* vol_sqrtT,              \
+                                    const double* weights, const double* geo_weights,             \
+                                    double sign, double* sum, double* best, double* worst,        \
+                                    double* log_geo) {                                            \
+        basket_paths_body(W, dim, n, log_mean, vol_sqrtT, weights, geo_weights, sign,             \
+                          sum, best, worst, log_geo);                                             \
+    }                                                                                             \
+    ATTR void gbm_step_##SUFFIX(double* S, const double* Z, std::size_t n, double drift,          \
+                                double vol) {                                                     \
+        gbm_step_body(S, Z, n, drift, vol);                                                       \
+    }                                                                                             \
+    ATTR void bs_price_delta_##SUFFIX(bool is_call, const double* S, std::size_t n, double K,     \
+                                      double tau, double r, double sigma, double* price,          \
+                                      double* delta) {                                            \
+        bs_price_delta_body(is_call, S, n, K, tau, r, sigma, price, delta);                       \
+    }                                                                                             \
+    ATTR void block_moments_##SUFFIX(const double* X, const double* Y, std::size_t n,            \
+                                     double* out) {                                               \
+        block_moments_body(X, Y, n, out);                                                         \
+    }                                                                                             \
+    ATTR void heston_step_##SUFFIX(const HestonStepCoeffs& c, double sign, const double* Zv,      \
+                                   const double* Zx, std::size_t n, double* V, double* log_S,     \
+                                   double* sum) {                                                 \
+        heston_step_body(c, sign, Zv, Zx, n, V, log_S, sum);                                      \
+    }                                                                                             \
+    ATTR void normal_fill_f_##SUFFIX(std::uint64_t state, float* out, std::size_t n) {            \
+        normal_fill_f_body(state, out, n);                                                        \
+    }                                                                                             \
+    ATTR void mc_paths_f_##SUFFIX(const float* Z, std::size_t n, float S, float K, float drift,   \
+                                  float vol_sqrtT, float df, bool anti, bool is_call,             \
+                                  float shift, float* X, float* Y) {                              \
+        mc_paths_body(Z, n, S, K, drift, vol_sqrtT, df, anti, is_call, shift, X, Y);              \
+    }                                                                                             \
+    const KernelTable table_##SUFFIX = {normal_cdf_##SUFFIX, normal_fill_##SUFFIX,               \
+                                        bs_price_##SUFFIX, mc_paths_##SUFFIX,                     \
+                                        correlate_##SUFFIX, basket_paths_##SUFFIX,                \
+                                        gbm_step_##SUFFIX, bs_price_delta_##SUFFIX,               \
+                                        block_moments_##SUFFIX, heston_step_##SUFFIX,             \
+                                        normal_fill_f_##SUFFIX, mc_paths_f_##SUFFIX};
+
+    DEFINE_KERNELS(generic, )
+#ifdef PRICER_X86_DISPATCH
+    DEFINE_KERNELS(avx2, TARGET_AVX2)
+    DEFINE_KERNELS(avx512, TARGET_AVX512)
+#endif
+
+    const KernelTable& table_for(IsaLevel level) {
+#ifdef PRICER_X86_DISPATCH
+        if (level == IsaLevel::AVX512) return table_avx512;
+        if (level == IsaLevel::AVX2) return table_avx2;
+#endif
+        (void)level;
+        return table_generic;
+    }
+
+    IsaLevel detect() {
+#ifdef PRICER_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return IsaLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return IsaLevel::AVX2;
+#endif
+        return IsaLevel::Generic;
+    }
+
+    IsaLevel initial_level() {
+        const IsaLevel best = detectedIsa();
+        const char* env = std::getenv("PRICER_ISA");
+        if (!env) return best;
+
+        IsaLevel want = best;
+        if (std::strcmp(env, "generic") == 0) want = IsaLevel::Generic;
+        else if (std::strcmp(env, "avx2") == 0) want = IsaLevel::AVX2;
+        else if (std::strcmp(env, "avx512") == 0) want = IsaLevel::AVX512;
+        return std::min(want, best);
+    }
+
+    std::atomic<const KernelTable*>& active_table() {
+        static std::atomic<const KernelTable*> table{&table_for(initial_level())};
+        return table;
+    }
+
+    std::atomic<IsaLevel>& active_level() {
+        static std::atomic<IsaLevel> level{initial_level()};
+        return level;
+    }
+}
+
+const char* isaName(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::AVX512: return "avx512";
+        case IsaLevel::AVX2:   return "avx2";
+        default:               return "generic";
+    }
+}
+
+IsaLevel detectedIsa() {
+    static const IsaLevel level = detect();
+    return level;
+}
+
+IsaLevel activeIsa() {
+    return active_level().load();
+}
+
+bool setActiveIsa(IsaLevel level) {
+    if (level > detectedIsa()) return false;
+    active_level().store(level);
+    active_table().store(&table_for(level));
+    return true;
+}
+
+const KernelTable& kernels() {
+    return *active_table().load(std::memory_order_acquire);
+}
@@ -0,0 +1,240 @@
+// fourier.cpp
+
+#include "fourier.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    using cd = std::complex<double>;
+
+    constexpr double PI = 3.14159265358979323846;
+
+    inline bool is_pow2(std::size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+    // In-place iterative radix-2 FFT, X_k = sum_j x_j exp(-2 pi i jk/N)
+    void fft(std::vector<cd>& a) {
+        const std::size_t n = a.size();
+        for (std::size_t i = 1, j = 0; i < n; i++) {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+        for (std::size_t len = 2; len <= n; len <<= 1) {
+            const double ang = -2.0 * PI / static_cast<double>(len);
+            const cd wlen(std::cos(ang), std::sin(ang));
+            for (std::size_t i = 0; i < n; i += len) {
+                cd w(1.0, 0.0);
+                for (std::size_t k = 0; k < len / 2; k++) {
+                    const cd u = a[i + k];
+                    const cd v = a[i + k + len / 2] * w;
+                    a[i + k] = u + v;
+                    a[i + k + len / 2] = u - v;
+                    w *= wlen;
+                }
+            }
+        }
+    }
+
+    // Albrecher et al. "little trap" formulation (no branch-cut discontinuity)
+    cd heston_cf(cd u, double T, double r, const HestonParams& p) {
+        const cd i(0.0, 1.0);
+        const double xi2 = p.xi * p.xi;
+        const cd beta = p.kappa - p.rho * p.xi * i * u;
+        const cd d = std::sqrt(beta * beta + xi2 * (i * u + u * u));
+        const cd g = (beta - d) / (beta + d);
+        const cd edT = std::exp(-d * T);
+        const cd C = i * u * r * T
+                   + (p.kappa * p.theta / xi2) * ((beta - d) * T - 2.0 * std::log((1.0 - g * edT) / (1.0 - g)));
+        const cd D = ((beta - d) / xi2) * ((1.0 - edT) / (1.0 - g * edT));
+        return std::exp(C + D * p.v0);
+    }
+
+    // chi_k and psi_k cosine coefficients of e^y and 1 on [c,d] within [a,b]
+    inline double cos_chi(double w, double a, double c, double d) {
+        const double ed = std::exp(d), ec = std::exp(c);
+        return (std::cos(w * (d - a)) * ed - std::cos(w * (c - a)) * ec
+                + w * std::sin(w * (d - a)) * ed - w * std::sin(w * (c - a)) * ec) / (1.0 + w * w);
+    }
+
+    inline double cos_psi(double w, double a, double c, double d) {
+        if (w == 0.0) return d - c;
+        return (std::sin(w * (d - a)) - std::sin(w * (c - a))) / w;
+    }
+
+    inline bool chain_inputs_ok(const CharFn& cf, double S) {
+        return S > 0.0 && cf.T > 0.0 && std::isfinite(cf.r);
+    }
+}
+
+std::complex<double> CharFn::operator()(std::complex<double> u) const {
+    if (model == Model::Heston) return heston_cf(u, T, r, heston);
+
+    const cd i(0.0, 1.0);
+    const double var = sigma * sigma * T;
+    return std::exp(i * u * ((r - 0.5 * sigma * sigma) * T) - 0.5 * var * u * u);
+}
+
+void CharFn::cumulants(double& c1, double& c2, double& c4) const {
+    if (model == Model::BlackScholes) {
+        c1 = (r - 0.5 * sigma * sigma) * T;
+        c2 = sigma * sigma * T;
+        c4 = 0.0;
+        return;
+    }
+
+    // Fang & Oosterlee (2008), Heston cumulants; c4 is dropped as in their setup
+    const double k = heston.kappa, th = heston.theta, xi = heston.xi, rho = heston.rho, v0 = heston.v0;
+    const double e1 = std::exp(-k * T);
+    c1 = r * T + (1.0 - e1) * (th - v0) / (2.0 * k) - 0.5 * th * T;
+    c2 = (xi * T * k * e1 * (v0 - th) * (8.0 * k * rho - 4.0 * xi)
+          + k * rho * xi * (1.0 - e1) * (16.0 * th - 8.0 * v0)
+          + 2.0 * th * k * T * (-4.0 * k * rho * xi + xi * xi + 4.0 * k * k)
+          + xi * xi * ((th - 2.0 * v0) * std::exp(-2.0 * k * T) + th * (6.0 * e1 - 7.0) + 2.0 * v0)
+          + 8.0 * k * k * (v0 - th) * (1.0 - e1)) / (8.0 * k * k * k);
+    if (!std::isfinite(c2) || c2 <= 0.0) c2 = std::max(v0, th) * T;
+    c4 = 0.0;
+}
+
+CharFn bsCharFn(double T, double r, double sigma) {
+    CharFn cf;
+    cf.model = CharFn::Model::BlackScholes;
+    cf.T = T;
+    cf.r = r;
+    cf.sigma = sigma;
+    return cf;
+}
+
+CharFn hestonCharFn(double T, double r, const HestonParams& p) {
+    CharFn cf;
+    cf.model = CharFn::Model::Heston;
+    cf.T = T;
+    cf.r = r;
+    cf.heston = p;
+    return cf;
+}
+
+std::vector<double> cosPutPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                 std::size_t n_terms, double L) {
+    std::vector<double> out(strikes.size(), NAN);
+    if (!chain_inputs_ok(cf, S) || n_terms < 2 || strikes.empty()) return out;
+
+    // One truncation range shared by all strikes so the CF and payoff
+    // coefficients are computed once for the whole chain.
+    double xmin = INFINITY, xmax = -INFINITY;
+    for (double K : strikes) {
+        if (!(K > 0.0)) continue;
+        const double x = std::log(S / K);
+        xmin = std::min(xmin, x);
+        xmax = std::max(xmax, x);
+    }
+    if (!(xmin <= xmax)) return out;
+
+    double c1, c2, c4;
+    cf.cumulants(c1, c2, c4);
+    const double width = L * std::sqrt(c2 + std::sqrt(c4));
+    const double a = std::min(xmin + c1 - width, -1e-3);
+    const double b = std::max(xmax + c1 + width, 1e-3);
+    const double ba = b - a;
+
+    // Per-term weight: phi(w_k) * U_k, with U_k the put payoff coefficients on [a,0]
+    std::vector<cd> coef(n_terms);
+    for (std::size_t k = 0; k < n_terms; k++) {
+        const double w = static_cast<double>(k) * PI / ba;
+        const double Uk = 2.0 / ba * (-cos_chi(w, a, a, 0.0) + cos_psi(w, a, a, 0.0));
+        coef[k] = cf(cd(w, 0.0)) * Uk;
+    }
+    coef[0] *= 0.5;
+
+    const double df = std::exp(-cf.r * cf.T);
+    for (std::size_t j = 0; j < strikes.size(); j++) {
+        const double K = strikes[j];
+        if (!(K > 0.0)) continue;
+
+        // exp(i k theta) by recurrence instead of one complex exp per term
+        const double theta = PI * (std::log(S / K) - a) / ba;
+        const cd step(std::cos(theta), std::sin(theta));
+        cd rot(1.0, 0.0);
+        double acc = 0.0;
+        for (std::size_t k = 0; k < n_terms; k++) {
+            acc += (coef[k] * rot).real();
+            rot *= step;
+        }
+        out[j] = std::max(K * df * acc, 0.0);
+    }
+    return out;
+}
+
+std::vector<double> cosCallPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                  std::size_t n_terms, double L) {
+    // Puts are far less sensitive to the truncation range; calls via parity
+    std::vector<double> out = cosPutPrices(cf, S, strikes, n_terms, L);
+    const double df = std::exp(-cf.r * cf.T);
+    for (std::size_t j = 0; j < out.size(); j++) {
+        if (std::isfinite(out[j])) out[j] = std::max(out[j] + S - strikes[j] * df, 0.0);
+    }
+    return out;
+}
+
+std::vector<double> carrMadanCallPrices(const CharFn& cf, double S, const std::vector<double>& strikes,
+                                        std::size_t N, double eta, double alpha) {
+    std::vector<double> out(strikes.size(), NAN);
+    if (!chain_inputs_ok(cf, S) || !is_pow2(N) || N < 16 || !(eta > 0.0) || !(alpha > 0.0)) return out;
+
+    const cd i(0.0, 1.0);
+    const double lambda = 2.0 * PI / (static_cast<double>(N) * eta);
+    const double lnS = std::log(S);
+    const double k0 = lnS - 0.5 * static_cast<double>(N) * lambda;   // grid centred on ln S
+    const double df = std::exp(-cf.r * cf.T);
+
+    std::vector<cd> x(N);
+    for (std::size_t j = 0; j < N; j++) {
+        const double v = static_cast<double>(j) * eta;
+        const cd u(v, -(alpha + 1.0));
+        // CF of ln S_T = e^{iu ln S} * CF of ln(S_T/S)
+        const cd phi = std::exp(i * u * lnS) * cf(u);
+        const cd psi = df * phi / cd(alpha * alpha + alpha - v * v, (2.0 * alpha + 1.0) * v);
+
+        // Simpson weights
+        const double w = (j == 0) ? 1.0 / 3.0 : ((j % 2 == 1) ? 4.0 / 3.0 : 2.0 / 3.0);
+        x[j] = std::exp(-i * v * k0) * psi * (eta * w);
+    }
+    fft(x);
+
+    std::vector<double> grid(N);
+    for (std::size_t m = 0; m < N; m++) {
+        const double k = k0 + static_cast<double>(m) * lambda;
+        grid[m] = std::exp(-alpha * k) / PI * x[m].real();
+    }
+
+    // 4-point Lagrange interpolation in log-strike
+    for (std::size_t j = 0; j < strikes.size(); j++) {
+        const double K = strikes[j];
+        if (!(K > 0.0)) continue;
+        const double pos = (std::log(K) - k0) / lambda;
+        if (pos < 1.0 || pos > static_cast<double>(N) - 3.0) continue;
+
+        const std::size_t m = static_cast<std::size_t>(pos);
+        const double t = pos - static_cast<double>(m);
+        const double y0 = grid[m - 1], y1 = grid[m], y2 = grid[m + 1], y3 = grid[m + 2];
+        const double v = -t * (t - 1.0) * (t - 2.0) / 6.0 * y0
+                       + (t + 1.0) * (t - 1.0) * (t - 2.0) / 2.0 * y1
+                       - (t + 1.0) * t * (t - 2.0) / 2.0 * y2
+                       + (t + 1.0) * t * (t - 1.0) / 6.0 * y3;
+        out[j] = std::max(v, 0.0);
+    }
+    return out;
+}
+
+double hestonCallPrice(double S, double K, double T, double r, const HestonParams& p) {
+    if (S <= 0.0 || K <= 0.0 || T < 0.0) return NAN;
+    if (T == 0.0) return std::max(S - K, 0.0);
+    return cosCallPrices(hestonCharFn(T, r, p), S, {K})[0];
+}
+
+double hestonPutPrice(double S, double K, double T, double r, const HestonParams& p) {
+    if (S <= 0.0 || K <= 0.0 || T < 0.0) return NAN;
+    if (T == 0.0) return std::max(K - S, 0.0);
+    return cosPutPrices(hestonCharFn(T, r, p), S, {K})[0];
+}
@@ -2,6 +2,7 @@
 
 #include "greeks.h"
 #include "utils.h"
+#include "term_structure.h"
 #include <cmath>
 #include <algorithm>
 
@@ -51,3 +52,23 @@ double vega(double S, double K, double T, double r, double sigma) {
     return S * normal_pdf(d1) * std::sqrt(T);  
 }
 
+
+double callDelta(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return callDelta(f.spot, K, T, f.rate, f.vol) * f.spot_scale;
+}
+
+double putDelta(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return putDelta(f.spot, K, T, f.rate, f.vol) * f.spot_scale;
+}
+
+double gamma(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return gamma(f.spot, K, T, f.rate, f.vol) * f.spot_scale * f.spot_scale;
+}
+
+double vega(double S, double K, double T, const MarketCurves& curves) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return vega(f.spot, K, T, f.rate, f.vol);
+}
@@ -0,0 +1,246 @@
+// hedging.cpp
+
+#include "hedging.h"
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "utils.h"
+
+#include <atomic>
+#include <algorithm>
+#include <thread>
+
+namespace {
+    constexpr std::size_t kHistogramBins = 2048;
+
+    // Mergeable summary of a block of P&Ls (Chan et al. for the variance)
+    struct BlockSummary {
+        std::size_t n = 0;
+        double mean = 0.0, M2 = 0.0;
+        double min = HUGE_VAL, max = -HUGE_VAL;
+        double premium = 0.0, cost = 0.0, turnover = 0.0, drawdown = 0.0;   // sums
+    };
+
+    void merge(BlockSummary& into, const BlockSummary& b) {
+        if (b.n == 0) return;
+        const double na = static_cast<double>(into.n), nb = static_cast<double>(b.n), n = na + nb;
+        const double d = b.mean - into.mean;
+        into.mean += d * nb / n;
+        into.M2 += b.M2 + d * d * na * nb / n;
+        into.n += b.n;
+        into.min = std::min(into.min, b.min);
+        into.max = std::max(into.max, b.max);
+        into.premium += b.premium;
+        into.cost += b.cost;
+        into.turnover += b.turnover;
+        into.drawdown += b.drawdown;
+    }
+
+    // Per-thread block state, reused across blocks
+    struct Workspace {
+        std::vector<double> S, Z, pos, cash, cost, turnover, price, delta, peak, dd, pnl, rows;
+
+        explicit Workspace(const HedgeConfig& c) {
+            for (auto* v : {&S, &Z, &pos, &cash, &cost, &turnover, &price, &delta, &peak, &dd, &pnl}) {
+                v->resize(kHedgeBlockPaths);
+            }
+            if (c.paths) rows.resize((c.n_steps + 1) * kHedgeBlockPaths);
+        }
+    };
+
+    double payoff(bool is_call, double S, double K) {
+        return is_call ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+    }
+
+    // Simulates and hedges paths [first, first + n), leaving the P&Ls in ws.pnl
+    BlockSummary run_block(const HedgeConfig& c, double mu, double hv, std::size_t first, std::size_t n,
+                           Workspace& ws) {
+        const KernelTable& k = kernels();
+        const double dt = c.T / static_cast<double>(c.n_steps);
+        const double growth = std::exp(c.r * dt);
+        const double drift = (mu - 0.5 * c.sigma * c.sigma) * dt, vol = c.sigma * std::sqrt(dt);
+        const double rate = c.cost_rate;
+
+        double* S = ws.S.data();
+        if (c.paths) {
+            c.paths(first, n, c.n_steps, ws.rows.data());
+            S = ws.rows.data();
+        } else {
+            std::fill(ws.S.begin(), ws.S.begin() + n, c.S0);
+        }
+        std::fill(ws.pos.begin(), ws.pos.begin() + n, 0.0);
+        std::fill(ws.cost.begin(), ws.cost.begin() + n, 0.0);
+        std::fill(ws.turnover.begin(), ws.turnover.begin() + n, 0.0);
+        std::fill(ws.dd.begin(), ws.dd.begin() + n, 0.0);
+
+        BlockSummary out;
+        out.n = n;
+        for (std::size_t step = 0; step < c.n_steps; step++) {
+            const double tau = c.T - static_cast<double>(step) * dt;
+            const bool marked = step == 0 || c.track_drawdown;
+            k.bs_price_delta(c.is_call, S, n, c.K, tau, c.r, hv, marked ? ws.price.data() : nullptr, ws.delta.data());
+
+            if (step == 0) {
+                for (std::size_t i = 0; i < n; i++) {
+                    ws.cash[i] = ws.price[i];   // premium received
+                    out.premium += ws.price[i];
+                }
+            } else {
+                for (std::size_t i = 0; i < n; i++) {
+                    ws.cash[i] *= growth;
+                    ws.cost[i] *= growth;
+                }
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                const double q = ws.delta[i] - ws.pos[i];
+                const double fee = rate * std::fabs(q) * S[i];
+                ws.cash[i] -= q * S[i] + fee;
+                ws.cost[i] += fee;
+                ws.turnover[i] += std::fabs(q);
+                ws.pos[i] = ws.delta[i];
+            }
+            if (c.track_drawdown) {
+                for (std::size_t i = 0; i < n; i++) {
+                    const double v = ws.cash[i] + ws.pos[i] * S[i] - ws.price[i];
+                    ws.peak[i] = step == 0 ? v : std::max(ws.peak[i], v);
+                    ws.dd[i] = std::max(ws.dd[i], ws.peak[i] - v);
+                }
+            }
+
+            if (c.paths) {
+                S += n;
+            } else {
+                std::uint64_t state = c.seed;
+                rand_skip_normals(state, static_cast<std::uint64_t>(first) * c.n_steps + step * n);
+                k.normal_fill(state, ws.Z.data(), n);
+                k.gbm_step(S, ws.Z.data(), n, drift, vol);
+            }
+        }
+
+        // Unwind at T and pay the option
+        for (std::size_t i = 0; i < n; i++) {
+            const double fee = rate * std::fabs(ws.pos[i]) * S[i];
+            const double cash = ws.cash[i] * growth + ws.pos[i] * S[i] - fee;
+            ws.cost[i] = ws.cost[i] * growth + fee;
+            ws.turnover[i] += std::fabs(ws.pos[i]);
+            ws.pnl[i] = cash - payoff(c.is_call, S[i], c.K);
+            if (c.track_drawdown) ws.dd[i] = std::max(ws.dd[i], ws.peak[i] - ws.pnl[i]);
+        }
+
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            sum += ws.pnl[i];
+            out.min = std::min(out.min, ws.pnl[i]);
+            out.max = std::max(out.max, ws.pnl[i]);
+            out.cost += ws.cost[i];
+            out.turnover += ws.turnover[i];
+            out.drawdown += ws.dd[i];
+        }
+        out.mean = sum / static_cast<double>(n);
+        for (std::size_t i = 0; i < n; i++) {
+            const double d = ws.pnl[i] - out.mean;
+            out.M2 += d * d;
+        }
+        return out;
+    }
+
+    void add_to_histogram(const HedgeDistribution& h, const double* pnl, std::size_t n,
+                          std::vector<std::uint64_t>& counts) {
+        const double last = static_cast<double>(counts.size() - 1);
+        for (std::size_t i = 0; i < n; i++) {
+            const double b = std::min(std::max(std::floor((pnl[i] - h.lo) / h.width), 0.0), last);
+            counts[static_cast<std::size_t>(b)]++;
+        }
+    }
+}
+
+double HedgeDistribution::quantile(double p) const {
+    if (total == 0) return NAN;
+    const double target = std::min(std::max(p, 0.0), 1.0) * static_cast<double>(total);
+    double cum = 0.0;
+    for (std::size_t b = 0; b < counts.size(); b++) {
+        const double c = static_cast<double>(counts[b]);
+        if (c > 0.0 && cum + c >= target) {
+            return lo + (static_cast<double>(b) + (target - cum) / c) * width;
+        }
+        cum += c;
+    }
+    return lo + static_cast<double>(counts.size()) * width;
+}
+
+double HedgeDistribution::expectedShortfall(double p) const {
+    const double m = std::min(std::max(p, 0.0), 1.0) * static_cast<double>(total);
+    if (!(m > 0.0)) return NAN;
+    double taken = 0.0, sum = 0.0;
+    for (std::size_t b = 0; b < counts.size() && taken < m; b++) {
+        const double c = std::min(static_cast<double>(counts[b]), m - taken);
+        sum += c * (lo + (static_cast<double>(b) + 0.5) * width);
+        taken += c;
+    }
+    return sum / taken;
+}
+
+HedgeResult runHedgeBacktest(const HedgeConfig& c) {
+    HedgeResult res;
+    const double mu = std::isnan(c.mu) ? c.r : c.mu;
+    const double hv = std::isnan(c.hedge_vol) ? c.sigma : c.hedge_vol;
+    if (!(c.T > 0.0) || !(c.K > 0.0) || !(hv > 0.0) || !std::isfinite(c.r) || !std::isfinite(mu) ||
+        !std::isfinite(hv) || !(c.cost_rate >= 0.0) || c.n_steps == 0 || c.n_paths < 2) {
+        return res;
+    }
+    if (!c.paths && !(c.S0 > 0.0 && c.sigma > 0.0 && std::isfinite(c.S0) && std::isfinite(c.sigma))) return res;
+
+    const std::size_t blocks = (c.n_paths + kHedgeBlockPaths - 1) / kHedgeBlockPaths;
+    auto block_size = [&](std::size_t b) { return std::min(kHedgeBlockPaths, c.n_paths - b * kHedgeBlockPaths); };
+    std::vector<BlockSummary> summaries(blocks);
+
+    // Block 0 first: its span sets the histogram range
+    HedgeDistribution& h = res.distribution;
+    h.counts.assign(kHistogramBins, 0);
+    {
+        Workspace ws(c);
+        summaries[0] = run_block(c, mu, hv, 0, block_size(0), ws);
+        const double lo0 = summaries[0].min, hi0 = summaries[0].max;
+        double span = hi0 - lo0;
+        if (!(span > 0.0)) span = std::max(1e-12, 1e-9 * std::fabs(lo0));
+        h.lo = lo0 - 0.5 * span;
+        h.width = 2.0 * span / static_cast<double>(kHistogramBins);
+        add_to_histogram(h, ws.pnl.data(), block_size(0), h.counts);
+    }
+
+    std::size_t n_threads = c.n_threads == 0 ? std::thread::hardware_concurrency() : c.n_threads;
+    n_threads = std::max<std::size_t>(1, std::min(n_threads, blocks - 1));
+    std::vector<std::vector<std::uint64_t>> counts(n_threads, std::vector<std::uint64_t>(kHistogramBins, 0));
+    std::atomic<std::size_t> next{1};
+    auto worker = [&](std::size_t t) {
+        Workspace ws(c);
+        for (std::size_t b = next.fetch_add(1); b < blocks; b = next.fetch_add(1)) {
+            summaries[b] = run_block(c, mu, hv, b * kHedgeBlockPaths, block_size(b), ws);
+            add_to_histogram(h, ws.pnl.data(), block_size(b), counts[t]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < n_threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    // Summaries in block order: the same bits for any thread count
+    BlockSummary all;
+    for (const BlockSummary& s : summaries) merge(all, s);
+    for (const auto& tc : counts) {
+        for (std::size_t b = 0; b < kHistogramBins; b++) h.counts[b] += tc[b];
+    }
+    h.total = all.n;
+
+    const double n = static_cast<double>(all.n);
+    res.paths = all.n;
+    res.premium = all.premium / n;
+    res.mean_pnl = all.mean;
+    res.stdev_pnl = std::sqrt(all.M2 / (n - 1.0));
+    res.stderr_pnl = res.stdev_pnl / std::sqrt(n);
+    res.min_pnl = all.min;
+    res.max_pnl = all.max;
+    res.mean_cost = all.cost / n;
+    res.mean_turnover = all.turnover / n;
+    if (c.track_drawdown) res.mean_max_drawdown = all.drawdown / n;
+    return res;
+}
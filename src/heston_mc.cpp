@@ -0,0 +1,197 @@
+// heston_mc.cpp
+
+#include "heston_mc.h"
+#include "cpu_dispatch.h"
+#include "pricing_session.h"
+#include "utils.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // Paths per chunk: the 2 n_steps x chunk normals stay near 64 KB
+    constexpr std::size_t kChunkDoubles = 8192;
+
+    std::size_t chunk_paths(std::size_t steps) {
+        const std::size_t c = std::max<std::size_t>(kChunkDoubles / (2 * steps), 64) & ~std::size_t(7);
+        return std::min(c, kMCBlockPaths);
+    }
+
+    bool valid_inputs(const HestonOption& o, const HestonMCOptions& opt) {
+        const HestonParams& p = o.params;
+        return o.S > 0.0 && o.K > 0.0 && o.T >= 0.0 && std::isfinite(o.r) &&
+               p.kappa > 0.0 && p.theta > 0.0 && p.xi > 0.0 && p.v0 >= 0.0 && std::fabs(p.rho) <= 1.0 &&
+               opt.n_steps > 0 && opt.psi_c >= 1.0 && opt.psi_c <= 2.0;
+    }
+
+    // COS price of the European control. Runs with extreme vol of variance
+    // (xi ~ 1, long T) need far more terms than hestonCallPrice's default
+    // for an error well below the stderr, so the price is kept for the
+    // last option seen on this thread and the blocks of a run share it.
+    double european_price(const HestonOption& o) {
+        struct Memo {
+            bool valid = false, is_call = true;
+            double S, K, T, r, kappa, theta, xi, rho, v0, price;
+        };
+        thread_local Memo memo;
+        const HestonParams& p = o.params;
+        if (!(memo.valid && memo.is_call == o.is_call && memo.S == o.S && memo.K == o.K && memo.T == o.T &&
+              memo.r == o.r && memo.kappa == p.kappa && memo.theta == p.theta && memo.xi == p.xi &&
+              memo.rho == p.rho && memo.v0 == p.v0)) {
+            const CharFn cf = hestonCharFn(o.T, o.r, p);
+            const double price = o.is_call ? cosCallPrices(cf, o.S, {o.K}, 2048, 40.0)[0]
+                                           : cosPutPrices(cf, o.S, {o.K}, 2048, 40.0)[0];
+            memo = {true, o.is_call, o.S, o.K, o.T, o.r, p.kappa, p.theta, p.xi, p.rho, p.v0, price};
+        }
+        return memo.price;
+    }
+
+    // Per-run constants shared by every block
+    struct HestonRun {
+        HestonStepCoeffs step;
+        double df = 1.0;
+        double sign = 1.0;           // +1 call, -1 put
+        double log_S0 = 0.0;
+        double control_mean = 0.0;
+    };
+
+    // QE coefficients with gamma1 = gamma2 = 1/2 (Andersen 2008, section 4.1)
+    HestonRun setup(const HestonOption& o, const HestonMCOptions& opt, bool control) {
+        const HestonParams& p = o.params;
+        const double dt = o.T / static_cast<double>(opt.n_steps);
+        HestonRun run;
+        run.df = std::exp(-o.r * o.T);
+        run.sign = o.is_call ? 1.0 : -1.0;
+        run.log_S0 = std::log(o.S);
+        run.control_mean = o.S;
+        if (control && o.asian) run.control_mean = european_price(o);
+
+        HestonStepCoeffs& c = run.step;
+        c.qe = opt.scheme == HestonScheme::QE;
+        c.martingale = opt.martingale_correction;
+        c.theta = p.theta;
+        c.psi_c = opt.psi_c;
+        c.drift = o.r * dt;
+
+        const double e = std::exp(-p.kappa * dt), xi2 = p.xi * p.xi;
+        c.e_kdt = e;
+        c.s2_v = xi2 * e * (1.0 - e) / p.kappa;
+        c.s2_c = p.theta * xi2 * (1.0 - e) * (1.0 - e) / (2.0 * p.kappa);
+        const double k = 0.5 * dt * (p.kappa * p.rho / p.xi - 0.5);
+        c.K0 = -p.rho * p.kappa * p.theta * dt / p.xi;
+        c.K1 = k - p.rho / p.xi;
+        c.K2 = k + p.rho / p.xi;
+        c.K3 = c.K4 = 0.5 * dt * (1.0 - p.rho * p.rho);
+
+        c.kappa_dt = p.kappa * dt;
+        c.xi_sqrt_dt = p.xi * std::sqrt(dt);
+        c.rho = p.rho;
+        c.rho_bar = std::sqrt(std::max(1.0 - p.rho * p.rho, 0.0));
+        c.dt = dt;
+        c.sqrt_dt = std::sqrt(dt);
+        return run;
+    }
+
+    ScratchArena& default_arena() {
+        thread_local ScratchArena arena(std::size_t(1) << 20);
+        return arena;
+    }
+}
+
+MCPartial mcHestonBlock(const HestonOption& option, const HestonMCOptions& options,
+                        std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                        std::size_t block, ScratchArena& arena) {
+    const bool useAnti = mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS;
+    const bool useCV = mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS;
+
+    MCPartial out;
+    out.control = useCV;
+
+    const std::size_t first = block * kMCBlockPaths;
+    if (first >= n_paths) return out;
+    const HestonRun run = setup(option, options, useCV);
+    out.control_mean = run.control_mean;
+
+    const std::size_t n = std::min(kMCBlockPaths, n_paths - first);
+    const std::size_t steps = options.n_steps;
+    const std::size_t chunk = chunk_paths(steps);
+
+    const ScratchArena::Marker mark = arena.mark();
+    double* draws = arena.allocArray<double>(chunk * 2 * steps);   // path-major, as drawn
+    double* Z = arena.allocArray<double>(2 * steps * chunk);       // row 2k: Zv of step k, 2k + 1: Zx
+    double* V = arena.allocArray<double>(chunk);
+    double* log_S = arena.allocArray<double>(chunk);
+    double* sum = arena.allocArray<double>(chunk);
+    double* X = arena.allocArray<double>(n);
+    double* Y = arena.allocArray<double>(n);
+
+    std::uint64_t state = seed;
+    rand_skip_normals(state, static_cast<std::uint64_t>(first) * 2 * steps);
+    const KernelTable& k = kernels();
+    const double inv_steps = 1.0 / static_cast<double>(steps);
+
+    for (std::size_t c0 = 0; c0 < n; c0 += chunk) {
+        const std::size_t m = std::min(chunk, n - c0);
+        rand_standard_normal_fill(state, draws, m * 2 * steps);
+        for (std::size_t p = 0; p < m; p++)
+            for (std::size_t j = 0; j < 2 * steps; j++) Z[j * m + p] = draws[p * 2 * steps + j];
+
+        for (int leg = 0; leg < (useAnti ? 2 : 1); leg++) {
+            std::fill(V, V + m, option.params.v0);
+            std::fill(log_S, log_S + m, run.log_S0);
+            if (option.asian) std::fill(sum, sum + m, 0.0);
+            for (std::size_t s = 0; s < steps; s++) {
+                k.heston_step(run.step, leg == 0 ? 1.0 : -1.0, Z + 2 * s * m, Z + (2 * s + 1) * m, m,
+                              V, log_S, option.asian ? sum : nullptr);
+            }
+
+            for (std::size_t p = 0; p < m; p++) {
+                const double ST = std::exp(log_S[p]);
+                const double european = run.df * std::max(run.sign * (ST - option.K), 0.0);
+                double x = european, y = run.df * ST;
+                if (option.asian) {
+                    const double average = (0.5 * option.S + sum[p] - 0.5 * ST) * inv_steps;
+                    x = run.df * std::max(run.sign * (average - option.K), 0.0);
+                    y = european;
+                }
+                if (leg == 0) {
+                    X[c0 + p] = x;
+                    Y[c0 + p] = y;
+                } else {
+                    X[c0 + p] = 0.5 * (X[c0 + p] + x);
+                    Y[c0 + p] = 0.5 * (Y[c0 + p] + y);
+                }
+            }
+        }
+    }
+
+    out = mcAccumulate(X, Y, n, useCV, run.control_mean);
+    arena.rewind(mark);
+    return out;
+}
+
+MCResult mcHestonPrice(const HestonOption& option, std::size_t n_paths, std::uint64_t seed,
+                       MCMode mode, const HestonMCOptions& options, ScratchArena& arena) {
+    if (!valid_inputs(option, options) || n_paths < 2 ||
+        (mode != MCMode::Plain && mode != MCMode::Antithetic &&
+         mode != MCMode::ControlVariateBS && mode != MCMode::AntitheticControlBS)) {
+        return {NAN, NAN, NAN, NAN};
+    }
+
+    if (option.T == 0.0) {
+        const double p = std::max((option.is_call ? 1.0 : -1.0) * (option.S - option.K), 0.0);
+        return {p, 0.0, p, p};
+    }
+
+    MCPartial total;
+    const std::size_t blocks = mcBlockCount(n_paths);
+    for (std::size_t b = 0; b < blocks; b++) {
+        mcMerge(total, mcHestonBlock(option, options, n_paths, seed, mode, b, arena));
+    }
+    return mcFinalize(total);
+}
+
+MCResult mcHestonPrice(const HestonOption& option, std::size_t n_paths, std::uint64_t seed,
+                       MCMode mode, const HestonMCOptions& options) {
+    return mcHestonPrice(option, n_paths, seed, mode, options, default_arena());
+}
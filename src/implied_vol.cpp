@@ -1,6 +1,7 @@
 #include "implied_vol.h"
 #include "black_scholes.h"
 #include "greeks.h"
+#include "term_structure.h"
 
 #include <cmath>
 #include <algorithm>
@@ -28,6 +29,9 @@ namespace {
     inline double f_put(double sigma, double mkt, double S, double K, double T, double r) {
         return putPrice(S, K, T, r, sigma) - mkt;
     }
+    inline double vega_flat(double S, double K, double T, double r, double sigma) {
+        return vega(S, K, T, r, sigma);
+    }
 
     template <typename F, typename Vega>
     IVResult solve_iv(F f, Vega vega_fn,
@@ -108,7 +112,7 @@ IVResult impliedVolCall(double market_price, double S, double K, double T, doubl
         return {NAN, 0, false};
     }
 
-    return solve_iv(f_call, vega, market_price, S, K, T, r, init_sigma, tol, max_iter);
+    return solve_iv(f_call, vega_flat, market_price, S, K, T, r, init_sigma, tol, max_iter);
 }
 
 IVResult impliedVolPut(double market_price, double S, double K, double T, double r,
@@ -124,5 +128,17 @@ IVResult impliedVolPut(double market_price, double S, double K, double T, double
         return {NAN, 0, false};
     }
 
-    return solve_iv(f_put, vega, market_price, S, K, T, r, init_sigma, tol, max_iter);
+    return solve_iv(f_put, vega_flat, market_price, S, K, T, r, init_sigma, tol, max_iter);
+}
+
+IVResult impliedVolCall(double market_price, double S, double K, double T, const MarketCurves& curves,
+                        double init_sigma, double tol, int max_iter) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return impliedVolCall(market_price, f.spot, K, T, f.rate, init_sigma, tol, max_iter);
+}
+
+IVResult impliedVolPut(double market_price, double S, double K, double T, const MarketCurves& curves,
+                       double init_sigma, double tol, int max_iter) {
+    const MarketCurves::FlatInputs f = curves.flatten(S, T);
+    return impliedVolPut(market_price, f.spot, K, T, f.rate, init_sigma, tol, max_iter);
 }
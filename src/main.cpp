@@ -5,18 +5,26 @@
 #include <cstdint>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "black_scholes.h"
 #include "greeks.h"
 #include "monte_carlo.h"
 #include "implied_vol.h"
+#include "cpu_dispatch.h"
+#include "mc_shard.h"
+#include "mc_cache.h"
+#include "pricing_session.h"
 
 namespace {
 
 struct Args {
     std::string method = "bs";     // bs | mc
     std::string type   = "call";   // call | put
-    std::string mode   = "plain";  // plain | anti | cv | anti+cv (mc only)
+    std::string mode   = "plain";  // plain | anti | cv | anti+cv | is | anti+is | mm | anti+mm | emc | anti+emc (mc only)
 
     double S = NAN;
     double K = NAN;
@@ -27,6 +35,14 @@ struct Args {
     std::size_t paths = 200000;
     std::uint64_t seed = 123456;
 
+    // Sharded MC: run shard `shard` of `shards` and write its state to `out`
+    std::size_t shard = 0;
+    std::size_t shards = 0;
+    std::string out;
+
+    // Persistent MC result cache (seeded runs are deterministic)
+    std::string cache;
+
     bool greeks = false;
 
     // Implied vol (BS only)
@@ -53,19 +69,35 @@ static void usage(const char* prog) {
         << "  --r        r\n"
         << "  --sigma    sigma                     (required unless using --iv)\n\n"
         << "Monte Carlo options (when --method mc):\n"
-        << "  --mode     plain|anti|cv|anti+cv\n"
+        << "  --mode     plain|anti|cv|anti+cv|is|anti+is|mm|anti+mm|emc|anti+emc\n"
         << "  --paths    N                         (default 200000)\n"
-        << "  --seed     uint64                    (default 123456)\n\n"
+        << "  --seed     uint64                    (default 123456)\n"
+        << "  --shard    i/N                       run path-block shard i of N (0-based)\n"
+        << "  --out      FILE                      write the shard state to FILE (with --shard)\n"
+        << "  --cache    FILE                      reuse / record results in the persistent cache FILE\n\n"
+        << "Merging shards:\n"
+        << "  " << prog << " --merge FILE...   (shard states from --shard/--out; prints the full-run result)\n\n"
         << "Extras:\n"
         << "  --greeks   compute greeks (bs only for now)\n"
         << "  --iv       compute implied vol from --market_price (bs only)\n"
         << "  --market_price X   market option price for implied vol\n"
         << "  --iv_init X        initial guess for sigma (default 0.2)\n"
+        << "  --version          show build and active SIMD kernel level\n"
         << "  --help, -h         show this help\n\n"
         << "Examples:\n"
         << "  " << prog << " --method bs --type call --spot 100 --strike 100 --T 1 --r 0.05 --sigma 0.2 --greeks\n"
         << "  " << prog << " --method mc --type call --spot 100 --strike 100 --T 1 --r 0.05 --sigma 0.2 --mode anti+cv --paths 200000 --seed 7\n"
-        << "  " << prog << " --method bs --type call --spot 100 --strike 100 --T 1 --r 0.05 --iv --market_price 10.45 --greeks\n";
+        << "  " << prog << " --method bs --type call --spot 100 --strike 100 --T 1 --r 0.05 --iv --market_price 10.45 --greeks\n"
+        << "  " << prog << " --method mc --type call --spot 100 --strike 100 --T 1 --r 0.05 --sigma 0.2 --paths 10000000 --shard 0/4 --out s0.mcshard\n"
+        << "  " << prog << " --method mc --type put --spot 100 --strike 95 --T 0.5 --r 0.03 --sigma 0.3 --mode anti+cv --cache results.mccache\n"
+        << "  " << prog << " --merge s0.mcshard s1.mcshard s2.mcshard s3.mcshard\n";
+}
+
+static void print_version() {
+    std::cout << "options_pricer (options-pricing-engine)\n"
+              << "  kernels:  " << isaName(activeIsa()) << "\n"
+              << "  detected: " << isaName(detectedIsa()) << "\n";
+    if (const char* env = std::getenv("PRICER_ISA")) std::cout << "  PRICER_ISA=" << env << "\n";
 }
 
 static double parse_double(const std::string& s, const std::string& name) {
@@ -101,12 +133,27 @@ static std::size_t parse_size(const std::string& s, const std::string& name) {
     }
 }
 
+// "i/N" with i < N
+static void parse_shard(const std::string& s, std::size_t& shard, std::size_t& shards) {
+    const std::size_t slash = s.find('/');
+    if (slash == std::string::npos) throw std::runtime_error("Invalid --shard '" + s + "'. Use i/N");
+    shard = parse_size(s.substr(0, slash), "--shard");
+    shards = parse_size(s.substr(slash + 1), "--shard");
+    if (shards == 0 || shard >= shards) throw std::runtime_error("--shard i/N needs 0 <= i < N");
+}
+
 static MCMode parse_mc_mode(const std::string& s) {
     if (s == "plain")   return MCMode::Plain;
     if (s == "anti")    return MCMode::Antithetic;
     if (s == "cv")      return MCMode::ControlVariateBS;
     if (s == "anti+cv") return MCMode::AntitheticControlBS;
-    throw std::runtime_error("Invalid --mode '" + s + "'. Use plain|anti|cv|anti+cv");
+    if (s == "is")      return MCMode::ImportanceSampling;
+    if (s == "anti+is") return MCMode::AntitheticImportance;
+    if (s == "mm")      return MCMode::MomentMatching;
+    if (s == "anti+mm") return MCMode::AntitheticMomentMatching;
+    if (s == "emc")     return MCMode::MartingaleCorrection;
+    if (s == "anti+emc") return MCMode::AntitheticMartingale;
+    throw std::runtime_error("Invalid --mode '" + s + "'. Use plain|anti|cv|anti+cv|is|anti+is|mm|anti+mm|emc|anti+emc");
 }
 
 static void validate(const Args& a) {
@@ -133,6 +180,14 @@ static void validate(const Args& a) {
         if (a.paths < 2) bad("--paths must be >= 2 for MC");
     }
 
+    if (a.shards > 0) {
+        if (a.method != "mc") bad("--shard is supported only for --method mc");
+        if (a.out.empty()) bad("--shard requires --out FILE");
+        if (!a.cache.empty()) bad("--cache cannot be combined with --shard");
+    }
+
+    if (!a.cache.empty() && a.method != "mc") bad("--cache is supported only for --method mc");
+
     if (a.greeks && a.method != "bs") {
         bad("--greeks is currently supported for --method bs only (add MC greeks later)");
     }
@@ -155,6 +210,10 @@ static Args parse_args(int argc, char** argv) {
             usage(argv[0]);
             std::exit(0);
         }
+        if (key == "--version") {
+            print_version();
+            std::exit(0);
+        }
 
         if (!is_flag(key)) {
             throw std::runtime_error("Unexpected token: '" + key + "'. Flags must start with --");
@@ -185,6 +244,9 @@ static Args parse_args(int argc, char** argv) {
         else if (key == "--sigma") a.sigma = parse_double(val, "--sigma");
         else if (key == "--paths") a.paths = parse_size(val, "--paths");
         else if (key == "--seed") a.seed = parse_u64(val, "--seed");
+        else if (key == "--shard") parse_shard(val, a.shard, a.shards);
+        else if (key == "--out") a.out = val;
+        else if (key == "--cache") a.cache = val;
         else if (key == "--market_price") a.market_price = parse_double(val, "--market_price");
         else if (key == "--iv_init") a.iv_init = parse_double(val, "--iv_init");
         else {
@@ -222,10 +284,55 @@ static void print_header(const Args& a) {
     std::cout << "\n";
 }
 
+static void print_mc_result(const char* title, const MCResult& res) {
+    std::cout << title << "\n";
+    std::cout << "  price:  " << std::setprecision(8) << res.price << "\n";
+    std::cout << "  stderr: " << std::setprecision(8) << res.stderr << "\n";
+    std::cout << "  95% CI: [" << std::setprecision(8) << res.ci_low
+              << ", " << std::setprecision(8) << res.ci_high << "]\n";
+}
+
+// --merge FILE...: folds shard states in block order into the run result
+static int merge_shards(int argc, char** argv) {
+    std::vector<MCShardState> parts;
+    for (int i = 2; i < argc; i++) {
+        std::ifstream in(argv[i]);
+        std::stringstream text;
+        text << in.rdbuf();
+        MCShardState s;
+        if (!in || !mcParseShard(text.str(), s)) {
+            throw std::runtime_error(std::string("Cannot read shard state '") + argv[i] + "'");
+        }
+        parts.push_back(std::move(s));
+    }
+    if (parts.empty()) throw std::runtime_error("--merge needs at least one shard file");
+
+    std::sort(parts.begin(), parts.end(),
+              [](const MCShardState& x, const MCShardState& y) { return x.first_block < y.first_block; });
+    MCShardState total = parts[0];
+    for (std::size_t i = 1; i < parts.size(); i++) {
+        if (!mcMergeShards(total, parts[i])) {
+            throw std::runtime_error("Shard states belong to different runs or leave a gap / overlap");
+        }
+    }
+    if (!total.complete()) {
+        throw std::runtime_error("Shards cover blocks [" + std::to_string(total.first_block) + ", " +
+                                 std::to_string(total.endBlock()) + ") of " +
+                                 std::to_string(mcBlockCount(total.job.n_paths)) + "; run the missing shards");
+    }
+
+    std::cout << std::fixed;
+    std::cout << "Merged " << parts.size() << " shard(s), " << total.job.n_paths << " paths\n\n";
+    print_mc_result("Result (Monte Carlo)", mcFinalize(total));
+    return 0;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
     try {
+        if (argc >= 2 && std::string(argv[1]) == "--merge") return merge_shards(argc, argv);
+
         const Args a = parse_args(argc, argv);
 
         // Early parse of MC mode to catch invalid mode even if not used
@@ -275,15 +382,45 @@ int main(int argc, char** argv) {
 
         // MC
         const MCMode mode = parse_mc_mode(a.mode);
+
+        if (a.shards > 0) {
+            const MCJob job{a.type == "call", a.S, a.K, a.T, a.r, a.sigma, a.paths, a.seed, mode};
+            std::size_t first = 0, last = 0;
+            mcShardRange(a.paths, a.shard, a.shards, first, last);
+
+            ScratchArena arena(std::size_t(1) << 18);
+            const MCShardState state = mcRunBlocks(job, first, last, arena);
+            std::ofstream out(a.out);
+            out << mcSerializeShard(state);
+            if (!out) throw std::runtime_error("Cannot write shard state to '" + a.out + "'");
+
+            std::cout << "Shard " << a.shard << "/" << a.shards << ": blocks [" << first << ", " << last
+                      << ") written to " << a.out << "\n";
+            return 0;
+        }
+
+        if (!a.cache.empty()) {
+            MCResultCache cache(1);
+            if (!cache.openStore(a.cache)) throw std::runtime_error("Cannot open cache store '" + a.cache + "'");
+            const MCJob job{a.type == "call", a.S, a.K, a.T, a.r, a.sigma, a.paths, a.seed, mode};
+            const MCResult res = cache.price(job);
+            const MCCacheStats st = cache.stats();
+
+            print_mc_result("Result (Monte Carlo)", res);
+            std::cout << "\nCache\n";
+            std::cout << "  lookup: " << (st.hits ? "hit" : "miss") << " ("
+                      << std::setprecision(1) << st.lookup_ns / 1e3 << " us)\n";
+            if (!st.hits) std::cout << "  engine: " << std::setprecision(1) << st.compute_ns / 1e3 << " us\n";
+            std::cout << "  store:  " << a.cache << " (" << st.store_records << " results, engine v"
+                      << cache.version() << ")\n";
+            return 0;
+        }
+
         MCResult res;
         if (a.type == "call") res = mcCallPrice(a.S, a.K, a.T, a.r, a.sigma, a.paths, a.seed, mode);
         else                  res = mcPutPrice (a.S, a.K, a.T, a.r, a.sigma, a.paths, a.seed, mode);
 
-        std::cout << "Result (Monte Carlo)\n";
-        std::cout << "  price:  " << std::setprecision(8) << res.price << "\n";
-        std::cout << "  stderr: " << std::setprecision(8) << res.stderr << "\n";
-        std::cout << "  95% CI: [" << std::setprecision(8) << res.ci_low
-                  << ", " << std::setprecision(8) << res.ci_high << "]\n";
+        print_mc_result("Result (Monte Carlo)", res);
 
         return 0;
 
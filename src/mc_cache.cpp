@@ -0,0 +1,356 @@
+// mc_cache.cpp
+
+#include "mc_cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::size_t kShards = 16;
+    constexpr char kStoreMagic[8] = {'m', 'c', 'c', 'a', 'c', 'h', 'e', '\0'};
+    constexpr std::uint32_t kStoreFormat = 1;
+
+    struct StoreHeader {
+        char magic[8];
+        std::uint32_t format;
+        std::uint32_t version;        // engine version tag of every record
+        std::uint32_t record_size;
+        std::uint32_t reserved[3];
+    };
+
+    struct StoreRecord {
+        MCCacheKey key;
+        double result[4];             // price, stderr, ci_low, ci_high
+    };
+
+    static_assert(sizeof(StoreHeader) == 32, "store header layout");
+    static_assert(sizeof(StoreRecord) == 104, "store record layout");
+
+    std::uint64_t bits(double v) {
+        std::uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27; x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool cacheable(const MCResult& r) {
+        return std::isfinite(r.price) && std::isfinite(r.stderr);
+    }
+
+    std::atomic<std::uint64_t> temp_serial{0};
+
+    // Writes at the end of the file (descriptors are opened O_APPEND)
+    bool write_all(int fd, const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t n = ::write(fd, p, size);
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    // Exclusive flock on the store for the scope: processes sharing the
+    // store serialise resets and appends
+    struct FileLock {
+        int fd;
+        bool held;
+        explicit FileLock(int f) : fd(f), held(::flock(f, LOCK_EX) == 0) {}
+        ~FileLock() { if (held) ::flock(fd, LOCK_UN); }
+    };
+
+    // Drops a torn trailing record (interrupted append). Only called under
+    // the lock; mappings never cover a partial record, so shrinking is safe.
+    bool trim_torn(int fd, std::size_t& size) {
+        const std::size_t records = (size - sizeof(StoreHeader)) / sizeof(StoreRecord);
+        const std::size_t used = sizeof(StoreHeader) + records * sizeof(StoreRecord);
+        if (used != size && ::ftruncate(fd, static_cast<off_t>(used)) != 0) return false;
+        size = used;
+        return true;
+    }
+
+    // An empty store of another version replaces the file by rename: other
+    // processes keep their mapping of the old file instead of having it
+    // truncated under them
+    bool replace_with_empty(const std::string& path, const StoreHeader& fresh) {
+        const std::string temp = path + ".tmp." + std::to_string(::getpid()) + "." +
+                                 std::to_string(temp_serial.fetch_add(1));
+        const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (fd < 0) return false;
+        bool ok = write_all(fd, &fresh, sizeof(fresh));
+        ok = (::close(fd) == 0) && ok;
+        ok = ok && ::rename(temp.c_str(), path.c_str()) == 0;
+        if (!ok) ::unlink(temp.c_str());
+        return ok;
+    }
+
+    // The descriptor still names the file at `path` (not one renamed over)
+    bool is_current(int fd, const std::string& path) {
+        struct stat a, b;
+        return ::fstat(fd, &a) == 0 && ::stat(path.c_str(), &b) == 0 && a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+    }
+}
+
+bool MCCacheKey::operator==(const MCCacheKey& o) const {
+    return std::memcmp(w, o.w, sizeof(w)) == 0;
+}
+
+std::size_t MCCacheKeyHash::operator()(const MCCacheKey& k) const {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull;
+    for (std::uint64_t x : k.w) h = mix(h ^ x);
+    return static_cast<std::size_t>(h);
+}
+
+MCCacheKey mcCacheKey(const MCJob& job, std::uint32_t version) {
+    return {{version,
+             (job.is_call ? 1ull : 0ull) | (static_cast<std::uint64_t>(job.mode) << 8),
+             bits(job.S), bits(job.K), bits(job.T), bits(job.r), bits(job.sigma),
+             static_cast<std::uint64_t>(job.n_paths), job.seed}};
+}
+
+// Mapped records (read-only, indexed at open) plus the records this process
+// appended since, which the mapping does not cover
+struct MCResultCache::Store {
+    int fd = -1;
+    void* map = nullptr;
+    std::size_t map_size = 0;
+    std::unordered_map<MCCacheKey, const StoreRecord*, MCCacheKeyHash> mapped;
+    std::unordered_map<MCCacheKey, MCResult, MCCacheKeyHash> appended;
+
+    ~Store() {
+        if (map) ::munmap(map, map_size);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+MCResultCache::MCResultCache(std::size_t capacity, std::uint32_t version)
+    : version_(version),
+      capacity_(capacity),
+      shard_capacity_(capacity == 0 ? 0 : (capacity + kShards - 1) / kShards) {
+    shards_.reserve(kShards);
+    for (std::size_t i = 0; i < kShards; i++) shards_.push_back(std::make_unique<Shard>());
+}
+
+MCResultCache::~MCResultCache() = default;
+
+bool MCResultCache::openStore(const std::string& path) {
+    std::lock_guard<std::mutex> lk(store_m_);
+    store_.reset();
+
+    const StoreHeader fresh = {{kStoreMagic[0], kStoreMagic[1], kStoreMagic[2], kStoreMagic[3],
+                                kStoreMagic[4], kStoreMagic[5], kStoreMagic[6], kStoreMagic[7]},
+                               kStoreFormat, version_, static_cast<std::uint32_t>(sizeof(StoreRecord)), {0, 0, 0}};
+
+    // A few rounds at most: each retry follows a reset by another process
+    for (int attempt = 0; attempt < 8; attempt++) {
+        auto s = std::make_unique<Store>();
+        s->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (s->fd < 0) return false;
+
+        FileLock lock(s->fd);
+        if (!lock.held) return false;
+        if (!is_current(s->fd, path)) continue;   // replaced while we waited for the lock
+
+        struct stat st;
+        if (::fstat(s->fd, &st) != 0) return false;
+        std::size_t size = static_cast<std::size_t>(st.st_size);
+
+        if (size == 0) {
+            if (!write_all(s->fd, &fresh, sizeof(fresh))) return false;
+            size = sizeof(fresh);
+        } else {
+            StoreHeader h;
+            if (size < sizeof(h) || ::pread(s->fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)) ||
+                std::memcmp(h.magic, kStoreMagic, sizeof(kStoreMagic)) != 0 || h.format != kStoreFormat ||
+                h.record_size != sizeof(StoreRecord)) {
+                return false;   // not a store: leave the file alone
+            }
+            if (h.version != version_) {
+                // Results of another engine version: start an empty store
+                if (!replace_with_empty(path, fresh)) return false;
+                continue;
+            }
+        }
+        if (!trim_torn(s->fd, size)) return false;
+
+        const std::size_t records = (size - sizeof(StoreHeader)) / sizeof(StoreRecord);
+        if (records > 0) {
+            s->map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, s->fd, 0);
+            if (s->map == MAP_FAILED) {
+                s->map = nullptr;
+                return false;
+            }
+            s->map_size = size;
+            const StoreRecord* rec = reinterpret_cast<const StoreRecord*>(
+                static_cast<const char*>(s->map) + sizeof(StoreHeader));
+            s->mapped.reserve(records);
+            for (std::size_t i = 0; i < records; i++) s->mapped.emplace(rec[i].key, &rec[i]);
+        }
+        store_ = std::move(s);
+        return true;
+    }
+    return false;
+}
+
+void MCResultCache::closeStore() {
+    std::lock_guard<std::mutex> lk(store_m_);
+    store_.reset();
+}
+
+MCResultCache::Shard& MCResultCache::shard_of(std::size_t hash) {
+    return *shards_[(hash >> 56) % kShards];   // high bits: the map buckets use the low ones
+}
+
+bool MCResultCache::lookup_key(const MCCacheKey& key, std::size_t hash, MCResult& out) {
+    {
+        Shard& sh = shard_of(hash);
+        std::lock_guard<std::mutex> lk(sh.m);
+        auto it = sh.index.find(key);
+        if (it != sh.index.end()) {
+            sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+            out = it->second->result;
+            return true;
+        }
+    }
+
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lk(store_m_);
+        if (store_) {
+            auto m = store_->mapped.find(key);
+            if (m != store_->mapped.end()) {
+                const double* v = m->second->result;
+                out = {v[0], v[1], v[2], v[3]};
+                found = true;
+            } else {
+                auto a = store_->appended.find(key);
+                if (a != store_->appended.end()) {
+                    out = a->second;
+                    found = true;
+                }
+            }
+        }
+    }
+    if (found) {
+        store_hits_.fetch_add(1, std::memory_order_relaxed);
+        insert_memory(key, hash, out);
+    }
+    return found;
+}
+
+bool MCResultCache::lookup(const MCJob& job, MCResult& out) {
+    const std::uint64_t t0 = now_ns();
+    const MCCacheKey key = mcCacheKey(job, version_);
+    const bool hit = lookup_key(key, MCCacheKeyHash()(key), out);
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    (hit ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    lookup_ns_.fetch_add(now_ns() - t0, std::memory_order_relaxed);
+    return hit;
+}
+
+void MCResultCache::insert_memory(const MCCacheKey& key, std::size_t hash, const MCResult& result) {
+    if (shard_capacity_ == 0) return;
+    Shard& sh = shard_of(hash);
+    std::lock_guard<std::mutex> lk(sh.m);
+    auto it = sh.index.find(key);
+    if (it != sh.index.end()) {
+        it->second->result = result;
+        sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+        return;
+    }
+    sh.lru.push_front({key, result});
+    sh.index.emplace(key, sh.lru.begin());
+    if (sh.lru.size() > shard_capacity_) {
+        sh.index.erase(sh.lru.back().key);
+        sh.lru.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MCResultCache::insert(const MCJob& job, const MCResult& result) {
+    if (!cacheable(result)) return;
+    const MCCacheKey key = mcCacheKey(job, version_);
+    insert_memory(key, MCCacheKeyHash()(key), result);
+    inserts_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lk(store_m_);
+    if (!store_ || store_->mapped.count(key) || store_->appended.count(key)) return;
+    const StoreRecord rec = {key, {result.price, result.stderr, result.ci_low, result.ci_high}};
+
+    // Other processes append to the same file: lock, drop a record torn by
+    // a crashed writer so ours stays aligned, then append at the true end
+    FileLock lock(store_->fd);
+    struct stat st;
+    if (!lock.held || ::fstat(store_->fd, &st) != 0) return;
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size < sizeof(StoreHeader) || !trim_torn(store_->fd, size)) return;
+    if (write_all(store_->fd, &rec, sizeof(rec))) store_->appended.emplace(key, result);
+}
+
+template <typename Run>
+MCResult MCResultCache::price_with(const MCJob& job, Run&& run) {
+    MCResult r;
+    if (lookup(job, r)) return r;
+    const std::uint64_t t0 = now_ns();
+    r = run();
+    compute_ns_.fetch_add(now_ns() - t0, std::memory_order_relaxed);
+    insert(job, r);
+    return r;
+}
+
+MCResult MCResultCache::price(const MCJob& job) {
+    return price_with(job, [&] {
+        return job.is_call ? mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode)
+                           : mcPutPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode);
+    });
+}
+
+MCResult MCResultCache::price(const MCJob& job, ScratchArena& arena) {
+    return price_with(job, [&] {
+        return job.is_call
+            ? mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, arena)
+            : mcPutPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, arena);
+    });
+}
+
+void MCResultCache::clear() {
+    for (auto& sh : shards_) {
+        std::lock_guard<std::mutex> lk(sh->m);
+        sh->lru.clear();
+        sh->index.clear();
+    }
+}
+
+MCCacheStats MCResultCache::stats() const {
+    MCCacheStats s;
+    s.lookups = lookups_.load();
+    s.hits = hits_.load();
+    s.store_hits = store_hits_.load();
+    s.misses = misses_.load();
+    s.inserts = inserts_.load();
+    s.evictions = evictions_.load();
+    s.lookup_ns = lookup_ns_.load();
+    s.compute_ns = compute_ns_.load();
+    std::lock_guard<std::mutex> lk(store_m_);
+    if (store_) s.store_records = store_->mapped.size() + store_->appended.size();
+    return s;
+}
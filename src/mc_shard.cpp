@@ -0,0 +1,150 @@
+// mc_shard.cpp
+
+#include "mc_shard.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    constexpr const char* kMagic = "mcshard";
+    constexpr int kFormatVersion = 4;
+
+    // Shortest block record: nine one-character tokens, eight separators
+    constexpr std::size_t kMinBlockChars = 17;
+
+    bool same_run(const MCJob& a, const MCJob& b) {
+        return a.is_call == b.is_call && a.S == b.S && a.K == b.K && a.T == b.T && a.r == b.r &&
+               a.sigma == b.sigma && a.n_paths == b.n_paths && a.seed == b.seed && a.mode == b.mode;
+    }
+
+    void put_double(std::ostringstream& os, double v) {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), " %a", v);
+        os << buf;
+    }
+
+    bool get_double(std::istringstream& is, double& v) {
+        std::string tok;
+        if (!(is >> tok)) return false;
+        char* end = nullptr;
+        v = std::strtod(tok.c_str(), &end);
+        return end == tok.c_str() + tok.size();
+    }
+}
+
+void mcShardRange(std::size_t n_paths, std::size_t shard, std::size_t n_shards,
+                  std::size_t& first, std::size_t& last) {
+    const std::size_t blocks = mcBlockCount(n_paths);
+    if (n_shards == 0 || shard >= n_shards) {
+        first = last = blocks;
+        return;
+    }
+    // The first blocks % n_shards shards take one extra block
+    const std::size_t base = blocks / n_shards, extra = blocks % n_shards;
+    first = shard * base + std::min(shard, extra);
+    last = first + base + (shard < extra ? 1 : 0);
+}
+
+MCShardState mcRunBlocks(const MCJob& job, std::size_t first_block, std::size_t last_block,
+                         ScratchArena& arena) {
+    MCShardState s;
+    s.job = job;
+    last_block = std::min(last_block, mcBlockCount(job.n_paths));
+    s.first_block = std::min(first_block, last_block);
+
+    s.blocks.reserve(last_block - s.first_block);
+    for (std::size_t b = s.first_block; b < last_block; b++) {
+        s.blocks.push_back(job.is_call
+            ? mcCallBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena)
+            : mcPutBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena));
+    }
+    return s;
+}
+
+bool mcMergeShards(MCShardState& into, const MCShardState& from) {
+    if (!same_run(into.job, from.job)) return false;
+    if (from.blocks.empty()) return true;
+    if (into.blocks.empty()) {
+        into.first_block = from.first_block;
+        into.blocks = from.blocks;
+        return true;
+    }
+
+    if (from.first_block == into.endBlock()) {
+        into.blocks.insert(into.blocks.end(), from.blocks.begin(), from.blocks.end());
+    } else if (from.endBlock() == into.first_block) {
+        into.blocks.insert(into.blocks.begin(), from.blocks.begin(), from.blocks.end());
+        into.first_block = from.first_block;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+MCResult mcFinalize(const MCShardState& state) {
+    MCPartial total;
+    for (const MCPartial& p : state.blocks) mcMerge(total, p);
+    return mcFinalize(total);
+}
+
+std::string mcSerializeShard(const MCShardState& state) {
+    const MCJob& j = state.job;
+    std::ostringstream os;
+    os << kMagic << ' ' << kFormatVersion << ' ' << kMCEngineVersion << '\n';
+    os << "job " << (j.is_call ? "call" : "put");
+    put_double(os, j.S); put_double(os, j.K); put_double(os, j.T);
+    put_double(os, j.r); put_double(os, j.sigma);
+    os << ' ' << j.n_paths << ' ' << j.seed << ' ' << static_cast<int>(j.mode) << '\n';
+    os << "blocks " << state.first_block << ' ' << state.blocks.size() << '\n';
+    for (const MCPartial& p : state.blocks) {
+        os << (p.control ? 1 : 0) << ' ' << p.n << ' ' << p.batches;
+        put_double(os, p.control_mean);
+        put_double(os, p.mean); put_double(os, p.M2);
+        put_double(os, p.meanY); put_double(os, p.M2Y); put_double(os, p.C);
+        os << '\n';
+    }
+    return os.str();
+}
+
+bool mcParseShard(const std::string& text, MCShardState& out) {
+    std::istringstream is(text);
+    std::string word, type;
+    int version = 0, mode = 0;
+    std::uint32_t engine = 0;
+    MCShardState s;
+    MCJob& j = s.job;
+
+    // Blocks simulated by another engine version do not merge with this one's
+    if (!(is >> word >> version >> engine) || word != kMagic || version != kFormatVersion ||
+        engine != kMCEngineVersion) return false;
+    if (!(is >> word >> type) || word != "job" || (type != "call" && type != "put")) return false;
+    j.is_call = (type == "call");
+    if (!get_double(is, j.S) || !get_double(is, j.K) || !get_double(is, j.T) ||
+        !get_double(is, j.r) || !get_double(is, j.sigma)) return false;
+    if (!(is >> j.n_paths >> j.seed >> mode)) return false;
+    if (mode < 0 || mode > static_cast<int>(MCMode::AntitheticMartingale)) return false;
+    j.mode = static_cast<MCMode>(mode);
+
+    std::size_t count = 0;
+    if (!(is >> word >> s.first_block >> count) || word != "blocks") return false;
+    // n_paths and count come from the file: bound both before allocating
+    const std::size_t blocks = mcBlockCount(j.n_paths);
+    const std::streamoff pos = is.tellg();
+    const std::size_t remaining = pos < 0 ? 0 : text.size() - static_cast<std::size_t>(pos);
+    if (count > blocks || s.first_block > blocks - count || count > remaining / kMinBlockChars) return false;
+
+    s.blocks.resize(count);
+    for (MCPartial& p : s.blocks) {
+        int control = 0;
+        if (!(is >> control >> p.n >> p.batches)) return false;
+        p.control = (control != 0);
+        if (!get_double(is, p.control_mean) || !get_double(is, p.mean) || !get_double(is, p.M2) ||
+            !get_double(is, p.meanY) || !get_double(is, p.M2Y) || !get_double(is, p.C)) return false;
+    }
+
+    out = std::move(s);
+    return true;
+}
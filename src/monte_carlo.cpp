@@ -1,236 +1,691 @@
 #include "monte_carlo.h"
 #include "utils.h"
 #include "black_scholes.h"
+#include "pricing_session.h"
+#include "cpu_dispatch.h"
+#include "term_structure.h"
+#include "normal_pool.h"
 
 #include <cmath>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 
 namespace {
-    struct RunningStats {
-        std::size_t n = 0;
-        double mean = 0.0;
-        double M2 = 0.0;
+    inline double variance_unbiased(const MCPartial& p) {
+        return (p.n > 1) ? (p.M2 / static_cast<double>(p.n - 1)) : 0.0;
+    }
 
-        void push(double x) {
-            n++;
-            const double dn = static_cast<double>(n);
-            const double delta = x - mean;
-            mean += delta / dn;
-            const double delta2 = x - mean;
-            M2 += delta * delta2;
-        }
+    // 97.5% quantile of Student's t with `dof` degrees of freedom: tabulated
+    // up to 30, then the Cornish-Fisher expansion in 1/dof (error < 1e-7)
+    double student_t975(std::size_t dof) {
+        static const double kTable[30] = {
+            12.706204736, 4.302652730, 3.182446305, 2.776445105, 2.570581836, 2.446911851,
+            2.364624252, 2.306004135, 2.262157163, 2.228138852, 2.200985160, 2.178812830,
+            2.160368656, 2.144786688, 2.131449546, 2.119905299, 2.109815578, 2.100922040,
+            2.093024054, 2.085963447, 2.079613845, 2.073873068, 2.068657610, 2.063898562,
+            2.059538553, 2.055529439, 2.051830516, 2.048407142, 2.045229642, 2.042272456};
+        if (dof >= 1 && dof <= 30) return kTable[dof - 1];
+        const double z = 1.959963984540054, z2 = z * z, v = static_cast<double>(dof);
+        const double g1 = z * (z2 + 1.0) / 4.0;
+        const double g2 = z * ((5.0 * z2 + 16.0) * z2 + 3.0) / 96.0;
+        const double g3 = z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / 384.0;
+        const double g4 = z * ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) / 92160.0;
+        return z + (g1 + (g2 + (g3 + g4 / v) / v) / v) / v;
+    }
 
-        double variance_unbiased() const {
-            return (n > 1) ? (M2 / static_cast<double>(n - 1)) : 0.0;
-        }
-    };
+    inline MCResult report(double price, double stderr, double z = 1.959963984540054) {
+        // 95% CI, normal approximation unless the caller passes a t quantile
+        const double ci_low = price - z * stderr;
+        const double ci_high = price + z * stderr;
 
-    inline double terminal_price(double S, double T, double r, double sigma, double Z) {
-        const double drift = (r - 0.5 * sigma * sigma) * T;
-        const double diffusion = sigma * std::sqrt(T) * Z;
-        return S * std::exp(drift + diffusion);
+        return {price, stderr, ci_low, ci_high};
     }
 
-    inline MCResult finalize(double df, const RunningStats& stats) {
-        const double var = stats.variance_unbiased();
+    inline MCResult finalize(double df, const MCPartial& stats) {
+        const double var = variance_unbiased(stats);
         const double price = df * stats.mean;
         const double stderr = df * std::sqrt(var / static_cast<double>(stats.n));
+        return report(price, stderr);
+    }
 
-        // 95% CI using normal approximation
-        const double z = 1.959963984540054; 
-        const double ci_low = price - z * stderr;
-        const double ci_high = price + z * stderr;
+    struct CallPayoff {
+        static constexpr bool is_call = true;
+        template <typename Real>
+        Real operator()(Real ST, Real K) const { return std::max(ST - K, Real(0)); }
+    };
 
-        return {price, stderr, ci_low, ci_high};
+    struct PutPayoff {
+        static constexpr bool is_call = false;
+        template <typename Real>
+        Real operator()(Real ST, Real K) const { return std::max(K - ST, Real(0)); }
+    };
+
+    inline bool uses_antithetic(MCMode mode) {
+        return mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS ||
+               mode == MCMode::AntitheticImportance || mode == MCMode::AntitheticMomentMatching ||
+               mode == MCMode::AntitheticMartingale;
     }
 
-    inline double payoff_call(double ST, double K) { return std::max(ST - K, 0.0); }
-    inline double payoff_put (double ST, double K) { return std::max(K - ST, 0.0); }
+    inline bool uses_control(MCMode mode) {
+        return mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS;
+    }
 
-    struct ControlVarSums {
-        std::size_t n = 0;
-        double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumYY = 0.0, sumXY = 0.0;
+    inline bool uses_importance(MCMode mode) {
+        return mode == MCMode::ImportanceSampling || mode == MCMode::AntitheticImportance;
+    }
+
+    inline bool uses_moment_matching(MCMode mode) {
+        return mode == MCMode::MomentMatching || mode == MCMode::AntitheticMomentMatching;
+    }
+
+    inline bool uses_martingale(MCMode mode) {
+        return mode == MCMode::MartingaleCorrection || mode == MCMode::AntitheticMartingale;
+    }
 
-        void push(double X, double Y) {
-            n++;
-            sumX += X; sumY += Y;
-            sumXX += X * X;
-            sumYY += Y * Y;
-            sumXY += X * Y;
+    // Standardises a block of normals in place to sample mean 0 and
+    // (population) variance 1; antithetic pairs Z, -Z already have mean 0,
+    // so only their scale is matched
+    template <typename Real>
+    void moment_match(Real* Z, std::size_t n, bool antithetic) {
+        double m = 0.0;
+        if (!antithetic) {
+            double s = 0.0;
+            for (std::size_t i = 0; i < n; i++) s += static_cast<double>(Z[i]);
+            m = s / static_cast<double>(n);
+        }
+        double ss = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            const double d = static_cast<double>(Z[i]) - m;
+            ss += d * d;
         }
+        if (!(ss > 0.0)) return;
+        const double inv_sd = 1.0 / std::sqrt(ss / static_cast<double>(n));
+        for (std::size_t i = 0; i < n; i++) Z[i] = static_cast<Real>((static_cast<double>(Z[i]) - m) * inv_sd);
+    }
 
-        double meanX() const { return sumX / static_cast<double>(n); }
-        double meanY() const { return sumY / static_cast<double>(n); }
+    // Spot scale of the empirical martingale correction: target / block mean
+    // of the discounted terminal prices Y
+    template <typename Real>
+    double martingale_scale(const Real* Y, std::size_t n, double target) {
+        double s = 0.0;
+        for (std::size_t i = 0; i < n; i++) s += static_cast<double>(Y[i]);
+        return (s > 0.0) ? target * static_cast<double>(n) / s : 1.0;
+    }
 
-        double varY_unbiased() const {
-            if (n < 2) return 0.0;
-            const double n_d = static_cast<double>(n);
-            const double meanYv = sumY / n_d;
-            const double ss = sumYY - n_d * meanYv * meanYv;
-            return ss / static_cast<double>(n - 1);
+    // Importance-sampling shift for S_T = S exp(drift + vol_sqrtT z): the
+    // maximiser of log(payoff(z)) - z^2 / 2. With zK the strike in z units it
+    // solves, for u = z - zK > 0 (call) or u = zK - z > 0 (put),
+    //   call: b / (1 - e^{-b u}) = zK + u,   put: b / (e^{b u} - 1) = u - zK,
+    // whose left sides fall and right sides rise in u, so bisection on the
+    // bracket below converges to the unique root.
+    double importance_shift(bool is_call, double S, double K, double drift, double vol_sqrtT) {
+        if (!(vol_sqrtT > 0.0)) return 0.0;
+        const double b = vol_sqrtT;
+        const double zK = (std::log(K / S) - drift) / b;
+
+        double lo = 0.0;
+        double hi = is_call ? std::max(-zK, 0.0) + b + 2.0 : std::max(zK, 0.0) + 2.0;
+        for (int it = 0; it < 200 && hi - lo > 1e-12 * hi; it++) {
+            const double u = 0.5 * (lo + hi);
+            const double g = is_call ? b / -std::expm1(-b * u) - (zK + u)
+                                     : b / std::expm1(b * u) - (u - zK);
+            if (g > 0.0) lo = u;
+            else         hi = u;
         }
+        const double u = 0.5 * (lo + hi);
+        return is_call ? zK + u : zK - u;
+    }
 
-        double covXY_unbiased() const {
-            if (n < 2) return 0.0;
-            const double n_d = static_cast<double>(n);
-            const double meanXv = sumX / n_d;
-            const double meanYv = sumY / n_d;
-            const double ss = sumXY - n_d * meanXv * meanYv;
-            return ss / static_cast<double>(n - 1);
+    // Block outputs into the partial's means and centred moments: two
+    // passes over the stored samples in the dispatched kernel (independent
+    // partial sums, no division per sample)
+    void accumulate_block(const double* X, const double* Y, std::size_t n, MCPartial& out) {
+        out.n = n;
+        if (n == 0) return;
+        double m[5];
+        if (!out.control) {
+            kernels().block_moments(X, nullptr, n, m);
+            out.mean = m[0];
+            out.M2 = m[1];
+            return;
         }
-    };
-}
+        kernels().block_moments(X, Y, n, m);
+        out.mean = m[0]; out.meanY = m[1];
+        out.M2 = m[2]; out.M2Y = m[3]; out.C = m[4];
+    }
 
-MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
-                     std::size_t n_paths, std::uint64_t seed, MCMode mode) {
-    if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
+    // Batch-means modes: the block is one batch and its mean the only
+    // statistic; merging builds M2 between block means
+    void accumulate_batch(const double* X, std::size_t n, MCPartial& out) {
+        accumulate_block(X, nullptr, n, out);
+        out.M2 = 0.0;
+        out.batches = 1;
+    }
 
-    if (T == 0.0) {
-        const double p = std::max(S - K, 0.0);
-        return {p, 0.0, p, p};
+    // Normals [first, first + n) of the seed's stream: read in place from the
+    // installed pool when it holds them (copied to `buf` if the caller
+    // rewrites them), else generated into `buf`
+    const double* seeded_normals(std::uint64_t seed, std::uint64_t first, std::size_t n,
+                                 double* buf, bool writable) {
+        const NormalPool* pool = mcNormalPool();
+        if (const double* z = pool ? pool->normals(seed, first, n) : nullptr) {
+            if (!writable) return z;
+            std::memcpy(buf, z, n * sizeof(double));
+            return buf;
+        }
+        std::uint64_t state = seed;
+        rand_skip_normals(state, first);
+        rand_standard_normal_fill(state, buf, n);
+        return buf;
     }
 
-    const double df = std::exp(-r * T);
-    std::uint64_t state = seed;
+    // Simulates one path block of a seeded run into a mergeable partial
+    template <typename Real, typename Payoff>
+    MCPartial mc_block(double S, double K, double T, double r, double sigma,
+                       std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                       std::size_t block, ScratchArena& arena) {
+        const bool useAnti = uses_antithetic(mode);
+        const bool useCV   = uses_control(mode);
+
+        MCPartial out;
+        out.control = useCV;
+        out.control_mean = S;
+
+        const std::size_t first = block * kMCBlockPaths;
+        if (first >= n_paths) return out;
+        const std::size_t n = std::min(kMCBlockPaths, n_paths - first);
+
+        // Per-run constants in double, rounded once to the kernel type
+        const Real df = static_cast<Real>(std::exp(-r * T));
+        const Real drift = static_cast<Real>((r - 0.5 * sigma * sigma) * T);
+        const Real vol_sqrtT = static_cast<Real>(sigma * std::sqrt(T));
+        const double shift = uses_importance(mode)
+            ? importance_shift(Payoff::is_call, S, K, (r - 0.5 * sigma * sigma) * T, sigma * std::sqrt(T))
+            : 0.0;
+
+        // Block buffers live in the caller's arena and are released on return
+        const ScratchArena::Marker mark = arena.mark();
+        Real* Zbuf = arena.allocArray<Real>(n);
+        Real* X = arena.allocArray<Real>(n);
+        Real* Y = arena.allocArray<Real>(n);
+
+        const Real* Z = Zbuf;
+        if constexpr (std::is_same<Real, double>::value) {
+            Z = seeded_normals(seed, first, n, Zbuf, uses_moment_matching(mode));
+        } else {
+            std::uint64_t state = seed;
+            rand_skip_normals(state, first);
+            rand_standard_normal_fill_t<Real>(state, Zbuf, n);
+        }
+        if (uses_moment_matching(mode)) moment_match(Zbuf, n, useAnti);
+
+        // Discounted payoff X and discounted terminal price Y (the control)
+        // per draw, from the dispatched kernel of the run's precision
+        auto simulate = [&](double spot) {
+            if constexpr (std::is_same<Real, double>::value) {
+                kernels().mc_paths(Z, n, spot, K, drift, vol_sqrtT, df, useAnti, Payoff::is_call, shift, X, Y);
+            } else {
+                kernels().mc_paths_f(Z, n, static_cast<float>(spot), static_cast<float>(K), drift, vol_sqrtT,
+                                     df, useAnti, Payoff::is_call, static_cast<float>(shift), X, Y);
+            }
+        };
+        simulate(S);
+        // Scaling every S_T of the block is simulating it from a scaled spot
+        if (uses_martingale(mode)) simulate(S * martingale_scale(Y, n, S));
+
+        const double* Xd;
+        const double* Yd;
+        if constexpr (std::is_same<Real, double>::value) {
+            Xd = X;
+            Yd = Y;
+        } else {
+            // Statistics always in double
+            double* Xc = arena.allocArray<double>(n);
+            double* Yc = arena.allocArray<double>(n);
+            for (std::size_t i = 0; i < n; i++) {
+                Xc[i] = static_cast<double>(X[i]);
+                Yc[i] = static_cast<double>(Y[i]);
+            }
+            Xd = Xc;
+            Yd = Yc;
+        }
+        if (uses_moment_matching(mode) || uses_martingale(mode)) accumulate_batch(Xd, n, out);
+        else accumulate_block(Xd, Yd, n, out);
 
-    const bool useAnti = (mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS);
-    const bool useCV   = (mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS);
+        arena.rewind(mark);
+        return out;
+    }
 
-    ControlVarSums cv;
-    RunningStats stats;
+    // Block on term-structure curves. Over any time grid a path's log-return
+    // is sum_i drift_i + sum_i diffusion_i Z_i = drift + sqrt(w) xi with xi
+    // standard normal, and the European payoff sees nothing else, so path p
+    // draws only xi = normal p of the stream and the dispatched kernel
+    // prices the block from the totals to expiry: drift = int (r - q) -
+    // w / 2, w = int sigma^2.
+    template <typename Payoff>
+    MCPartial mc_curve_block(double X0, double K, double drift, double w, double df, double control_mean,
+                             std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                             std::size_t block, ScratchArena& arena) {
+        const bool useAnti = uses_antithetic(mode);
+        const bool useCV   = uses_control(mode);
+
+        MCPartial out;
+        out.control = useCV;
+        out.control_mean = control_mean;
+
+        const std::size_t first = block * kMCBlockPaths;
+        if (first >= n_paths) return out;
+        const std::size_t n = std::min(kMCBlockPaths, n_paths - first);
+        const double vol = std::sqrt(w);
+        const double shift = uses_importance(mode)
+            ? importance_shift(Payoff::is_call, X0, K, drift, vol)
+            : 0.0;
+
+        const ScratchArena::Marker mark = arena.mark();
+        double* Zbuf = arena.allocArray<double>(n);
+        double* X = arena.allocArray<double>(n);
+        double* Y = arena.allocArray<double>(n);
+
+        const double* xi = seeded_normals(seed, first, n, Zbuf, uses_moment_matching(mode));
+        if (uses_moment_matching(mode)) moment_match(Zbuf, n, useAnti);
+        kernels().mc_paths(xi, n, X0, K, drift, vol, df, useAnti, Payoff::is_call, shift, X, Y);
+        if (uses_martingale(mode)) {
+            const double spot = X0 * martingale_scale(Y, n, control_mean);
+            kernels().mc_paths(xi, n, spot, K, drift, vol, df, useAnti, Payoff::is_call, shift, X, Y);
+        }
 
-    for (std::size_t i = 0; i < n_paths; i++) {
-        const double Z = rand_standard_normal(state);
+        if (uses_moment_matching(mode) || uses_martingale(mode)) accumulate_batch(X, n, out);
+        else accumulate_block(X, Y, n, out);
 
-        const double ST1 = terminal_price(S, T, r, sigma,  Z);
-        const double payoff1 = payoff_call(ST1, K);
-        double X = df * payoff1;
-        double Y = df * ST1;
+        arena.rewind(mark);
+        return out;
+    }
 
-        if (useAnti) {
-            const double ST2 = terminal_price(S, T, r, sigma, -Z);
-            const double payoff2 = payoff_call(ST2, K);
-            const double X2 = df * payoff2;
-            const double Y2 = df * ST2;
+    template <typename Payoff>
+    MCResult mc_curve_price(double S, double K, double T, const MarketCurves& curves,
+                            std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                            Payoff payoff, ScratchArena& arena) {
+        if (S <= 0.0 || K <= 0.0 || T < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
 
-            X = 0.5 * (X + X2);
-            Y = 0.5 * (Y + Y2);
+        if (T == 0.0) {
+            const double p = payoff(S, K);
+            return {p, 0.0, p, p};
         }
 
-        if (useCV) cv.push(X, Y);
-        else stats.push(X);
+        // Escrowed spot: cash dividends up to T leave the diffusing part
+        const double X0 = S - curves.dividendPV(T);
+        const double w = curves.totalVariance(T);
+        if (!(X0 > 0.0) || !(w >= 0.0)) return {NAN, NAN, NAN, NAN};
+
+        // E[df S_T] = df F(T) = X0 e^{-int q}
+        const double q_int = curves.dividends().yieldIntegral(T);
+        const double drift = curves.rates().rateIntegral(T) - q_int - 0.5 * w;
+        const double df = curves.discount(T);
+        const double control_mean = X0 * std::exp(-q_int);
+
+        MCPartial total;
+        const std::size_t blocks = mcBlockCount(n_paths);
+        for (std::size_t b = 0; b < blocks; b++) {
+            mcMerge(total, mc_curve_block<Payoff>(X0, K, drift, w, df, control_mean, n_paths, seed, mode, b, arena));
+        }
+        return mcFinalize(total);
     }
 
-    if (!useCV) {
-        return finalize(1.0, stats); 
+    template <typename Real, typename Payoff>
+    MCResult mc_price(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode, ScratchArena& arena) {
+        MCPartial total;
+        const std::size_t blocks = mcBlockCount(n_paths);
+        for (std::size_t b = 0; b < blocks; b++) {
+            mcMerge(total, mc_block<Real, Payoff>(S, K, T, r, sigma, n_paths, seed, mode, b, arena));
+        }
+        return mcFinalize(total);
     }
 
-    const double EY = S; 
-    const double varY = cv.varY_unbiased();
-    const double covXY = cv.covXY_unbiased();
-    const double b = (varY > 0.0) ? (covXY / varY) : 0.0;
+    // One GBM step of the MLMC schemes
+    inline double gbm_step(double S, double r, double sigma, double h, double dW, MLMCScheme scheme) {
+        double next = S + r * S * h + sigma * S * dW;
+        if (scheme == MLMCScheme::Milstein) next += 0.5 * sigma * sigma * S * (dW * dW - h);
+        return next;
+    }
 
-    RunningStats controlled;
-    // Re-run stream deterministically for controlled samples 
-    state = seed;
-    for (std::size_t i = 0; i < n_paths; i++) {
-        const double Z = rand_standard_normal(state);
+    // Path state of one MLMC grid: terminal spot and trapezoid integral of S
+    struct MLMCPath {
+        double S, integral;
 
-        const double ST1 = terminal_price(S, T, r, sigma,  Z);
-        const double payoff1 = payoff_call(ST1, K);
-        double X = df * payoff1;
-        double Y = df * ST1;
+        void step(double r, double sigma, double h, double dW, MLMCScheme scheme) {
+            const double next = gbm_step(S, r, sigma, h, dW, scheme);
+            integral += 0.5 * (S + next) * h;
+            S = next;
+        }
+    };
 
-        if (useAnti) {
-            const double ST2 = terminal_price(S, T, r, sigma, -Z);
-            const double payoff2 = payoff_call(ST2, K);
-            const double X2 = df * payoff_call(ST2, K);
-            const double Y2 = df * ST2;
+    inline double mlmc_payoff(MLMCPayoff payoff, const MLMCPath& p, double K, double T) {
+        switch (payoff) {
+            case MLMCPayoff::EuropeanCall: return std::max(p.S - K, 0.0);
+            case MLMCPayoff::EuropeanPut:  return std::max(K - p.S, 0.0);
+            case MLMCPayoff::AsianCall:    return std::max(p.integral / T - K, 0.0);
+            default:                       return std::max(K - p.integral / T, 0.0);
+        }
+    }
 
-            X = 0.5 * (X + X2);
-            Y = 0.5 * (Y + Y2);
+    // n more samples of level `level` merged into `stats`, drawing from the
+    // level's own normal stream `state` (fine increments, consecutive per
+    // sample); each chunk is accumulated as a block
+    void mlmc_samples(MLMCPayoff payoff, double S, double K, double T, double r, double sigma,
+                      const MLMCOptions& opt, std::size_t level, std::size_t n,
+                      std::uint64_t& state, MCPartial& stats, ScratchArena& arena) {
+        const std::size_t steps = opt.coarse_steps << level;
+        const double h = T / static_cast<double>(steps);
+        const double sqrt_h = std::sqrt(h);
+        const double df = std::exp(-r * T);
+
+        const std::size_t chunk = std::max<std::size_t>(1, kMCBlockPaths / steps);
+        const ScratchArena::Marker mark = arena.mark();
+        double* Z = arena.allocArray<double>(chunk * steps);
+        double* V = arena.allocArray<double>(chunk);
+
+        for (std::size_t done = 0; done < n; ) {
+            const std::size_t m = std::min(chunk, n - done);
+            rand_standard_normal_fill(state, Z, m * steps);
+
+            for (std::size_t p = 0; p < m; p++) {
+                const double* z = Z + p * steps;
+                MLMCPath fine{S, 0.0}, coarse{S, 0.0};
+                if (level == 0) {
+                    for (std::size_t j = 0; j < steps; j++) fine.step(r, sigma, h, sqrt_h * z[j], opt.scheme);
+                } else {
+                    for (std::size_t j = 0; j < steps; j += 2) {
+                        const double dW1 = sqrt_h * z[j], dW2 = sqrt_h * z[j + 1];
+                        fine.step(r, sigma, h, dW1, opt.scheme);
+                        fine.step(r, sigma, h, dW2, opt.scheme);
+                        coarse.step(r, sigma, 2.0 * h, dW1 + dW2, opt.scheme);
+                    }
+                }
+
+                double y = mlmc_payoff(payoff, fine, K, T);
+                if (level > 0) y -= mlmc_payoff(payoff, coarse, K, T);
+                V[p] = df * y;
+            }
+            MCPartial part;
+            accumulate_block(V, nullptr, m, part);
+            mcMerge(stats, part);
+            done += m;
         }
 
-        const double Xstar = X - b * (Y - EY);
-        controlled.push(Xstar);
+        arena.rewind(mark);
+    }
+
+    // Scratch for callers that do not pass a session, reused across calls
+    ScratchArena& default_arena() {
+        thread_local ScratchArena arena(std::size_t(1) << 18);
+        return arena;
+    }
+}
+
+std::size_t mcBlockCount(std::size_t n_paths) {
+    return n_paths / kMCBlockPaths + (n_paths % kMCBlockPaths != 0);
+}
+
+MCPartial mcCallBlock(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                      std::size_t block, ScratchArena& arena) {
+    return mc_block<double, CallPayoff>(S, K, T, r, sigma, n_paths, seed, mode, block, arena);
+}
+
+MCPartial mcPutBlock(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     std::size_t block, ScratchArena& arena) {
+    return mc_block<double, PutPayoff>(S, K, T, r, sigma, n_paths, seed, mode, block, arena);
+}
+
+void mcMerge(MCPartial& into, const MCPartial& from) {
+    if (from.n == 0) return;
+    if (into.n == 0) {
+        into = from;
+        return;
+    }
+    // Chan et al. pairwise update, extended to the co-moment
+    const double na = static_cast<double>(into.n), nb = static_cast<double>(from.n);
+    const double n = na + nb;
+    const double w = na * nb / n;
+    const double dx = from.mean - into.mean;
+    into.mean += dx * (nb / n);
+    into.M2 += from.M2 + dx * dx * w;
+    if (into.control) {
+        const double dy = from.meanY - into.meanY;
+        into.meanY += dy * (nb / n);
+        into.M2Y += from.M2Y + dy * dy * w;
+        into.C += from.C + dx * dy * w;
+    }
+    into.n += from.n;
+    into.batches += from.batches;
+}
+
+MCPartial mcAccumulate(const double* X, const double* Y, std::size_t n,
+                       bool control, double control_mean) {
+    MCPartial out;
+    out.control = control;
+    out.control_mean = control_mean;
+    accumulate_block(X, Y, n, out);
+    return out;
+}
+
+MCResult mcFinalize(const MCPartial& p) {
+    if (p.n < 2) return {NAN, NAN, NAN, NAN};
+    if (p.batches > 0) {
+        // Batch means: M2 holds sum_b n_b (m_b - m)^2
+        if (p.batches < 2) return {p.mean, NAN, NAN, NAN};
+        const double B = static_cast<double>(p.batches), N = static_cast<double>(p.n);
+        // Only B - 1 degrees of freedom behind the stderr: t quantile
+        return report(p.mean, std::sqrt(p.M2 / (N * (B - 1.0))), student_t975(p.batches - 1));
     }
+    if (!p.control) return finalize(1.0, p);
+
+    // Control variate with the optimal coefficient b = cov(X,Y)/var(Y):
+    // X* = X - b (Y - E[Y]), var(X*) = var(X) - 2 b cov + b^2 var(Y)
+    const double n1 = static_cast<double>(p.n - 1);
+    const double varY = p.M2Y / n1;
+    const double covXY = p.C / n1;
+    const double b = (varY > 0.0) ? (covXY / varY) : 0.0;
+
+    MCPartial controlled;
+    controlled.n = p.n;
+    controlled.mean = p.mean - b * (p.meanY - p.control_mean);
+    const double var = std::max(p.M2 / n1 - 2.0 * b * covXY + b * b * varY, 0.0);
+    controlled.M2 = var * n1;
 
     // finalize with df=1 because samples are already discounted
     return finalize(1.0, controlled);
 }
 
+MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mcCallPrice(S, K, T, r, sigma, n_paths, seed, mode, default_arena());
+}
+
 MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
                     std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mcPutPrice(S, K, T, r, sigma, n_paths, seed, mode, default_arena());
+}
+
+MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     PricingSession& session) {
+    return mcCallPrice(S, K, T, r, sigma, n_paths, seed, mode, session.arena());
+}
+
+MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
+                    std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                    PricingSession& session) {
+    return mcPutPrice(S, K, T, r, sigma, n_paths, seed, mode, session.arena());
+}
+
+MCResult mcCallPrice(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     ScratchArena& arena) {
     if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
 
     if (T == 0.0) {
-        const double p = std::max(K - S, 0.0);
+        const double p = std::max(S - K, 0.0);
         return {p, 0.0, p, p};
     }
 
-    const double df = std::exp(-r * T);
-    std::uint64_t state = seed;
+    return mc_price<double, CallPayoff>(S, K, T, r, sigma, n_paths, seed, mode, arena);
+}
 
-    const bool useAnti = (mode == MCMode::Antithetic || mode == MCMode::AntitheticControlBS);
-    const bool useCV   = (mode == MCMode::ControlVariateBS || mode == MCMode::AntitheticControlBS);
+MCResult mcPutPrice(double S, double K, double T, double r, double sigma,
+                    std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                    ScratchArena& arena) {
+    if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
 
-    ControlVarSums cv;
-    RunningStats stats;
+    if (T == 0.0) {
+        const double p = std::max(K - S, 0.0);
+        return {p, 0.0, p, p};
+    }
 
-    for (std::size_t i = 0; i < n_paths; i++) {
-        const double Z = rand_standard_normal(state);
+    return mc_price<double, PutPayoff>(S, K, T, r, sigma, n_paths, seed, mode, arena);
+}
 
-        const double ST1 = terminal_price(S, T, r, sigma,  Z);
-        const double payoff1 = payoff_put(ST1, K);
-        double X = df * payoff1;
-        double Y = df * ST1;
+MCResult mcCallPrice(double S, double K, double T, const MarketCurves& curves,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mc_curve_price(S, K, T, curves, n_paths, seed, mode, CallPayoff{}, default_arena());
+}
 
-        if (useAnti) {
-            const double ST2 = terminal_price(S, T, r, sigma, -Z);
-            const double payoff2 = payoff_put(ST2, K);
-            const double X2 = df * payoff2;
-            const double Y2 = df * ST2;
+MCResult mcPutPrice(double S, double K, double T, const MarketCurves& curves,
+                    std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mc_curve_price(S, K, T, curves, n_paths, seed, mode, PutPayoff{}, default_arena());
+}
 
-            X = 0.5 * (X + X2);
-            Y = 0.5 * (Y + Y2);
-        }
+template <typename Real>
+MCResult mcCallPriceT(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                      ScratchArena& arena) {
+    if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
 
-        if (useCV) cv.push(X, Y);
-        else stats.push(X);
+    if (T == 0.0) {
+        const double p = std::max(S - K, 0.0);
+        return {p, 0.0, p, p};
     }
 
-    if (!useCV) {
-        return finalize(1.0, stats);
+    return mc_price<Real, CallPayoff>(S, K, T, r, sigma, n_paths, seed, mode, arena);
+}
+
+template <typename Real>
+MCResult mcPutPriceT(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode,
+                     ScratchArena& arena) {
+    if (S <= 0.0 || K <= 0.0 || T < 0.0 || sigma < 0.0 || n_paths < 2) return {NAN, NAN, NAN, NAN};
+
+    if (T == 0.0) {
+        const double p = std::max(K - S, 0.0);
+        return {p, 0.0, p, p};
     }
 
-    const double EY = S; 
-    const double varY = cv.varY_unbiased();
-    const double covXY = cv.covXY_unbiased();
-    const double b = (varY > 0.0) ? (covXY / varY) : 0.0;
+    return mc_price<Real, PutPayoff>(S, K, T, r, sigma, n_paths, seed, mode, arena);
+}
 
-    RunningStats controlled;
-    state = seed;
-    for (std::size_t i = 0; i < n_paths; i++) {
-        const double Z = rand_standard_normal(state);
+template <typename Real>
+MCResult mcCallPriceT(double S, double K, double T, double r, double sigma,
+                      std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mcCallPriceT<Real>(S, K, T, r, sigma, n_paths, seed, mode, default_arena());
+}
 
-        const double ST1 = terminal_price(S, T, r, sigma,  Z);
-        const double payoff1 = payoff_put(ST1, K);
-        double X = df * payoff1;
-        double Y = df * ST1;
+template <typename Real>
+MCResult mcPutPriceT(double S, double K, double T, double r, double sigma,
+                     std::size_t n_paths, std::uint64_t seed, MCMode mode) {
+    return mcPutPriceT<Real>(S, K, T, r, sigma, n_paths, seed, mode, default_arena());
+}
 
-        if (useAnti) {
-            const double ST2 = terminal_price(S, T, r, sigma, -Z);
-            const double payoff2 = payoff_put(ST2, K);
-            const double X2 = df * payoff2;
-            const double Y2 = df * ST2;
+template MCResult mcCallPriceT<float>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode, ScratchArena&);
+template MCResult mcCallPriceT<double>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode, ScratchArena&);
+template MCResult mcPutPriceT<float>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode, ScratchArena&);
+template MCResult mcPutPriceT<double>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode, ScratchArena&);
+template MCResult mcCallPriceT<float>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode);
+template MCResult mcCallPriceT<double>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode);
+template MCResult mcPutPriceT<float>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode);
+template MCResult mcPutPriceT<double>(double, double, double, double, double, std::size_t, std::uint64_t, MCMode);
+
+MLMCResult mlmcPrice(MLMCPayoff payoff, double S, double K, double T, double r, double sigma,
+                     std::uint64_t seed, const MLMCOptions& options) {
+    MLMCResult out;
+    out.result = {NAN, NAN, NAN, NAN};
+    MLMCOptions opt = options;
+    // The bias test reads the last two corrections, levels 1 and up
+    opt.min_levels = std::max<std::size_t>(opt.min_levels, 3);
+    opt.max_levels = std::min<std::size_t>(std::max(opt.max_levels, opt.min_levels), 30);
+    if (S <= 0.0 || K <= 0.0 || T <= 0.0 || sigma < 0.0 || !(opt.target_rmse > 0.0) ||
+        opt.coarse_steps == 0 || opt.initial_paths < 2) {
+        return out;
+    }
 
-            X = 0.5 * (X + X2);
-            Y = 0.5 * (Y + Y2);
+    const double eps2 = opt.target_rmse * opt.target_rmse;
+    std::vector<MCPartial> stats;
+    std::vector<std::uint64_t> streams;
+    std::vector<std::size_t> extra;
+    ScratchArena& arena = default_arena();
+
+    // Level l draws from its own stream, 2^40 normals past the previous one
+    auto add_level = [&]() {
+        std::uint64_t state = seed;
+        rand_skip_normals(state, static_cast<std::uint64_t>(stats.size()) << 40);
+        stats.emplace_back();
+        streams.push_back(state);
+        extra.push_back(opt.initial_paths);
+    };
+    auto cost_per_sample = [&](std::size_t l) {
+        const double fine = static_cast<double>(opt.coarse_steps << l);
+        return (l == 0) ? fine : 1.5 * fine;
+    };
+    for (std::size_t l = 0; l < opt.min_levels; l++) add_level();
+
+    for (;;) {
+        for (std::size_t l = 0; l < stats.size(); l++) {
+            if (extra[l] > 0) mlmc_samples(payoff, S, K, T, r, sigma, opt, l, extra[l], streams[l], stats[l], arena);
         }
 
-        const double Xstar = X - b * (Y - EY);
-        controlled.push(Xstar);
+        // Samples minimising cost subject to sum V_l / N_l = eps^2 / 2
+        double sum_vc = 0.0;
+        for (std::size_t l = 0; l < stats.size(); l++) {
+            sum_vc += std::sqrt(variance_unbiased(stats[l]) * cost_per_sample(l));
+        }
+        bool sampled = true;
+        for (std::size_t l = 0; l < stats.size(); l++) {
+            const double v = variance_unbiased(stats[l]);
+            const double want = std::ceil(2.0 / eps2 * std::sqrt(v / cost_per_sample(l)) * sum_vc);
+            const std::size_t target = static_cast<std::size_t>(want);
+            extra[l] = (target > stats[l].n) ? target - stats[l].n : 0;
+            if (extra[l] > 0) sampled = false;
+        }
+        if (!sampled) continue;
+
+        // Weak order 1: the remaining bias is about the last correction;
+        // the one before, halved, guards against a lucky small value
+        const std::size_t L = stats.size() - 1;
+        out.bias_estimate = std::max(std::fabs(stats[L].mean), 0.5 * std::fabs(stats[L - 1].mean));
+        if (out.bias_estimate * out.bias_estimate <= 0.5 * eps2) {
+            out.converged = true;
+            break;
+        }
+        if (stats.size() >= opt.max_levels) break;
+        add_level();
     }
 
-    return finalize(1.0, controlled);
+    double price = 0.0, var = 0.0;
+    for (std::size_t l = 0; l < stats.size(); l++) {
+        MLMCLevel lv;
+        lv.steps = opt.coarse_steps << l;
+        lv.samples = stats[l].n;
+        lv.mean = stats[l].mean;
+        lv.variance = variance_unbiased(stats[l]);
+        lv.cost = static_cast<double>(lv.samples) * cost_per_sample(l);
+        out.levels.push_back(lv);
+
+        price += lv.mean;
+        var += lv.variance / static_cast<double>(lv.samples);
+        out.total_cost += lv.cost;
+    }
+    out.result = report(price, std::sqrt(var));
+    return out;
 }
@@ -0,0 +1,160 @@
+// normal_pool.cpp
+
+#include "normal_pool.h"
+#include "monte_carlo.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char kPoolMagic[8] = {'m', 'c', 'n', 'p', 'o', 'o', 'l', '\0'};
+    constexpr std::uint32_t kPoolFormat = 1;
+
+    struct PoolHeader {
+        char magic[8];
+        std::uint32_t format;
+        std::uint32_t version;        // engine version tag: the generator's bits
+        std::uint64_t seed;
+        std::uint64_t count;
+        std::uint64_t reserved[4];
+    };
+
+    static_assert(sizeof(PoolHeader) == 64, "pool header layout");
+
+    std::atomic<const NormalPool*> installed{nullptr};
+    std::atomic<std::uint64_t> temp_serial{0};
+
+    PoolHeader header_for(std::uint64_t seed, std::size_t count) {
+        PoolHeader h{};
+        std::memcpy(h.magic, kPoolMagic, sizeof(kPoolMagic));
+        h.format = kPoolFormat;
+        h.version = kMCEngineVersion;
+        h.seed = seed;
+        h.count = count;
+        return h;
+    }
+
+    // An existing, complete pool for (seed, count)
+    bool matches(const std::string& path, const PoolHeader& want) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        PoolHeader h;
+        struct stat st;
+        const bool ok = ::fstat(fd, &st) == 0 &&
+                        ::pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+                        std::memcmp(&h, &want, sizeof(h)) == 0 &&
+                        static_cast<std::uint64_t>(st.st_size) == sizeof(h) + want.count * sizeof(double);
+        ::close(fd);
+        return ok;
+    }
+
+    // Fills the normals in contiguous ranges, one per thread; every draw
+    // depends only on its index, so the bits do not depend on the split
+    void fill_parallel(std::uint64_t seed, double* out, std::size_t count, std::size_t n_threads) {
+        constexpr std::size_t kMinPerThread = std::size_t(1) << 16;
+        if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+        n_threads = std::max<std::size_t>(1, std::min(n_threads, count / kMinPerThread));
+
+        auto fill = [&](std::size_t t) {
+            const std::size_t begin = count * t / n_threads, end = count * (t + 1) / n_threads;
+            std::uint64_t state = seed;
+            rand_skip_normals(state, begin);
+            rand_standard_normal_fill(state, out + begin, end - begin);
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < n_threads; t++) workers.emplace_back(fill, t);
+        fill(0);
+        for (std::thread& w : workers) w.join();
+    }
+
+    bool generate(const std::string& path, const PoolHeader& h, std::size_t n_threads) {
+        const std::string temp = path + ".tmp." + std::to_string(::getpid()) + "." +
+                                 std::to_string(temp_serial.fetch_add(1));
+        const int fd = ::open(temp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        const std::size_t size = sizeof(h) + h.count * sizeof(double);
+        bool ok = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+        void* map = ok ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ok = map != MAP_FAILED;
+        if (ok) {
+            char* base = static_cast<char*>(map);
+            fill_parallel(h.seed, reinterpret_cast<double*>(base + sizeof(h)), h.count, n_threads);
+            // Header last: a pool is complete once it carries its identity
+            std::memcpy(base, &h, sizeof(h));
+            ::munmap(map, size);
+        }
+        ::close(fd);
+        ok = ok && ::rename(temp.c_str(), path.c_str()) == 0;
+        if (!ok) ::unlink(temp.c_str());
+        return ok;
+    }
+}
+
+NormalPool::~NormalPool() {
+    close();
+}
+
+bool NormalPool::open(const std::string& path, std::uint64_t seed, std::size_t count, std::size_t n_threads) {
+    close();
+    if (count == 0 || count > (SIZE_MAX - sizeof(PoolHeader)) / sizeof(double)) return false;
+
+    const PoolHeader h = header_for(seed, count);
+    bool generated = false;
+    if (!matches(path, h)) {
+        if (!generate(path, h, n_threads)) return false;
+        generated = true;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    const std::size_t size = sizeof(h) + count * sizeof(double);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    // Another process may have replaced the file between the check and the map
+    if (std::memcmp(map, &h, sizeof(h)) != 0) {
+        ::munmap(map, size);
+        return false;
+    }
+
+    map_ = map;
+    map_size_ = size;
+    data_ = reinterpret_cast<const double*>(static_cast<const char*>(map) + sizeof(h));
+    seed_ = seed;
+    count_ = count;
+    generated_ = generated;
+    return true;
+}
+
+void NormalPool::close() {
+    if (map_) ::munmap(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+    data_ = nullptr;
+    seed_ = 0;
+    count_ = 0;
+    generated_ = false;
+}
+
+const double* NormalPool::normals(std::uint64_t seed, std::uint64_t first, std::size_t n) const {
+    if (!data_ || seed != seed_ || first > count_ || n > count_ - first) return nullptr;
+    return data_ + first;
+}
+
+void mcSetNormalPool(const NormalPool* pool) {
+    installed.store(pool, std::memory_order_release);
+}
+
+const NormalPool* mcNormalPool() {
+    return installed.load(std::memory_order_acquire);
+}
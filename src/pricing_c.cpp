@@ -0,0 +1,178 @@
+// pricing_c.cpp
+
+#include "pricing_c.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <new>
+
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "greeks.h"
+#include "implied_vol.h"
+#include "monte_carlo.h"
+#include "pricing_session.h"
+#include "scheduler.h"
+
+struct pricing_context {
+    std::size_t threads = 1;
+    std::unique_ptr<TaskScheduler> pool;   // none when threads == 1
+    std::unique_ptr<PricingSession> session;
+};
+
+namespace {
+    constexpr std::size_t kBSChunk = 512;
+    constexpr std::size_t kIVChunk = 64;
+
+    // Runs body(lo, hi) over [0, n) in chunks on the context's pool, or
+    // inline without one; blocks until every chunk is done
+    template <typename Body>
+    void for_chunks(pricing_context* ctx, std::size_t n, std::size_t chunk, Body body) {
+        const std::size_t chunks = (n + chunk - 1) / chunk;
+        if (!ctx || !ctx->pool || chunks <= 1) {
+            body(std::size_t(0), n);
+            return;
+        }
+        auto done = std::make_shared<JobHandle<bool>::State>();
+        parallelFor(*ctx->pool, chunks,
+            [&](std::size_t c, std::size_t) { body(c * chunk, std::min(n, (c + 1) * chunk)); },
+            [done] { completeJob<bool>(*done, true); });
+        JobHandle<bool>(done).wait();
+    }
+
+    template <typename Fn>
+    pricing_status guarded(Fn fn) {
+        try {
+            fn();
+            return PRICING_OK;
+        } catch (const std::exception&) {
+            return PRICING_ERR_INTERNAL;
+        }
+    }
+}
+
+extern "C" {
+
+uint32_t pricing_abi_version(void) {
+    return (PRICING_ABI_VERSION_MAJOR << 16) | PRICING_ABI_VERSION_MINOR;
+}
+
+const char* pricing_kernel_level(void) {
+    return isaName(activeIsa());
+}
+
+pricing_context* pricing_context_create(size_t n_threads, size_t scratch_bytes) {
+    try {
+        auto ctx = std::make_unique<pricing_context>();
+        PricingSessionOptions opts;
+        if (scratch_bytes > 0) opts.arena_bytes = scratch_bytes;
+        opts.n_workers = 1;
+        ctx->session = std::make_unique<PricingSession>(opts);
+        if (n_threads != 1) {
+            ctx->pool = std::make_unique<TaskScheduler>(n_threads);
+            ctx->threads = ctx->pool->workers();
+        }
+        return ctx.release();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void pricing_context_destroy(pricing_context* ctx) {
+    delete ctx;
+}
+
+size_t pricing_context_threads(const pricing_context* ctx) {
+    return ctx ? ctx->threads : 1;
+}
+
+double pricing_bs_price(int is_call, double S, double K, double T, double r, double sigma) {
+    return is_call ? callPrice(S, K, T, r, sigma) : putPrice(S, K, T, r, sigma);
+}
+
+pricing_status pricing_bs_greeks(int is_call, double S, double K, double T, double r, double sigma,
+                                 pricing_greeks* out) {
+    if (!out) return PRICING_ERR_ARGUMENT;
+    out->delta = is_call ? callDelta(S, K, T, r, sigma) : putDelta(S, K, T, r, sigma);
+    out->gamma = gamma(S, K, T, r, sigma);
+    out->vega = vega(S, K, T, r, sigma);
+    return PRICING_OK;
+}
+
+double pricing_implied_vol(int is_call, double market_price, double S, double K, double T,
+                           double r, double init_sigma, int* iterations) {
+    if (!(init_sigma > 0.0)) init_sigma = 0.2;
+    const IVResult iv = is_call ? impliedVolCall(market_price, S, K, T, r, init_sigma)
+                                : impliedVolPut(market_price, S, K, T, r, init_sigma);
+    if (iterations) *iterations = iv.iterations;
+    return iv.converged ? iv.sigma : NAN;
+}
+
+pricing_status pricing_mc_price(pricing_context* ctx, int is_call, double S, double K, double T,
+                                double r, double sigma, size_t n_paths, uint64_t seed,
+                                pricing_mc_mode mode, pricing_mc_result* out) {
+    if (!out || mode < PRICING_MC_PLAIN || mode > PRICING_MC_ANTITHETIC_MARTINGALE) return PRICING_ERR_ARGUMENT;
+    return guarded([&] {
+        const MCJob job{is_call != 0, S, K, T, r, sigma, n_paths, seed, static_cast<MCMode>(mode)};
+        MCResult res;
+        if (ctx && ctx->pool) {
+            res = submitMC(*ctx->pool, job).get();
+        } else if (ctx) {
+            res = is_call ? mcCallPrice(S, K, T, r, sigma, n_paths, seed, job.mode, *ctx->session)
+                          : mcPutPrice(S, K, T, r, sigma, n_paths, seed, job.mode, *ctx->session);
+        } else {
+            res = is_call ? mcCallPrice(S, K, T, r, sigma, n_paths, seed, job.mode)
+                          : mcPutPrice(S, K, T, r, sigma, n_paths, seed, job.mode);
+        }
+        *out = {res.price, res.stderr, res.ci_low, res.ci_high};
+    });
+}
+
+pricing_status pricing_bs_batch(pricing_context* ctx, size_t n, const uint8_t* is_call,
+                                const double* S, const double* K, const double* T,
+                                const double* r, const double* sigma, double* price,
+                                double* delta, double* gamma_out, double* vega_out) {
+    if (n == 0) return PRICING_OK;
+    if (!is_call || !S || !K || !T || !r || !sigma) return PRICING_ERR_ARGUMENT;
+    return guarded([&] {
+        for_chunks(ctx, n, kBSChunk, [&](std::size_t lo, std::size_t hi) {
+            // Prices through the dispatched batch kernel, one call per run of
+            // equal option type, straight from and into the caller's arrays
+            for (std::size_t i = lo; price && i < hi;) {
+                std::size_t j = i + 1;
+                while (j < hi && (is_call[j] != 0) == (is_call[i] != 0)) j++;
+                if (is_call[i]) callPriceBatch(S + i, K + i, T + i, r + i, sigma + i, price + i, j - i);
+                else            putPriceBatch(S + i, K + i, T + i, r + i, sigma + i, price + i, j - i);
+                i = j;
+            }
+            for (std::size_t i = lo; i < hi; i++) {
+                if (delta) delta[i] = is_call[i] ? callDelta(S[i], K[i], T[i], r[i], sigma[i])
+                                                 : putDelta(S[i], K[i], T[i], r[i], sigma[i]);
+                if (gamma_out) gamma_out[i] = gamma(S[i], K[i], T[i], r[i], sigma[i]);
+                if (vega_out) vega_out[i] = vega(S[i], K[i], T[i], r[i], sigma[i]);
+            }
+        });
+    });
+}
+
+pricing_status pricing_iv_batch(pricing_context* ctx, size_t n, const uint8_t* is_call,
+                                const double* market_price, const double* S, const double* K,
+                                const double* T, const double* r, double* sigma,
+                                int32_t* iterations) {
+    if (n == 0) return PRICING_OK;
+    if (!is_call || !market_price || !S || !K || !T || !r || !sigma) return PRICING_ERR_ARGUMENT;
+    return guarded([&] {
+        for_chunks(ctx, n, kIVChunk, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++) {
+                const IVResult iv = is_call[i] ? impliedVolCall(market_price[i], S[i], K[i], T[i], r[i])
+                                               : impliedVolPut(market_price[i], S[i], K[i], T[i], r[i]);
+                sigma[i] = iv.converged ? iv.sigma : NAN;
+                if (iterations) iterations[i] = iv.iterations;
+            }
+        });
+    });
+}
+
+}  // extern "C"
@@ -0,0 +1,113 @@
+// pricing_session.cpp
+
+#include "pricing_session.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+    constexpr std::size_t kHugePage = std::size_t(2) << 20;
+
+    inline std::size_t round_up(std::size_t x, std::size_t a) { return (x + a - 1) / a * a; }
+}
+
+ScratchArena::ScratchArena(std::size_t initial_bytes, bool huge_pages) : huge_pages_(huge_pages) {
+    add_chunk(std::max<std::size_t>(initial_bytes, kCacheLine));
+}
+
+ScratchArena::~ScratchArena() {
+    for (const Chunk& c : chunks_) {
+#ifdef __linux__
+        if (c.mapped) {
+            munmap(c.base, c.size);
+            continue;
+        }
+#endif
+        ::operator delete(c.base, std::align_val_t(kCacheLine));
+    }
+}
+
+void ScratchArena::add_chunk(std::size_t min_bytes) {
+    const std::size_t last = chunks_.empty() ? 0 : chunks_.back().size;
+    std::size_t size = round_up(std::max(min_bytes, 2 * last), kCacheLine);
+
+#ifdef __linux__
+    if (huge_pages_) {
+        size = round_up(size, kHugePage);
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, size, MADV_HUGEPAGE);   // best effort; falls back to 4K pages
+            chunks_.push_back({static_cast<char*>(p), size, true});
+            return;
+        }
+    }
+#endif
+
+    char* p = static_cast<char*>(::operator new(size, std::align_val_t(kCacheLine)));
+    chunks_.push_back({p, size, false});
+}
+
+void* ScratchArena::allocate(std::size_t bytes, std::size_t align) {
+    bytes = std::max<std::size_t>(bytes, 1);
+
+    for (;;) {
+        const Chunk& c = chunks_[current_];
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(c.base);
+        const std::size_t start = round_up(base + offset_, align) - base;
+        if (start + bytes <= c.size) {
+            offset_ = start + bytes;
+            peak_ = std::max(peak_, bytesInUse());
+            return c.base + start;
+        }
+
+        // Current chunk exhausted: move on to the next retained one, or grow
+        used_before_ += offset_;
+        offset_ = 0;
+        if (current_ + 1 == chunks_.size()) add_chunk(bytes + align);
+        current_++;
+    }
+}
+
+void ScratchArena::rewind(const Marker& m) {
+    current_ = m.chunk;
+    offset_ = m.offset;
+    used_before_ = m.used_before;
+}
+
+std::size_t ScratchArena::reservedBytes() const {
+    std::size_t total = 0;
+    for (const Chunk& c : chunks_) total += c.size;
+    return total;
+}
+
+PricingSession::PricingSession(const PricingSessionOptions& opts)
+    : main_(std::make_unique<ScratchArena>(opts.arena_bytes, opts.huge_pages)) {
+    std::size_t n = opts.n_workers ? opts.n_workers : std::thread::hardware_concurrency();
+    n = std::max<std::size_t>(n, 1);
+    for (std::size_t i = 0; i < n; i++) {
+        workers_.push_back(std::make_unique<ScratchArena>(opts.worker_bytes, opts.huge_pages));
+    }
+}
+
+void PricingSession::reset() {
+    main_->reset();
+    for (auto& w : workers_) w->reset();
+}
+
+std::size_t PricingSession::peakScratchBytes() const {
+    std::size_t total = main_->peakBytes();
+    for (const auto& w : workers_) total += w->peakBytes();
+    return total;
+}
+
+std::size_t PricingSession::reservedBytes() const {
+    std::size_t total = main_->reservedBytes();
+    for (const auto& w : workers_) total += w->reservedBytes();
+    return total;
+}
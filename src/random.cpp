@@ -1,28 +1,51 @@
 #include "utils.h"
+#include "cpu_dispatch.h"
+#include "simd_math.h"
+
 #include <cmath>
 #include <cstdint>
+#include <type_traits>
 
 
 // Standard normal probability distribution fucntion
 
-double normal_pdf(double x) {
-    static const double inv_sqrt_2pi = 0.39894228040143267794;
-    return inv_sqrt_2pi * std::exp(-0.5 * x * x);
+template <typename Real>
+Real normal_pdf_t(Real x) {
+    const Real inv_sqrt_2pi = static_cast<Real>(0.39894228040143267794);
+    return inv_sqrt_2pi * std::exp(Real(-0.5) * x * x);
 }
 
 // Standard normal cumulative distribution function
 
-double normal_cdf(double x) {
-    return 0.5 * std::erfc(-x /std::sqrt(2.0));
+template <typename Real>
+Real normal_cdf_t(Real x) {
+    return Real(0.5) * std::erfc(-x / std::sqrt(Real(2.0)));
+}
+
+template <typename Real>
+Real bs_d1_t(Real S, Real K, Real T, Real r, Real sigma) {
+    const Real vol_sqrtT = sigma * std::sqrt(T);
+    return (std::log(S / K) + (r + Real(0.5) * sigma * sigma) * T) / vol_sqrtT;
+}
+
+template <typename Real>
+Real bs_d2_from_d1_t(Real d1, Real T, Real sigma) {
+    return d1 - sigma * std::sqrt(T);
 }
 
+void normal_cdf_batch(const double* x, double* out, std::size_t n) {
+    kernels().normal_cdf(x, out, n);
+}
+
+double normal_pdf(double x) { return normal_pdf_t<double>(x); }
+double normal_cdf(double x) { return normal_cdf_t<double>(x); }
+
 double bs_d1(double S, double K, double T, double r, double sigma) {
-    const double vol_sqrtT = sigma * std::sqrt(T);
-    return (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / vol_sqrtT;
+    return bs_d1_t<double>(S, K, T, r, sigma);
 }
 
 double bs_d2_from_d1(double d1, double T, double sigma) {
-    return d1 - sigma * std::sqrt(T);
+    return bs_d2_from_d1_t<double>(d1, T, sigma);
 }
 
 static inline std::uint64_t splitmix64(std::uint64_t& x) {
@@ -42,14 +65,55 @@ double rand_uniform_01(std::uint64_t& state) {
     return x; 
 }
 
-double rand_standard_normal(std::uint64_t& state) {
-    // Box–Muller transform
-    const double u1 = rand_uniform_01(state);
-    const double u2 = rand_uniform_01(state);
+void rand_skip_normals(std::uint64_t& state, std::uint64_t n) {
+    // Each normal consumes two splitmix64 steps of the golden-ratio increment
+    state += n * 2ull * 0x9E3779B97F4A7C15ull;
+}
+
+static inline float rand_uniform_01_f(std::uint64_t& state) {
+    // Top 24 bits, (0,1] exactly in float
+    const std::uint64_t u = splitmix64(state);
+    return (static_cast<float>(u >> 40) + 1.0f) * (1.0f / 16777216.0f);
+}
+
+template <typename Real>
+Real rand_standard_normal_t(std::uint64_t& state) {
+    // Box–Muller transform, same operations as the dispatched normal_fill kernels
+    if constexpr (std::is_same<Real, double>::value) {
+        const double u1 = rand_uniform_01(state);
+        const double u2 = rand_uniform_01(state);
+        return std::sqrt(-2.0 * simd_math::log(u1)) * simd_math::cos2pi(u2);
+    } else {
+        const float u1 = rand_uniform_01_f(state);
+        const float u2 = rand_uniform_01_f(state);
+        return std::sqrt(-2.0f * simd_math::log(u1)) * simd_math::cos2pi(u2);
+    }
+}
+
+template <typename Real>
+void rand_standard_normal_fill_t(std::uint64_t& state, Real* out, std::size_t n) {
+    if constexpr (std::is_same<Real, double>::value) kernels().normal_fill(state, out, n);
+    else kernels().normal_fill_f(state, out, n);
+    rand_skip_normals(state, n);
+}
 
-    const double R = std::sqrt(-2.0 * std::log(u1));
-    const double theta = 2.0 * 3.14159265358979323846 * u2;
+double rand_standard_normal(std::uint64_t& state) {
+    return rand_standard_normal_t<double>(state);
+}
 
-    return R * std::cos(theta); // N(0,1)
+void rand_standard_normal_fill(std::uint64_t& state, double* out, std::size_t n) {
+    rand_standard_normal_fill_t<double>(state, out, n);
 }
 
+template float  normal_pdf_t<float>(float);
+template double normal_pdf_t<double>(double);
+template float  normal_cdf_t<float>(float);
+template double normal_cdf_t<double>(double);
+template float  bs_d1_t<float>(float, float, float, float, float);
+template double bs_d1_t<double>(double, double, double, double, double);
+template float  bs_d2_from_d1_t<float>(float, float, float);
+template double bs_d2_from_d1_t<double>(double, double, double);
+template float  rand_standard_normal_t<float>(std::uint64_t&);
+template double rand_standard_normal_t<double>(std::uint64_t&);
+template void   rand_standard_normal_fill_t<float>(std::uint64_t&, float*, std::size_t);
+template void   rand_standard_normal_fill_t<double>(std::uint64_t&, double*, std::size_t);
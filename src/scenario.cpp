@@ -0,0 +1,168 @@
+// scenario.cpp
+
+#include "scenario.h"
+#include "black_scholes.h"
+#include "pricing_session.h"
+#include "utils.h"
+
+#include <cmath>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace {
+    inline double position_value(const Position& p, double S, double T, double sigma) {
+        if (T <= 0.0) return p.is_call ? std::max(S - p.K, 0.0) : std::max(p.K - S, 0.0);
+        return p.is_call ? callPrice(S, p.K, T, p.r, sigma) : putPrice(S, p.K, T, p.r, sigma);
+    }
+
+    std::size_t nearest_zero(const std::vector<double>& v) {
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < v.size(); i++) {
+            if (std::fabs(v[i]) < std::fabs(v[best])) best = i;
+        }
+        return best;
+    }
+
+    struct Scratch {
+        double* d1;
+        double* d2;
+        double* n1;
+        double* n2;
+        double* Sx;
+    };
+
+    // Adds quantity * (V(scenario) - V(base)) of one position into `cube`
+    // (and into `own` if non-null).
+    void price_position(const Position& p, const ShockGrid& g, const double* log1p_spot,
+                        const Scratch& w, double* cube, double* own) {
+        const std::size_t ns = g.spot.size(), nv = g.vol.size(), nt = g.time.size();
+        const double base = position_value(p, p.S, p.T, p.sigma);
+        const double lnSK = std::log(p.S / p.K);
+
+        for (std::size_t s = 0; s < ns; s++) w.Sx[s] = p.S * (1.0 + g.spot[s]);
+
+        for (std::size_t t = 0; t < nt; t++) {
+            const double Tt = p.T - g.time[t];
+            const double sqrtT = std::sqrt(std::max(Tt, 0.0));
+            const double df = std::exp(-p.r * std::max(Tt, 0.0));
+            const double Kdf = p.K * df;
+
+            for (std::size_t v = 0; v < nv; v++) {
+                const double sig = std::max(p.sigma + g.vol[v], 0.0);
+                double* cell = cube + (t * nv + v) * ns;
+                double* mine = own ? own + (t * nv + v) * ns : nullptr;
+
+                if (Tt <= 0.0 || sig <= 0.0) {
+                    // Degenerate node: expired or zero vol, scalar closed forms
+                    for (std::size_t s = 0; s < ns; s++) {
+                        const double pnl = p.quantity * (position_value(p, w.Sx[s], Tt, sig) - base);
+                        cell[s] += pnl;
+                        if (mine) mine[s] = pnl;
+                    }
+                    continue;
+                }
+
+                const double vol_sqrtT = sig * sqrtT;
+                const double inv = 1.0 / vol_sqrtT;
+                const double a = lnSK + (p.r + 0.5 * sig * sig) * Tt;
+                const double sign = p.is_call ? 1.0 : -1.0;
+
+                for (std::size_t s = 0; s < ns; s++) {
+                    const double d1 = (log1p_spot[s] + a) * inv;
+                    w.d1[s] = sign * d1;
+                    w.d2[s] = sign * (d1 - vol_sqrtT);
+                }
+                normal_cdf_batch(w.d1, w.n1, ns);
+                normal_cdf_batch(w.d2, w.n2, ns);
+
+                // call: S N(d1) - K df N(d2); put: K df N(-d2) - S N(-d1)
+                for (std::size_t s = 0; s < ns; s++) {
+                    const double value = sign * (w.Sx[s] * w.n1[s] - Kdf * w.n2[s]);
+                    const double pnl = p.quantity * (value - base);
+                    cell[s] += pnl;
+                    if (mine) mine[s] = pnl;
+                }
+            }
+        }
+    }
+}
+
+std::vector<double> symmetricShocks(std::size_t n, double max_abs) {
+    std::vector<double> out(n, 0.0);
+    if (n < 2) return out;
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = -max_abs + 2.0 * max_abs * static_cast<double>(i) / static_cast<double>(n - 1);
+    }
+    if (n % 2 == 1) out[n / 2] = 0.0;
+    return out;
+}
+
+ScenarioCube runScenarios(const std::vector<Position>& book, const ShockGrid& grid,
+                          const ScenarioOptions& opts, PricingSession* session) {
+    ScenarioCube out;
+    out.n_spot = grid.spot.size();
+    out.n_vol = grid.vol.size();
+    out.n_time = grid.time.size();
+    const std::size_t cells = out.n_spot * out.n_vol * out.n_time;
+    out.pnl.assign(cells, 0.0);
+    if (opts.keep_positions) out.position_pnl.assign(cells * book.size(), 0.0);
+    if (cells == 0) return out;
+
+    for (const Position& p : book) out.base_value += p.quantity * position_value(p, p.S, p.T, p.sigma);
+
+    // Spot-axis terms shared by every position
+    std::vector<double> log1p_spot(out.n_spot);
+    for (std::size_t s = 0; s < out.n_spot; s++) log1p_spot[s] = std::log1p(grid.spot[s]);
+
+    std::size_t n_threads = opts.n_threads ? opts.n_threads : std::thread::hardware_concurrency();
+    n_threads = std::max<std::size_t>(1, std::min(n_threads, book.size()));
+
+    std::unique_ptr<PricingSession> own_session;
+    if (!session) {
+        PricingSessionOptions so;
+        so.n_workers = n_threads;
+        own_session = std::make_unique<PricingSession>(so);
+        session = own_session.get();
+    }
+    n_threads = std::min(n_threads, session->workers());   // one worker arena per thread
+
+    // Static contiguous split keeps the reduction order (and result) deterministic
+    std::vector<double*> cubes(n_threads, nullptr);
+    std::vector<ScratchArena::Marker> marks(n_threads);
+    auto worker = [&](std::size_t t) {
+        ScratchArena& arena = session->workerArena(t);
+        marks[t] = arena.mark();
+        const std::size_t ns = out.n_spot;
+        const Scratch w{arena.allocArray<double>(ns), arena.allocArray<double>(ns),
+                        arena.allocArray<double>(ns), arena.allocArray<double>(ns),
+                        arena.allocArray<double>(ns)};
+        double* cube = (t == 0) ? out.pnl.data() : arena.allocArray<double>(cells);
+        std::fill(cube, cube + cells, 0.0);
+        cubes[t] = cube;
+
+        const std::size_t lo = book.size() * t / n_threads;
+        const std::size_t hi = book.size() * (t + 1) / n_threads;
+        for (std::size_t i = lo; i < hi; i++) {
+            double* own = opts.keep_positions ? out.position_pnl.data() + i * cells : nullptr;
+            price_position(book[i], grid, log1p_spot.data(), w, cube, own);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < n_threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    for (std::size_t t = 1; t < n_threads; t++) {
+        for (std::size_t c = 0; c < cells; c++) out.pnl[c] += cubes[t][c];
+    }
+    // Thread cubes lived in the worker arenas until the reduction above
+    for (std::size_t t = 0; t < n_threads; t++) session->workerArena(t).rewind(marks[t]);
+
+    const std::size_t s0 = nearest_zero(grid.spot), v0 = nearest_zero(grid.vol), t0 = nearest_zero(grid.time);
+    for (std::size_t s = 0; s < out.n_spot; s++) out.spot_ladder.push_back(out.at(s, v0, t0));
+    for (std::size_t v = 0; v < out.n_vol; v++)  out.vol_ladder.push_back(out.at(s0, v, t0));
+    for (std::size_t t = 0; t < out.n_time; t++) out.time_ladder.push_back(out.at(s0, v0, t));
+    return out;
+}
@@ -0,0 +1,201 @@
+// scheduler.cpp
+
+#include "scheduler.h"
+#include "black_scholes.h"
+
+#include <algorithm>
+
+namespace {
+    // Identifies the scheduler/worker running on the current thread, if any
+    thread_local const TaskScheduler* tls_sched = nullptr;
+    thread_local std::size_t tls_worker = 0;
+
+    PricingSessionOptions worker_session(std::size_t n) {
+        PricingSessionOptions o;
+        o.arena_bytes = kCacheLine;
+        o.n_workers = n;
+        return o;
+    }
+
+    std::size_t worker_count(std::size_t n) {
+        if (n == 0) n = std::thread::hardware_concurrency();
+        return std::max<std::size_t>(n, 1);
+    }
+
+    struct ForState {
+        std::function<void(std::size_t, std::size_t)> body;
+        std::function<void()> on_done;
+        std::atomic<std::size_t> remaining{0};
+    };
+
+    // Runs indices [lo, hi): the upper half is repeatedly split off and pushed
+    // to the local deque, where idle workers can steal it.
+    void run_range(TaskScheduler& sched, const std::shared_ptr<ForState>& st,
+                   std::size_t lo, std::size_t hi, std::size_t worker) {
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            sched.submit([&sched, st, mid, hi](std::size_t w) { run_range(sched, st, mid, hi, w); });
+            hi = mid;
+        }
+        st->body(lo, worker);
+        if (st->remaining.fetch_sub(1) == 1) st->on_done();
+    }
+
+    // Splits [0, n) into chunks of `batch` and runs fn(i) for each index
+    template <typename T, typename Fn>
+    JobHandle<std::vector<T>> submit_batched(TaskScheduler& sched, std::size_t n, std::size_t batch, Fn fn) {
+        auto result = std::make_shared<typename JobHandle<std::vector<T>>::State>();
+        batch = std::max<std::size_t>(batch, 1);
+        const std::size_t chunks = (n + batch - 1) / batch;
+
+        auto out = std::make_shared<std::vector<T>>(n);
+        parallelFor(sched, chunks,
+            [out, fn, n, batch](std::size_t c, std::size_t) {
+                const std::size_t lo = c * batch, hi = std::min(n, lo + batch);
+                for (std::size_t i = lo; i < hi; i++) (*out)[i] = fn(i);
+            },
+            [out, result] { completeJob<std::vector<T>>(*result, std::move(*out)); });
+        return JobHandle<std::vector<T>>(result);
+    }
+}
+
+TaskScheduler::TaskScheduler(std::size_t n_workers)
+    : session_(worker_session(worker_count(n_workers))) {
+    const std::size_t n = worker_count(n_workers);
+    for (std::size_t i = 0; i < n; i++) queues_.push_back(std::make_unique<WorkerQueue>());
+    for (std::size_t i = 0; i < n; i++) threads_.emplace_back([this, i] { worker_loop(i); });
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lk(idle_m_);
+        stop_ = true;
+    }
+    idle_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void TaskScheduler::submit(Task task) {
+    const std::size_t q = (tls_sched == this)
+        ? tls_worker
+        : next_queue_.fetch_add(1) % queues_.size();
+    // Counted before it is visible: a worker may pop and decrement at once
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lk(queues_[q]->m);
+        queues_[q]->tasks.push_back(std::move(task));
+    }
+    {
+        // Taking the lock orders this wake-up after a sleeper's predicate check
+        std::lock_guard<std::mutex> lk(idle_m_);
+    }
+    idle_cv_.notify_one();
+}
+
+bool TaskScheduler::pop_local(std::size_t id, Task& out) {
+    WorkerQueue& q = *queues_[id];
+    std::lock_guard<std::mutex> lk(q.m);
+    if (q.tasks.empty()) return false;
+    out = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+bool TaskScheduler::steal(std::size_t thief, Task& out) {
+    const std::size_t n = queues_.size();
+    for (std::size_t k = 1; k < n; k++) {
+        WorkerQueue& q = *queues_[(thief + k) % n];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.tasks.empty()) continue;
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        steals_.fetch_add(1);
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::worker_loop(std::size_t id) {
+    tls_sched = this;
+    tls_worker = id;
+
+    for (;;) {
+        Task task;
+        if (pop_local(id, task) || steal(id, task)) {
+            pending_.fetch_sub(1);
+            task(id);
+            executed_.fetch_add(1);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(idle_m_);
+        idle_cv_.wait(lk, [&] { return pending_.load() > 0 || stop_; });
+        if (stop_ && pending_.load() == 0) return;
+    }
+}
+
+TaskScheduler& defaultScheduler() {
+    static TaskScheduler sched;
+    return sched;
+}
+
+void parallelFor(TaskScheduler& sched, std::size_t n,
+                 std::function<void(std::size_t, std::size_t)> body,
+                 std::function<void()> on_done) {
+    if (n == 0) {
+        on_done();
+        return;
+    }
+    auto st = std::make_shared<ForState>();
+    st->body = std::move(body);
+    st->on_done = std::move(on_done);
+    st->remaining = n;
+    sched.submit([&sched, st, n](std::size_t w) { run_range(sched, st, 0, n, w); });
+}
+
+JobHandle<MCResult> submitMC(TaskScheduler& sched, const MCJob& job) {
+    auto result = std::make_shared<JobHandle<MCResult>::State>();
+
+    // Degenerate inputs are answered inline by the serial engine
+    if (job.S <= 0.0 || job.K <= 0.0 || job.T <= 0.0 || job.sigma < 0.0 || job.n_paths < 2) {
+        completeJob<MCResult>(*result, job.is_call
+            ? mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode)
+            : mcPutPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode));
+        return JobHandle<MCResult>(result);
+    }
+
+    auto parts = std::make_shared<std::vector<MCPartial>>(mcBlockCount(job.n_paths));
+    parallelFor(sched, parts->size(),
+        [&sched, job, parts](std::size_t b, std::size_t w) {
+            ScratchArena& arena = sched.workerArena(w);
+            (*parts)[b] = job.is_call
+                ? mcCallBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena)
+                : mcPutBlock(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode, b, arena);
+        },
+        [parts, result] {
+            // Merge in block order for a schedule-independent result
+            MCPartial total;
+            for (const MCPartial& p : *parts) mcMerge(total, p);
+            completeJob<MCResult>(*result, mcFinalize(total));
+        });
+    return JobHandle<MCResult>(result);
+}
+
+JobHandle<std::vector<double>> submitBSBatch(TaskScheduler& sched, std::vector<BSQuote> quotes,
+                                             std::size_t batch) {
+    auto q = std::make_shared<const std::vector<BSQuote>>(std::move(quotes));
+    return submit_batched<double>(sched, q->size(), batch, [q](std::size_t i) {
+        const BSQuote& b = (*q)[i];
+        return b.is_call ? callPrice(b.S, b.K, b.T, b.r, b.sigma) : putPrice(b.S, b.K, b.T, b.r, b.sigma);
+    });
+}
+
+JobHandle<std::vector<IVResult>> submitIVBatch(TaskScheduler& sched, std::vector<IVQuote> quotes,
+                                               std::size_t batch) {
+    auto q = std::make_shared<const std::vector<IVQuote>>(std::move(quotes));
+    return submit_batched<IVResult>(sched, q->size(), batch, [q](std::size_t i) {
+        const IVQuote& v = (*q)[i];
+        return v.is_call ? impliedVolCall(v.market_price, v.S, v.K, v.T, v.r)
+                         : impliedVolPut(v.market_price, v.S, v.K, v.T, v.r);
+    });
+}
@@ -0,0 +1,136 @@
+// term_structure.cpp
+
+#include "term_structure.h"
+
+#include <cmath>
+#include <algorithm>
+
+PiecewiseCurve::PiecewiseCurve(double flat) : values_{flat} {}
+
+PiecewiseCurve::PiecewiseCurve(std::vector<double> times, std::vector<double> values)
+    : times_(std::move(times)), values_(std::move(values)) {
+    if (values_.empty()) values_.push_back(0.0);
+    times_.resize(std::min(times_.size(), values_.size()));
+
+    cum_.resize(times_.size());
+    double acc = 0.0, prev = 0.0;
+    for (std::size_t i = 0; i < times_.size(); i++) {
+        acc += values_[i] * (times_[i] - prev);
+        cum_[i] = acc;
+        prev = times_[i];
+    }
+}
+
+std::size_t PiecewiseCurve::segment(double t) const {
+    // First knot at or after t: the segment (times[i-1], times[i]] holding t
+    return static_cast<std::size_t>(std::lower_bound(times_.begin(), times_.end(), t) - times_.begin());
+}
+
+double PiecewiseCurve::value(double t) const {
+    const std::size_t i = segment(t);
+    return values_[std::min(i, values_.size() - 1)];
+}
+
+double PiecewiseCurve::integral(double T) const {
+    if (T <= 0.0) return 0.0;
+    const std::size_t i = segment(T);
+    const double base = (i == 0) ? 0.0 : cum_[i - 1];
+    const double t0 = (i == 0) ? 0.0 : times_[i - 1];
+    return base + values_[std::min(i, values_.size() - 1)] * (T - t0);
+}
+
+DiscountCurve DiscountCurve::fromZeroRates(const std::vector<double>& times, const std::vector<double>& zero_rates) {
+    const std::size_t n = std::min(times.size(), zero_rates.size());
+    std::vector<double> knots(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(n));
+    std::vector<double> fwd(n);
+    double prev_t = 0.0, prev_rt = 0.0;
+    for (std::size_t i = 0; i < n; i++) {
+        const double rt = zero_rates[i] * times[i];
+        fwd[i] = (rt - prev_rt) / (times[i] - prev_t);
+        prev_t = times[i];
+        prev_rt = rt;
+    }
+    return DiscountCurve(std::move(knots), std::move(fwd));
+}
+
+double DiscountCurve::discount(double T) const {
+    return std::exp(-fwd_.integral(T));
+}
+
+double DiscountCurve::zeroRate(double T) const {
+    return (T > 0.0) ? fwd_.integral(T) / T : fwd_.value(0.0);
+}
+
+DividendCurve::DividendCurve(PiecewiseCurve yield, std::vector<CashDividend> cash)
+    : yield_(std::move(yield)), cash_(std::move(cash)) {
+    std::sort(cash_.begin(), cash_.end(),
+              [](const CashDividend& a, const CashDividend& b) { return a.time < b.time; });
+}
+
+namespace {
+    PiecewiseCurve variance_rates(std::vector<double> times, std::vector<double> vols) {
+        for (double& v : vols) v *= v;
+        return PiecewiseCurve(std::move(times), std::move(vols));
+    }
+}
+
+VolTermStructure::VolTermStructure(double flat_vol) : var_(flat_vol * flat_vol) {}
+
+VolTermStructure::VolTermStructure(std::vector<double> times, std::vector<double> vols)
+    : var_(variance_rates(std::move(times), std::move(vols))) {}
+
+double VolTermStructure::effectiveVol(double T) const {
+    return (T > 0.0) ? std::sqrt(var_.integral(T) / T) : std::sqrt(var_.value(0.0));
+}
+
+MarketCurves::MarketCurves(DiscountCurve rates, DividendCurve dividends, VolTermStructure vol)
+    : rates_(std::move(rates)), dividends_(std::move(dividends)), vol_(std::move(vol)) {
+    double acc = 0.0;
+    for (const CashDividend& d : dividends_.cash()) {
+        if (d.time > 0.0) acc += d.amount * rates_.discount(d.time);
+        div_cum_pv_.push_back(acc);
+    }
+}
+
+double MarketCurves::dividendPV(double T) const {
+    const auto& cash = dividends_.cash();
+    // Dividends paid at or before T
+    const std::size_t n = static_cast<std::size_t>(
+        std::upper_bound(cash.begin(), cash.end(), T,
+                         [](double t, const CashDividend& d) { return t < d.time; }) - cash.begin());
+    return (n == 0) ? 0.0 : div_cum_pv_[n - 1];
+}
+
+double MarketCurves::forward(double S, double T) const {
+    return (S - dividendPV(T)) * std::exp(rates_.rateIntegral(T) - dividends_.yieldIntegral(T));
+}
+
+MarketCurves::FlatInputs MarketCurves::flatten(double S, double T) const {
+    FlatInputs f;
+    f.spot_scale = std::exp(-dividends_.yieldIntegral(T));
+    f.spot = (S - dividendPV(T)) * f.spot_scale;
+    f.rate = rates_.zeroRate(T);
+    f.vol = vol_.effectiveVol(T);
+    return f;
+}
+
+MCTimeGrid MarketCurves::timeGrid(double T, std::size_t n_steps) const {
+    MCTimeGrid g;
+    n_steps = std::max<std::size_t>(n_steps, 1);
+    g.times.resize(n_steps + 1);
+    g.drift.resize(n_steps);
+    g.diffusion.resize(n_steps);
+
+    for (std::size_t i = 0; i <= n_steps; i++) {
+        g.times[i] = T * static_cast<double>(i) / static_cast<double>(n_steps);
+    }
+    for (std::size_t i = 0; i < n_steps; i++) {
+        const double t0 = g.times[i], t1 = g.times[i + 1];
+        const double w = vol_.totalVariance(t0, t1);
+        g.drift[i] = rates_.forwards().integral(t0, t1) - dividends_.yield().integral(t0, t1) - 0.5 * w;
+        g.diffusion[i] = std::sqrt(w);
+        g.total_drift += g.drift[i];
+        g.total_variance += w;
+    }
+    return g;
+}
@@ -0,0 +1,407 @@
+// vol_surface.cpp
+
+#include "vol_surface.h"
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace {
+    constexpr double RHO_MAX = 0.999;
+    constexpr double S_MIN = 1e-6;
+
+    // Solve A x = b for small dense systems (Gaussian elimination, partial pivoting)
+    template <std::size_t N>
+    bool solve_small(std::array<std::array<double, N>, N> A, std::array<double, N> b,
+                     std::array<double, N>& x) {
+        for (std::size_t c = 0; c < N; c++) {
+            std::size_t piv = c;
+            for (std::size_t r = c + 1; r < N; r++) {
+                if (std::fabs(A[r][c]) > std::fabs(A[piv][c])) piv = r;
+            }
+            if (std::fabs(A[piv][c]) < 1e-300) return false;
+            std::swap(A[c], A[piv]);
+            std::swap(b[c], b[piv]);
+            for (std::size_t r = c + 1; r < N; r++) {
+                const double f = A[r][c] / A[c][c];
+                for (std::size_t k = c; k < N; k++) A[r][k] -= f * A[c][k];
+                b[r] -= f * b[c];
+            }
+        }
+        for (std::size_t c = N; c-- > 0;) {
+            double s = b[c];
+            for (std::size_t k = c + 1; k < N; k++) s -= A[c][k] * x[k];
+            x[c] = s / A[c][c];
+        }
+        return true;
+    }
+
+    // Generic Levenberg–Marquardt on N parameters. `model(i, p, J)` returns the
+    // model value for data point i and fills its gradient J; `project` enforces
+    // parameter constraints after each step. `stalled` is set when no damped
+    // step reduces the cost; that only counts as converged once the cost
+    // itself is below the improvement tolerance.
+    template <std::size_t N, typename Model, typename Project>
+    int levenberg_marquardt(std::array<double, N>& p, std::size_t n_obs,
+                            const std::vector<double>& target, const std::vector<double>& weight,
+                            Model model, Project project, int max_iter, double tol,
+                            double& cost_out, bool& converged, bool& stalled) {
+        auto cost_of = [&](const std::array<double, N>& q) {
+            std::array<double, N> g{};
+            double c = 0.0;
+            for (std::size_t i = 0; i < n_obs; i++) {
+                const double e = model(i, q, g) - target[i];
+                c += weight[i] * e * e;
+            }
+            return c;
+        };
+
+        double cost = cost_of(p);
+        double lambda = 1e-3;
+        converged = false;
+        stalled = false;
+        int it = 0;
+
+        for (; it < max_iter; it++) {
+            std::array<std::array<double, N>, N> JtJ{};
+            std::array<double, N> Jtr{};
+            std::array<double, N> g{};
+            for (std::size_t i = 0; i < n_obs; i++) {
+                const double e = model(i, p, g) - target[i];
+                const double w = weight[i];
+                for (std::size_t a = 0; a < N; a++) {
+                    Jtr[a] += w * g[a] * e;
+                    for (std::size_t b = a; b < N; b++) JtJ[a][b] += w * g[a] * g[b];
+                }
+            }
+            for (std::size_t a = 0; a < N; a++) {
+                for (std::size_t b = 0; b < a; b++) JtJ[a][b] = JtJ[b][a];
+            }
+
+            bool stepped = false;
+            for (int attempt = 0; attempt < 20 && !stepped; attempt++) {
+                std::array<std::array<double, N>, N> A = JtJ;
+                std::array<double, N> rhs{};
+                for (std::size_t a = 0; a < N; a++) {
+                    A[a][a] += lambda * std::max(JtJ[a][a], 1e-12);
+                    rhs[a] = -Jtr[a];
+                }
+                std::array<double, N> delta{};
+                if (!solve_small<N>(A, rhs, delta)) {
+                    lambda *= 10.0;
+                    continue;
+                }
+
+                std::array<double, N> trial = p;
+                for (std::size_t a = 0; a < N; a++) trial[a] += delta[a];
+                project(trial);
+
+                const double trial_cost = cost_of(trial);
+                if (trial_cost < cost) {
+                    const double improvement = cost - trial_cost;
+                    p = trial;
+                    cost = trial_cost;
+                    lambda = std::max(lambda / 3.0, 1e-12);
+                    stepped = true;
+                    if (improvement <= tol * (1.0 + cost)) converged = true;
+                } else {
+                    lambda *= 4.0;
+                }
+            }
+
+            if (!stepped) {
+                // No damping found a descent step: a minimum if nothing is
+                // left to gain, otherwise the fit is stuck
+                stalled = true;
+                converged = cost <= tol;
+                it++;
+                break;
+            }
+            if (converged) {
+                it++;
+                break;
+            }
+        }
+
+        cost_out = cost;
+        return it;
+    }
+
+    inline std::array<double, 5> to_array(const SVIParams& p) { return {p.a, p.b, p.rho, p.m, p.s}; }
+    inline SVIParams from_array(const std::array<double, 5>& x) { return {x[0], x[1], x[2], x[3], x[4]}; }
+
+    // Keep raw SVI inside its admissible region (b >= 0, |rho| < 1, s > 0,
+    // and non-negative minimum variance a + b s sqrt(1 - rho^2))
+    void project_svi(std::array<double, 5>& x) {
+        x[1] = std::max(x[1], 0.0);
+        x[2] = std::clamp(x[2], -RHO_MAX, RHO_MAX);
+        x[4] = std::max(x[4], S_MIN);
+        const double wmin = x[0] + x[1] * x[4] * std::sqrt(1.0 - x[2] * x[2]);
+        if (wmin < 0.0) x[0] -= wmin;
+    }
+
+    void slice_targets(const SliceQuotes& q, std::vector<double>& k, std::vector<double>& w,
+                       std::vector<double>& wt) {
+        const std::size_t n = std::min(q.strikes.size(), q.ivs.size());
+        k.clear(); w.clear(); wt.clear();
+        for (std::size_t i = 0; i < n; i++) {
+            const double K = q.strikes[i], iv = q.ivs[i];
+            if (!(K > 0.0) || !std::isfinite(iv) || iv <= 0.0) continue;
+            k.push_back(std::log(K / q.forward));
+            w.push_back(iv * iv * q.T);
+            wt.push_back(i < q.weights.size() ? q.weights[i] : 1.0);
+        }
+    }
+
+    // ATM total variance of a slice, interpolated linearly in k
+    double atm_total_variance(const std::vector<double>& k, const std::vector<double>& w) {
+        std::size_t lo = 0, hi = 0;
+        double klo = -INFINITY, khi = INFINITY;
+        for (std::size_t i = 0; i < k.size(); i++) {
+            if (k[i] <= 0.0 && k[i] > klo) { klo = k[i]; lo = i; }
+            if (k[i] >= 0.0 && k[i] < khi) { khi = k[i]; hi = i; }
+        }
+        if (!std::isfinite(klo)) return w[hi];
+        if (!std::isfinite(khi) || khi == klo) return w[lo];
+        const double t = -klo / (khi - klo);
+        return (1.0 - t) * w[lo] + t * w[hi];
+    }
+
+    // SSVI power-law curvature phi(theta) = eta / (theta^gamma (1 + theta)^(1 - gamma))
+    inline double ssvi_phi(double theta, double eta, double gam) {
+        return eta / (std::pow(theta, gam) * std::pow(1.0 + theta, 1.0 - gam));
+    }
+
+    // Exact raw-SVI representation of one SSVI slice
+    inline SVIParams ssvi_to_svi(double theta, double rho, double phi) {
+        return {0.5 * theta * (1.0 - rho * rho), 0.5 * theta * phi, rho, -rho / phi,
+                std::sqrt(1.0 - rho * rho) / phi};
+    }
+
+    void fit_ssvi(const std::vector<SliceQuotes>& slices, const CalibrationOptions& opts,
+                  std::vector<SVIParams>& out, CalibrationReport* report) {
+        std::vector<double> k_all, w_all, wt_all, theta_all;
+        std::vector<double> thetas(slices.size(), 0.0);
+        std::vector<std::size_t> slice_of;
+
+        for (std::size_t j = 0; j < slices.size(); j++) {
+            std::vector<double> k, w, wt;
+            slice_targets(slices[j], k, w, wt);
+            if (k.empty()) continue;
+            thetas[j] = atm_total_variance(k, w);
+            for (std::size_t i = 0; i < k.size(); i++) {
+                k_all.push_back(k[i]);
+                w_all.push_back(w[i]);
+                wt_all.push_back(wt[i]);
+                theta_all.push_back(thetas[j]);
+                slice_of.push_back(j);
+            }
+        }
+
+        std::array<double, 3> p = {-0.3, 1.0, 0.5};   // rho, eta, gamma
+        auto model = [&](std::size_t i, const std::array<double, 3>& q, std::array<double, 3>& g) {
+            const double th = theta_all[i], k = k_all[i];
+            const double rho = q[0], eta = q[1], gam = q[2];
+            const double phi = ssvi_phi(th, eta, gam);
+            const double z = phi * k + rho;
+            const double R = std::sqrt(z * z + 1.0 - rho * rho);
+            const double dw_dphi = 0.5 * th * (rho * k + z * k / R);
+            g[0] = 0.5 * th * (phi * k + phi * k / R);
+            g[1] = dw_dphi * phi / eta;
+            g[2] = dw_dphi * phi * std::log((1.0 + th) / th);
+            return 0.5 * th * (1.0 + rho * phi * k + R);
+        };
+        auto project = [](std::array<double, 3>& q) {
+            q[0] = std::clamp(q[0], -RHO_MAX, RHO_MAX);
+            q[1] = std::max(q[1], 1e-6);
+            q[2] = std::clamp(q[2], 0.0, 1.0);
+        };
+
+        double cost = 0.0;
+        bool converged = false, stalled = false;
+        const int iters = levenberg_marquardt<3>(p, k_all.size(), w_all, wt_all, model, project,
+                                                 opts.max_iter, opts.tol, cost, converged, stalled);
+
+        out.resize(slices.size());
+        for (std::size_t j = 0; j < slices.size(); j++) {
+            const double th = std::max(thetas[j], 1e-12);
+            out[j] = ssvi_to_svi(th, p[0], ssvi_phi(th, p[1], p[2]));
+        }
+
+        if (report) {
+            const double rmse = k_all.empty() ? NAN : std::sqrt(cost / static_cast<double>(k_all.size()));
+            report->fits.assign(slices.size(), SVIFit{});
+            for (std::size_t j = 0; j < slices.size(); j++) {
+                report->fits[j] = {out[j], rmse, iters, converged, stalled};
+            }
+        }
+    }
+}
+
+double sviTotalVariance(const SVIParams& p, double k) {
+    const double x = k - p.m;
+    return p.a + p.b * (p.rho * x + std::sqrt(x * x + p.s * p.s));
+}
+
+SVIParams sviInitialGuess(const SliceQuotes& q) {
+    std::vector<double> k, w, wt;
+    slice_targets(q, k, w, wt);
+    if (k.empty()) return {0.04 * q.T, 0.1, 0.0, 0.0, 0.1};
+
+    const double w0 = atm_total_variance(k, w);
+    double slope = 0.0;
+    for (std::size_t i = 0; i < k.size(); i++) {
+        if (std::fabs(k[i]) > 1e-6) slope = std::max(slope, std::fabs(w[i] - w0) / std::fabs(k[i]));
+    }
+    const double b = std::max(slope, 1e-3);
+    const double s = 0.1;
+    return {std::max(w0 - b * s, 1e-6), b, 0.0, 0.0, s};
+}
+
+SVIFit fitSVISlice(const SliceQuotes& q, const SVIParams& init, int max_iter, double tol) {
+    std::vector<double> k, w, wt;
+    slice_targets(q, k, w, wt);
+    if (k.size() < 5 || !(q.T > 0.0) || !(q.forward > 0.0)) {
+        return {init, NAN, 0, false, false};
+    }
+
+    auto model = [&](std::size_t i, const std::array<double, 5>& p, std::array<double, 5>& g) {
+        const double x = k[i] - p[3];
+        const double R = std::sqrt(x * x + p[4] * p[4]);
+        g[0] = 1.0;
+        g[1] = p[2] * x + R;
+        g[2] = p[1] * x;
+        g[3] = -p[1] * (p[2] + x / R);
+        g[4] = p[1] * p[4] / R;
+        return p[0] + p[1] * (p[2] * x + R);
+    };
+
+    std::array<double, 5> p = to_array(init);
+    project_svi(p);
+
+    double cost = 0.0;
+    bool converged = false, stalled = false;
+    const int iters = levenberg_marquardt<5>(p, k.size(), w, wt, model, project_svi,
+                                             max_iter, tol, cost, converged, stalled);
+
+    return {from_array(p), std::sqrt(cost / static_cast<double>(k.size())), iters, converged, stalled};
+}
+
+VolSurface::VolSurface(double spot, std::vector<double> expiries, std::vector<double> forwards,
+                       std::vector<SVIParams> params)
+    : spot_(spot), expiries_(std::move(expiries)), forwards_(std::move(forwards)),
+      params_(std::move(params)) {}
+
+double VolSurface::forward(double T) const {
+    if (expiries_.empty() || T <= 0.0) return spot_;
+
+    // ln F piecewise linear in T through (0, ln S); last segment extrapolated
+    double t0 = 0.0, l0 = std::log(spot_);
+    for (std::size_t j = 0; j < expiries_.size(); j++) {
+        const double t1 = expiries_[j], l1 = std::log(forwards_[j]);
+        if (T <= t1 || j + 1 == expiries_.size()) {
+            return std::exp(l0 + (l1 - l0) * (T - t0) / (t1 - t0));
+        }
+        t0 = t1;
+        l0 = l1;
+    }
+    return spot_;
+}
+
+double VolSurface::totalVariance(double k, double T) const {
+    if (expiries_.empty() || !(T > 0.0)) return NAN;
+
+    const std::size_t n = expiries_.size();
+    if (T <= expiries_.front()) {
+        return sviTotalVariance(params_.front(), k) * T / expiries_.front();
+    }
+    if (T >= expiries_.back()) {
+        return sviTotalVariance(params_.back(), k) * T / expiries_.back();
+    }
+
+    const std::size_t hi = static_cast<std::size_t>(
+        std::upper_bound(expiries_.begin(), expiries_.end(), T) - expiries_.begin());
+    const std::size_t lo = std::min(hi - 1, n - 1);
+    const double t = (T - expiries_[lo]) / (expiries_[hi] - expiries_[lo]);
+    return (1.0 - t) * sviTotalVariance(params_[lo], k) + t * sviTotalVariance(params_[hi], k);
+}
+
+double VolSurface::sigma(double K, double T) const {
+    if (!(K > 0.0) || !(T > 0.0) || expiries_.empty()) return NAN;
+    const double w = totalVariance(std::log(K / forward(T)), T);
+    return std::sqrt(std::max(w, 0.0) / T);
+}
+
+VolSurface calibrateSurface(double spot, const std::vector<SliceQuotes>& slices,
+                            const CalibrationOptions& opts, const VolSurface* previous,
+                            CalibrationReport* report) {
+    // Surface nodes are kept sorted by expiry
+    std::vector<std::size_t> order(slices.size());
+    for (std::size_t j = 0; j < order.size(); j++) order[j] = j;
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t x, std::size_t y) { return slices[x].T < slices[y].T; });
+
+    std::vector<SVIParams> params(slices.size());
+    CalibrationReport local;
+    CalibrationReport& rep = report ? *report : local;
+
+    if (opts.ssvi) {
+        fit_ssvi(slices, opts, params, &rep);
+    } else {
+        rep.fits.assign(slices.size(), SVIFit{});
+
+        // The previous surface is older, so its expiries sit slightly
+        // further out: take the nearest one within the tolerance
+        auto warm_start = [&](const SliceQuotes& q) {
+            if (previous && !previous->empty()) {
+                const auto& ex = previous->expiries();
+                std::size_t best = ex.size();
+                double best_gap = opts.warm_start_tolerance;
+                for (std::size_t i = 0; i < ex.size(); i++) {
+                    const double gap = std::fabs(ex[i] - q.T);
+                    if (gap <= best_gap) {
+                        best = i;
+                        best_gap = gap;
+                    }
+                }
+                if (best < ex.size()) return previous->params()[best];
+            }
+            return sviInitialGuess(q);
+        };
+
+        // Slices are independent: workers pull the next expiry from a shared counter
+        std::atomic<std::size_t> next{0};
+        auto worker = [&]() {
+            for (std::size_t j = next.fetch_add(1); j < slices.size(); j = next.fetch_add(1)) {
+                rep.fits[j] = fitSVISlice(slices[j], warm_start(slices[j]), opts.max_iter, opts.tol);
+                params[j] = rep.fits[j].params;
+            }
+        };
+
+        std::size_t n_threads = opts.n_threads ? opts.n_threads : std::thread::hardware_concurrency();
+        n_threads = std::max<std::size_t>(1, std::min(n_threads, slices.size()));
+
+        std::vector<std::thread> pool;
+        for (std::size_t t = 1; t < n_threads; t++) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+    }
+
+    rep.max_rmse = 0.0;
+    rep.all_converged = true;
+    for (const auto& f : rep.fits) {
+        rep.max_rmse = std::max(rep.max_rmse, std::isfinite(f.rmse) ? f.rmse : INFINITY);
+        rep.all_converged = rep.all_converged && f.converged;
+    }
+
+    std::vector<double> expiries, forwards;
+    std::vector<SVIParams> sorted;
+    for (std::size_t j : order) {
+        expiries.push_back(slices[j].T);
+        forwards.push_back(slices[j].forward);
+        sorted.push_back(params[j]);
+    }
+    return VolSurface(spot, std::move(expiries), std::move(forwards), std::move(sorted));
+}
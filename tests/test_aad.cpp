@@ -0,0 +1,99 @@
+// AAD: tape mechanics, Black–Scholes sensitivities against the analytic
+// Greeks, and MC pathwise sensitivities against Black–Scholes
+
+#include <iostream>
+#include <cmath>
+
+#include "aad.h"
+#include "black_scholes.h"
+#include "greeks.h"
+#include "monte_carlo.h"
+
+static bool close(double a, double b, double tol) { return std::fabs(a - b) <= tol; }
+
+int main() {
+    // f(x, y) = x y + exp(x) / y
+    {
+        Tape tape;
+        const ADouble x = tape.input(0.7), y = tape.input(1.9);
+        const ADouble f = x * y + exp(x) / y;
+        tape.adjoint(f.node) = 1.0;
+        tape.propagate();
+        const double dfdx = 1.9 + std::exp(0.7) / 1.9;
+        const double dfdy = 0.7 - std::exp(0.7) / (1.9 * 1.9);
+        if (!close(tape.adjoint(x), dfdx, 1e-14) || !close(tape.adjoint(y), dfdy, 1e-14)) {
+            std::cerr << "FAIL: tape gradient of x y + exp(x)/y\n";
+            return 1;
+        }
+    }
+
+    // Black–Scholes: price bitwise, delta/vega against the closed forms,
+    // rho/theta/strike against central differences
+    const double cases[][5] = {{100, 100, 1.0, 0.05, 0.2}, {100, 80, 0.25, 0.01, 0.35},
+                               {50, 70, 2.0, 0.03, 0.15}, {120, 100, 0.5, -0.01, 0.6}};
+    for (const auto& c : cases) {
+        const double S = c[0], K = c[1], T = c[2], r = c[3], v = c[4];
+        const Sensitivities call = bsCallAAD(S, K, T, r, v);
+        const Sensitivities put = bsPutAAD(S, K, T, r, v);
+        if (call.price != callPrice(S, K, T, r, v) || put.price != putPrice(S, K, T, r, v)) {
+            std::cerr << "FAIL: AAD price differs from callPrice/putPrice\n";
+            return 1;
+        }
+        if (!close(call.dS, callDelta(S, K, T, r, v), 1e-12) || !close(put.dS, putDelta(S, K, T, r, v), 1e-12) ||
+            !close(call.dsigma, vega(S, K, T, r, v), 1e-10) || !close(put.dsigma, vega(S, K, T, r, v), 1e-10)) {
+            std::cerr << "FAIL: AAD delta/vega vs analytic at S=" << S << " K=" << K << "\n";
+            return 1;
+        }
+        const double h = 1e-5;
+        const double rho = (callPrice(S, K, T, r + h, v) - callPrice(S, K, T, r - h, v)) / (2 * h);
+        const double dT = (callPrice(S, K, T + h, r, v) - callPrice(S, K, T - h, r, v)) / (2 * h);
+        const double dK = (putPrice(S, K + h, T, r, v) - putPrice(S, K - h, T, r, v)) / (2 * h);
+        if (!close(call.dr, rho, 1e-6) || !close(call.dT, dT, 1e-6) || !close(put.dK, dK, 1e-6)) {
+            std::cerr << "FAIL: AAD rho/dT/dK vs finite differences\n";
+            return 1;
+        }
+    }
+    if (!std::isnan(bsCallAAD(100, 100, 0.0, 0.05, 0.2).dS)) {
+        std::cerr << "FAIL: degenerate BS AAD should give NAN sensitivities\n";
+        return 1;
+    }
+
+    // MC: same price as the engine, sensitivities near Black–Scholes, tape
+    // bounded by one block
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS};
+    const double S = 100, K = 105, T = 1.0, r = 0.03, v = 0.25;
+    const std::size_t n = 400000;
+    for (MCMode mode : modes) {
+        const MCSensitivities call = mcCallAAD(S, K, T, r, v, n, 11, mode);
+        const MCSensitivities put = mcPutAAD(S, K, T, r, v, n, 11, mode);
+        const MCResult rc = mcCallPrice(S, K, T, r, v, n, 11, mode);
+        const MCResult rp = mcPutPrice(S, K, T, r, v, n, 11, mode);
+        if (call.result.price != rc.price || call.result.stderr != rc.stderr ||
+            put.result.price != rp.price || put.result.stderr != rp.stderr) {
+            std::cerr << "FAIL: MC AAD result differs from the engine\n";
+            return 1;
+        }
+        if (!close(call.greeks.dS, callDelta(S, K, T, r, v), 0.005) ||
+            !close(put.greeks.dS, putDelta(S, K, T, r, v), 0.005) ||
+            !close(call.greeks.dsigma, vega(S, K, T, r, v), 0.3) ||
+            !close(put.greeks.dsigma, vega(S, K, T, r, v), 0.3)) {
+            std::cerr << "FAIL: MC AAD delta=" << call.greeks.dS << " vega=" << call.greeks.dsigma << "\n";
+            return 1;
+        }
+        const Sensitivities bs = bsCallAAD(S, K, T, r, v);
+        if (!close(call.greeks.dr, bs.dr, 0.5) || !close(call.greeks.dT, bs.dT, 0.2) ||
+            !close(call.greeks.dK, bs.dK, 0.005)) {
+            std::cerr << "FAIL: MC AAD rho=" << call.greeks.dr << " dT=" << call.greeks.dT
+                      << " dK=" << call.greeks.dK << "\n";
+            return 1;
+        }
+        if (call.tape_peak_nodes > 40 * kMCBlockPaths) {
+            std::cerr << "FAIL: tape not bounded by one block (" << call.tape_peak_nodes << " nodes)\n";
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: AAD sensitivities\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Async pricing: uninterrupted jobs match the serial engine, stopped jobs
+// return a partial result over the blocks they completed
+
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "async_pricing.h"
+#include "black_scholes.h"
+#include "monte_carlo.h"
+
+int main() {
+    TaskScheduler sched(4);
+
+    // No stop: identical to mcCallPrice
+    const MCJob job{true, 100, 100, 1.0, 0.05, 0.2, 200000, 42, MCMode::AntitheticControlBS};
+    const MCResult ref = mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, job.mode);
+    const MCAsyncResult full = mcPriceAsync(sched, job).get();
+    if (full.status != AsyncStatus::Complete || full.paths_done != job.n_paths ||
+        full.result.price != ref.price || full.result.stderr != ref.stderr) {
+        std::cerr << "FAIL: uninterrupted async MC differs from serial\n";
+        return 1;
+    }
+
+    // Cancelled before it starts: nothing simulated
+    {
+        AsyncOptions opts;
+        opts.token.cancel();
+        const MCAsyncResult r = mcPriceAsync(sched, job, opts).get();
+        if (r.status != AsyncStatus::Cancelled || r.paths_done != 0 || !std::isnan(r.result.price)) {
+            std::cerr << "FAIL: pre-cancelled job ran paths=" << r.paths_done << "\n";
+            return 1;
+        }
+    }
+
+    // Cancelled mid-flight: partial, still a sane estimate
+    {
+        const MCJob big{true, 100, 100, 1.0, 0.05, 0.2, 40000000, 7, MCMode::Plain};
+        auto fut = mcPriceAsync(sched, big);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        fut.cancel();
+        const MCAsyncResult& r = fut.get();
+        const double bs = callPrice(big.S, big.K, big.T, big.r, big.sigma);
+        if (r.status != AsyncStatus::Cancelled || r.paths_done >= big.n_paths) {
+            std::cerr << "FAIL: cancel did not stop the job (paths=" << r.paths_done << ")\n";
+            return 1;
+        }
+        if (r.paths_done >= 2 && std::fabs(r.result.price - bs) > 5.0 * r.result.stderr) {
+            std::cerr << "FAIL: partial estimate off: " << r.result.price << " vs " << bs << "\n";
+            return 1;
+        }
+    }
+
+    // Deadline in the past / short deadline
+    {
+        AsyncOptions opts;
+        opts.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        const MCJob big{false, 100, 110, 1.0, 0.05, 0.2, 40000000, 9, MCMode::Antithetic};
+        const MCAsyncResult r = mcPriceAsync(big, opts).get();
+        if (r.status != AsyncStatus::DeadlineExpired || r.paths_done >= big.n_paths) {
+            std::cerr << "FAIL: deadline not honoured (paths=" << r.paths_done << ")\n";
+            return 1;
+        }
+    }
+
+    // Batches: complete, then cancelled up front
+    std::vector<BSQuote> bs;
+    std::vector<IVQuote> iv;
+    for (int i = 0; i < 3000; i++) {
+        const double K = 70.0 + 0.02 * i;
+        bs.push_back({true, 100.0, K, 0.5, 0.02, 0.3});
+        iv.push_back({true, callPrice(100.0, K, 0.5, 0.02, 0.3), 100.0, K, 0.5, 0.02});
+    }
+    const auto b = bsBatchAsync(sched, bs).get();
+    const auto v = ivBatchAsync(sched, iv).get();
+    if (b.status != AsyncStatus::Complete || b.completed != bs.size() ||
+        v.status != AsyncStatus::Complete || v.completed != iv.size()) {
+        std::cerr << "FAIL: batch did not complete\n";
+        return 1;
+    }
+    for (std::size_t i = 0; i < bs.size(); i++) {
+        if (b.values[i] != callPrice(bs[i].S, bs[i].K, bs[i].T, bs[i].r, bs[i].sigma) ||
+            std::fabs(v.values[i].sigma - 0.3) > 1e-6) {
+            std::cerr << "FAIL: batch value at " << i << "\n";
+            return 1;
+        }
+    }
+
+    AsyncOptions stopped;
+    stopped.token.cancel();
+    const auto bc = bsBatchAsync(sched, bs, stopped).get();
+    if (bc.status != AsyncStatus::Cancelled || bc.completed != 0 || !std::isnan(bc.values[0])) {
+        std::cerr << "FAIL: cancelled batch computed values\n";
+        return 1;
+    }
+
+    std::cout << "PASS: async pricing with cancellation and deadlines\n";
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Multi-asset MC: correlation factoring and PSD repair, closed-form checks
+// (one asset, Margrabe exchange option, best-of + worst-of parity), the
+// geometric-basket control variate, block merging and ISA invariance
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "basket.h"
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "pricing_session.h"
+
+namespace {
+    std::vector<double> flat_correlation(std::size_t n, double rho) {
+        std::vector<double> c(n * n, rho);
+        for (std::size_t i = 0; i < n; i++) c[i * n + i] = 1.0;
+        return c;
+    }
+
+    // Largest |(A A^T - C)_ij| over the matrix
+    double reproduction_error(const CorrelationFactor& f, const std::vector<double>& c) {
+        double worst = 0.0;
+        for (std::size_t i = 0; i < f.dim; i++) {
+            for (std::size_t j = 0; j < f.dim; j++) {
+                double s = 0.0;
+                for (std::size_t k = 0; k < f.dim; k++) s += f.matrix[i * f.dim + k] * f.matrix[j * f.dim + k];
+                worst = std::max(worst, std::fabs(s - c[i * f.dim + j]));
+            }
+        }
+        return worst;
+    }
+
+    bool within(const MCResult& mc, double expected, double k, const char* what) {
+        if (!(std::fabs(mc.price - expected) <= k * mc.stderr)) {
+            std::cerr << "FAIL: " << what << " " << mc.price << " vs " << expected
+                      << " (stderr " << mc.stderr << ")\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    // Factoring: Cholesky for PD, eigen for semidefinite, repair for indefinite
+    CorrelationFactor f;
+    const std::vector<double> pd = flat_correlation(5, 0.4);
+    if (!factorCorrelation(pd, 5, f) || !f.lower || f.repaired || reproduction_error(f, pd) > 1e-14) {
+        std::cerr << "FAIL: Cholesky factor\n";
+        return 1;
+    }
+    const std::vector<double> ones = flat_correlation(3, 1.0);
+    if (!factorCorrelation(ones, 3, f) || f.lower || f.repaired || reproduction_error(f, ones) > 1e-12) {
+        std::cerr << "FAIL: semidefinite factor\n";
+        return 1;
+    }
+    const std::vector<double> bad = {1.0, 0.9, 0.9,
+                                     0.9, 1.0, -0.9,
+                                     0.9, -0.9, 1.0};
+    if (!factorCorrelation(bad, 3, f) || !f.repaired || !(f.min_eigenvalue < 0.0)) {
+        std::cerr << "FAIL: indefinite matrix not repaired\n";
+        return 1;
+    }
+    for (std::size_t i = 0; i < 3; i++) {
+        double d = 0.0;
+        for (std::size_t k = 0; k < 3; k++) d += f.matrix[i * 3 + k] * f.matrix[i * 3 + k];
+        if (std::fabs(d - 1.0) > 1e-14) {
+            std::cerr << "FAIL: repaired factor lost the unit diagonal\n";
+            return 1;
+        }
+    }
+    if (factorCorrelation({1.0, 0.5, 0.4, 1.0}, 2, f) || factorCorrelation({1.0, 1.5, 1.5, 1.0}, 2, f) ||
+        factorCorrelation({0.9, 0.0, 0.0, 1.0}, 2, f)) {
+        std::cerr << "FAIL: invalid correlation accepted\n";
+        return 1;
+    }
+
+    const std::size_t n = 200000;
+    const std::uint64_t seed = 17;
+
+    // One asset reduces to Black–Scholes
+    BasketOption one;
+    one.K = 105.0; one.T = 1.0; one.r = 0.03;
+    one.spots = {100.0}; one.vols = {0.25}; one.weights = {1.0}; one.dividends = {0.01};
+    for (bool call : {true, false}) {
+        one.is_call = call;
+        const double bs = call ? callPrice(100.0 * std::exp(-0.01), 105.0, 1.0, 0.03, 0.25)
+                               : putPrice(100.0 * std::exp(-0.01), 105.0, 1.0, 0.03, 0.25);
+        for (MCMode mode : {MCMode::Plain, MCMode::Antithetic}) {
+            if (!within(mcBasketPrice(one, {1.0}, n, seed, mode), bs, 4.0, "one-asset basket")) return 1;
+        }
+        // The geometric control of a one-asset basket is the option itself:
+        // exact price, and no residual variance left
+        const MCResult cv = mcBasketPrice(one, {1.0}, n, seed, MCMode::ControlVariateBS);
+        if (!(std::fabs(cv.price - bs) < 1e-10) || !(cv.stderr < 1e-8)) {
+            std::cerr << "FAIL: one-asset geometric control " << cv.price << " vs " << bs << "\n";
+            return 1;
+        }
+    }
+
+    // Exchange option S1 - S2 (spread, K = 0): Margrabe
+    BasketOption spread;
+    spread.T = 1.0; spread.r = 0.02; spread.K = 0.0;
+    spread.spots = {100.0, 95.0}; spread.vols = {0.3, 0.2}; spread.weights = {1.0, -1.0};
+    spread.dividends = {0.01, 0.03};
+    const double rho = 0.6;
+    const double sig = std::sqrt(0.09 + 0.04 - 2.0 * rho * 0.3 * 0.2);
+    const double margrabe = callPrice(100.0 * std::exp(-0.01), 95.0 * std::exp(-0.03), 1.0, 0.0, sig);
+    for (MCMode mode : {MCMode::Plain, MCMode::AntitheticControlBS}) {
+        if (!within(mcBasketPrice(spread, flat_correlation(2, rho), n, seed, mode), margrabe, 4.0, "Margrabe")) return 1;
+    }
+
+    // (max - K)^+ + (min - K)^+ = (S1 - K)^+ + (S2 - K)^+ path by path
+    BasketOption bo = spread;
+    bo.K = 100.0; bo.weights = {1.0, 1.0}; bo.payoff = BasketPayoff::BestOf;
+    const MCResult best = mcBasketPrice(bo, flat_correlation(2, rho), n, seed, MCMode::Plain);
+    bo.payoff = BasketPayoff::WorstOf;
+    const MCResult worst = mcBasketPrice(bo, flat_correlation(2, rho), n, seed, MCMode::Plain);
+    const double calls = callPrice(100.0 * std::exp(-0.01), 100.0, 1.0, 0.02, 0.3) +
+                         callPrice(95.0 * std::exp(-0.03), 100.0, 1.0, 0.02, 0.2);
+    const MCResult parity = {best.price + worst.price, best.stderr + worst.stderr, 0.0, 0.0};
+    if (!within(parity, calls, 4.0, "best-of + worst-of parity")) return 1;
+    if (!(best.price > worst.price)) {
+        std::cerr << "FAIL: best-of below worst-of\n";
+        return 1;
+    }
+
+    // Geometric-basket control on a 5-asset arithmetic basket
+    BasketOption basket;
+    basket.K = 100.0; basket.T = 1.0; basket.r = 0.02;
+    basket.spots = {100.0, 90.0, 110.0, 105.0, 95.0};
+    basket.vols = {0.2, 0.25, 0.3, 0.15, 0.35};
+    basket.weights = {0.2, 0.2, 0.2, 0.2, 0.2};
+    const MCResult plain = mcBasketPrice(basket, pd, n, seed, MCMode::Plain);
+    const MCResult geo = mcBasketPrice(basket, pd, n, seed, MCMode::ControlVariateBS);
+    const MCResult diff = {geo.price - plain.price, std::hypot(geo.stderr, plain.stderr), 0.0, 0.0};
+    if (!within(diff, 0.0, 4.0, "geometric control vs plain")) return 1;
+    if (!(geo.stderr * 5.0 < plain.stderr)) {
+        std::cerr << "FAIL: geometric control stderr " << geo.stderr << " vs plain " << plain.stderr << "\n";
+        return 1;
+    }
+
+    // 50 assets: block partials merged in order are the one-shot run, bit for bit
+    const std::size_t dim = 50;
+    BasketOption big;
+    big.K = 100.0; big.T = 0.5; big.r = 0.01;
+    for (std::size_t i = 0; i < dim; i++) {
+        big.spots.push_back(80.0 + 0.8 * static_cast<double>(i));
+        big.vols.push_back(0.15 + 0.004 * static_cast<double>(i));
+        big.weights.push_back(1.0 / static_cast<double>(dim));
+    }
+    CorrelationFactor big_f;
+    if (!factorCorrelation(flat_correlation(dim, 0.3), dim, big_f)) {
+        std::cerr << "FAIL: 50-asset factor\n";
+        return 1;
+    }
+    ScratchArena arena(std::size_t(1) << 20);
+    const std::size_t paths = 10000;
+    const MCResult whole = mcBasketPrice(big, big_f, paths, seed, MCMode::AntitheticControlBS, arena);
+    MCPartial total;
+    for (std::size_t b = 0; b < mcBlockCount(paths); b++) {
+        mcMerge(total, mcBasketBlock(big, big_f, paths, seed, MCMode::AntitheticControlBS, b, arena));
+    }
+    const MCResult merged = mcFinalize(total);
+    if (!std::isfinite(whole.price) || merged.price != whole.price || merged.stderr != whole.stderr) {
+        std::cerr << "FAIL: 50-asset block merge\n";
+        return 1;
+    }
+
+    // Every ISA level gives the same bits
+    const IsaLevel active = activeIsa();
+    for (IsaLevel level : {IsaLevel::Generic, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (!setActiveIsa(level)) continue;
+        const MCResult r = mcBasketPrice(big, big_f, paths, seed, MCMode::AntitheticControlBS, arena);
+        if (r.price != whole.price || r.stderr != whole.stderr) {
+            std::cerr << "FAIL: basket differs at " << isaName(level) << "\n";
+            return 1;
+        }
+    }
+    setActiveIsa(active);
+
+    // Unsupported modes and bad inputs
+    if (!std::isnan(mcBasketPrice(basket, pd, n, seed, MCMode::ImportanceSampling).price) ||
+        !std::isnan(mcBasketPrice(basket, flat_correlation(4, 0.2), n, seed).price)) {
+        std::cerr << "FAIL: invalid basket input priced\n";
+        return 1;
+    }
+
+    std::cout << "PASS: multi-asset MC\n";
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Chebyshev proxies: spectral accuracy against Black–Scholes in 2D and 3D,
+// analytic delta/gamma, accuracy report, exact serialization, an MC source
+// pricer with a fixed seed, and NAN outside the box
+
+#include <iostream>
+#include <cmath>
+
+#include "chebyshev_proxy.h"
+#include "black_scholes.h"
+#include "greeks.h"
+#include "monte_carlo.h"
+
+int main() {
+    const double K = 100.0, r = 0.02;
+    const ProxyPricer bs = [&](double S, double sigma, double T) { return callPrice(S, K, T, r, sigma); };
+
+    // Spot x vol at fixed T
+    ProxyAccuracy acc;
+    const ChebyshevProxy p2 = buildChebyshevProxy(bs, {60.0, 140.0, 40}, {0.1, 0.5, 24}, {1.0, 1.0, 1}, {}, &acc);
+    if (p2.empty() || acc.points != 256 || !(acc.max_abs_error < 1e-7) || !(acc.tail_estimate < 1e-6)) {
+        std::cerr << "FAIL: 2D proxy accuracy " << acc.max_abs_error << " tail " << acc.tail_estimate << "\n";
+        return 1;
+    }
+    double worst_p = 0.0, worst_d = 0.0, worst_g = 0.0;
+    for (double S = 62.0; S <= 138.0; S += 3.7) {
+        for (double v = 0.12; v <= 0.48; v += 0.05) {
+            double p, d, g;
+            p2.evaluate(S, v, 123.0 /* fixed axis: ignored */, p, d, g);
+            worst_p = std::max(worst_p, std::fabs(p - callPrice(S, K, 1.0, r, v)));
+            worst_d = std::max(worst_d, std::fabs(d - callDelta(S, K, 1.0, r, v)));
+            worst_g = std::max(worst_g, std::fabs(g - gamma(S, K, 1.0, r, v)));
+        }
+    }
+    if (worst_p > 1e-7 || worst_d > 1e-6 || worst_g > 1e-5) {
+        std::cerr << "FAIL: 2D proxy price/delta/gamma errors " << worst_p << " " << worst_d << " " << worst_g << "\n";
+        return 1;
+    }
+
+    // Spot x vol x time
+    const ChebyshevProxy p3 = buildChebyshevProxy(bs, {60.0, 140.0, 40}, {0.1, 0.5, 24}, {0.25, 2.0, 16}, {}, &acc);
+    if (p3.empty() || !(acc.max_abs_error < 1e-5)) {
+        std::cerr << "FAIL: 3D proxy accuracy " << acc.max_abs_error << "\n";
+        return 1;
+    }
+    if (std::fabs(p3.price(97.0, 0.23, 0.7) - callPrice(97.0, K, 0.7, r, 0.23)) > 1e-5) {
+        std::cerr << "FAIL: 3D proxy point value\n";
+        return 1;
+    }
+
+    // Serialization is exact
+    ChebyshevProxy back;
+    if (!parseChebyshevProxy(serializeChebyshevProxy(p3), back) || back.coefficients() != p3.coefficients() ||
+        back.price(97.0, 0.23, 0.7) != p3.price(97.0, 0.23, 0.7)) {
+        std::cerr << "FAIL: proxy serialization round trip\n";
+        return 1;
+    }
+    if (parseChebyshevProxy("chebproxy 1\naxis 0x1p+0 0x1p+1 4\n", back)) {
+        std::cerr << "FAIL: truncated proxy parsed\n";
+        return 1;
+    }
+
+    // MC source with a fixed seed: the proxy reproduces that pricer, well inside its stderr
+    const std::size_t paths = 20000;
+    const ProxyPricer mc = [&](double S, double sigma, double T) {
+        return mcCallPrice(S, K, T, r, sigma, paths, 42, MCMode::AntitheticControlBS).price;
+    };
+    const ChebyshevProxy pm = buildChebyshevProxy(mc, {80.0, 120.0, 16}, {0.15, 0.35, 8}, {1.0, 1.0, 1}, {}, &acc);
+    const double se = mcCallPrice(100.0, K, 1.0, r, 0.25, paths, 42, MCMode::AntitheticControlBS).stderr;
+    if (pm.empty() || !(acc.max_abs_error < 0.1 * se)) {
+        std::cerr << "FAIL: MC proxy error " << acc.max_abs_error << " vs stderr " << se << "\n";
+        return 1;
+    }
+
+    // Outside the box, invalid axes and non-finite node values
+    if (!std::isnan(p2.price(150.0, 0.2, 1.0)) || !std::isnan(p3.delta(100.0, 0.2, 3.0)) || p2.inDomain(59.0, 0.2, 1.0)) {
+        std::cerr << "FAIL: out-of-domain evaluation\n";
+        return 1;
+    }
+    const ProxyPricer nan_pricer = [](double, double, double) { return NAN; };
+    if (!buildChebyshevProxy(bs, {140.0, 60.0, 8}, {0.1, 0.5, 4}, {1.0, 1.0, 1}).empty() ||
+        !buildChebyshevProxy(nan_pricer, {60.0, 140.0, 8}, {0.1, 0.5, 4}, {1.0, 1.0, 1}).empty()) {
+        std::cerr << "FAIL: invalid proxy built\n";
+        return 1;
+    }
+
+    std::cout << "PASS: Chebyshev proxies\n";
+    return 0;
+}
@@ -0,0 +1,133 @@
+// CPU dispatch: every supported ISA level computes bit-identical kernel
+// results, and the batch kernels match the scalar library functions
+
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "heston_mc.h"
+#include "monte_carlo.h"
+#include "utils.h"
+
+namespace {
+    struct Outputs {
+        std::vector<double> cdf, normals, calls, puts;
+        std::vector<float> normals_f;
+        MCResult mc[4], mc_f[5];
+        MCResult heston[3];
+    };
+
+    Outputs run_all(const std::vector<double>& x, const std::vector<double>& S, const std::vector<double>& K,
+                    const std::vector<double>& T, const std::vector<double>& r, const std::vector<double>& v) {
+        const std::size_t n = x.size();
+        Outputs o;
+        o.cdf.resize(n); o.normals.resize(n); o.calls.resize(n); o.puts.resize(n);
+        normal_cdf_batch(x.data(), o.cdf.data(), n);
+        std::uint64_t state = 99;
+        rand_standard_normal_fill(state, o.normals.data(), n);
+        o.normals_f.resize(n);
+        state = 99;
+        rand_standard_normal_fill_t<float>(state, o.normals_f.data(), n);
+        callPriceBatch(S.data(), K.data(), T.data(), r.data(), v.data(), o.calls.data(), n);
+        putPriceBatch(S.data(), K.data(), T.data(), r.data(), v.data(), o.puts.data(), n);
+        const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                                MCMode::AntitheticControlBS};
+        for (int m = 0; m < 4; m++) o.mc[m] = mcPutPrice(100, 105, 1.0, 0.03, 0.25, 50001, 5, modes[m]);
+        for (int m = 0; m < 4; m++) o.mc_f[m] = mcPutPriceT<float>(100, 105, 1.0, 0.03, 0.25, 50001, 5, modes[m]);
+        o.mc_f[4] = mcCallPriceT<float>(100, 130, 1.0, 0.03, 0.25, 50001, 5, MCMode::AntitheticImportance);
+        HestonOption h;
+        h.asian = true;
+        h.S = 100.0; h.K = 100.0; h.T = 2.0; h.r = 0.02;
+        h.params = {1.5, 0.04, 0.9, -0.7, 0.05};
+        HestonMCOptions qe, qe_plain, euler;
+        qe_plain.martingale_correction = false;
+        euler.scheme = HestonScheme::Euler;
+        o.heston[0] = mcHestonPrice(h, 5001, 5, MCMode::AntitheticControlBS, qe);
+        o.heston[1] = mcHestonPrice(h, 5001, 5, MCMode::Plain, qe_plain);
+        o.heston[2] = mcHestonPrice(h, 5001, 5, MCMode::Plain, euler);
+        return o;
+    }
+
+    bool same(const std::vector<double>& a, const std::vector<double>& b) {
+        return std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+    }
+}
+
+int main() {
+    const std::size_t n = 10007;   // not a multiple of any vector width
+    std::vector<double> x(n), S(n), K(n), T(n), r(n), v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = -40.0 + 80.0 * static_cast<double>(i) / static_cast<double>(n - 1);
+        S[i] = 100.0;
+        K[i] = 50.0 + 0.01 * static_cast<double>(i);
+        T[i] = 0.05 + 0.0005 * static_cast<double>(i % 1000);
+        r[i] = 0.01 * static_cast<double>(i % 7) - 0.02;
+        v[i] = 0.05 + 0.0001 * static_cast<double>(i % 5000);
+    }
+    T[3] = 0.0; v[5] = 0.0; K[7] = -1.0;   // degenerate quotes go to the scalar code
+
+    const IsaLevel best = detectedIsa();
+    if (!setActiveIsa(IsaLevel::Generic)) {
+        std::cerr << "FAIL: generic level must always be available\n";
+        return 1;
+    }
+    const Outputs ref = run_all(x, S, K, T, r, v);
+
+    // Against the scalar library functions
+    std::uint64_t state = 99, state_f = 99;
+    for (std::size_t i = 0; i < n; i++) {
+        if (std::fabs(ref.cdf[i] - normal_cdf(x[i])) > 3e-16) {
+            std::cerr << "FAIL: normal_cdf_batch at x=" << x[i] << "\n";
+            return 1;
+        }
+        if (ref.normals[i] != rand_standard_normal(state)) {
+            std::cerr << "FAIL: normal fill differs from sequential draws at " << i << "\n";
+            return 1;
+        }
+        if (ref.normals_f[i] != rand_standard_normal_t<float>(state_f)) {
+            std::cerr << "FAIL: float normal fill differs from sequential draws at " << i << "\n";
+            return 1;
+        }
+        const double c = callPrice(S[i], K[i], T[i], r[i], v[i]);
+        const double p = putPrice(S[i], K[i], T[i], r[i], v[i]);
+        const double tol = 1e-13 * std::max(S[i], std::fabs(K[i]));
+        const bool c_ok = std::isnan(c) ? std::isnan(ref.calls[i]) : std::fabs(ref.calls[i] - c) <= tol;
+        const bool p_ok = std::isnan(p) ? std::isnan(ref.puts[i]) : std::fabs(ref.puts[i] - p) <= tol;
+        if (!c_ok || !p_ok) {
+            std::cerr << "FAIL: BS batch at " << i << " call " << ref.calls[i] << " vs " << c
+                      << ", put " << ref.puts[i] << " vs " << p << "\n";
+            return 1;
+        }
+    }
+
+    // Every wider level the CPU supports reproduces the generic bits
+    for (IsaLevel level : {IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (level > best) continue;
+        setActiveIsa(level);
+        const Outputs got = run_all(x, S, K, T, r, v);
+        bool ok = same(got.cdf, ref.cdf) && same(got.normals, ref.normals) &&
+                  same(got.calls, ref.calls) && same(got.puts, ref.puts) &&
+                  std::memcmp(got.normals_f.data(), ref.normals_f.data(), n * sizeof(float)) == 0;
+        for (int m = 0; m < 4; m++) {
+            ok = ok && got.mc[m].price == ref.mc[m].price && got.mc[m].stderr == ref.mc[m].stderr;
+        }
+        for (int m = 0; m < 5; m++) {
+            ok = ok && got.mc_f[m].price == ref.mc_f[m].price && got.mc_f[m].stderr == ref.mc_f[m].stderr;
+        }
+        for (int m = 0; m < 3; m++) {
+            ok = ok && got.heston[m].price == ref.heston[m].price && got.heston[m].stderr == ref.heston[m].stderr;
+        }
+        if (!ok) {
+            std::cerr << "FAIL: " << isaName(level) << " kernels differ from generic\n";
+            return 1;
+        }
+    }
+    setActiveIsa(best);
+
+    std::cout << "PASS: CPU dispatch (detected " << isaName(best) << ", all levels bit-identical)\n";
+    return 0;
+}
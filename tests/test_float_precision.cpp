@@ -0,0 +1,86 @@
+// Single-precision mode: max price error of float vs double across a parameter grid
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "black_scholes.h"
+#include "monte_carlo.h"
+#include "utils.h"
+
+int main() {
+    // Black–Scholes grid
+    double max_abs = 0.0;          // |float - double| / max(S, K)
+    double max_cdf = 0.0;
+    for (double m = 0.5; m <= 2.0 + 1e-9; m += 0.05) {
+        for (double T : {0.05, 0.25, 1.0, 2.0, 5.0}) {
+            for (double sigma : {0.05, 0.1, 0.2, 0.4, 0.7, 1.0}) {
+                for (double r : {-0.01, 0.0, 0.05, 0.1}) {
+                    const double S = 100.0, K = S / m;
+                    const double scale = std::max(S, K);
+                    const float Sf = static_cast<float>(S), Kf = static_cast<float>(K);
+                    const float Tf = static_cast<float>(T), rf = static_cast<float>(r);
+                    const float vf = static_cast<float>(sigma);
+
+                    const double ec = std::fabs(callPriceT<float>(Sf, Kf, Tf, rf, vf) - callPrice(S, K, T, r, sigma));
+                    const double ep = std::fabs(putPriceT<float>(Sf, Kf, Tf, rf, vf) - putPrice(S, K, T, r, sigma));
+                    max_abs = std::max(max_abs, std::max(ec, ep) / scale);
+                }
+            }
+        }
+    }
+    for (double x = -8.0; x <= 8.0; x += 0.01) {
+        max_cdf = std::max(max_cdf, std::fabs(normal_cdf_t<float>(static_cast<float>(x)) - normal_cdf(x)));
+    }
+
+    std::cout << "BS float max |err|/max(S,K) = " << max_abs << "\n";
+    std::cout << "normal_cdf float max |err|  = " << max_cdf << "\n";
+
+    if (!(max_abs <= 5e-7)) {
+        std::cerr << "FAIL: float BS error above documented bound\n";
+        return 1;
+    }
+    if (!(max_cdf <= 1e-7)) {
+        std::cerr << "FAIL: float normal_cdf error\n";
+        return 1;
+    }
+
+    // Monte Carlo: same seed, float kernels vs double kernels
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS};
+    double max_mc = 0.0;           // |float - double| / stderr
+    for (MCMode mode : modes) {
+        for (double K : {70.0, 100.0, 130.0}) {
+            for (double T : {0.1, 1.0, 3.0}) {
+                const auto d = mcCallPrice(100, K, T, 0.03, 0.25, 100000, 11, mode);
+                const auto f = mcCallPriceT<float>(100, K, T, 0.03, 0.25, 100000, 11, mode);
+                const auto dp = mcPutPrice(100, K, T, 0.03, 0.25, 100000, 11, mode);
+                const auto fp = mcPutPriceT<float>(100, K, T, 0.03, 0.25, 100000, 11, mode);
+                if (!(d.stderr > 0.0) || !(dp.stderr > 0.0)) continue;
+
+                max_mc = std::max(max_mc, std::fabs(f.price - d.price) / d.stderr);
+                max_mc = std::max(max_mc, std::fabs(fp.price - dp.price) / dp.stderr);
+                if (std::fabs(f.stderr - d.stderr) > 0.05 * d.stderr) {
+                    std::cerr << "FAIL: float stderr drifted from double\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    std::cout << "MC float max |err|/stderr   = " << max_mc << "\n";
+
+    if (!(max_mc <= 0.05)) {
+        std::cerr << "FAIL: float MC error is not negligible against stderr\n";
+        return 1;
+    }
+
+    // The double template instantiations are the default API
+    if (mcCallPriceT<double>(100, 100, 1.0, 0.05, 0.2, 5000, 3).price != mcCallPrice(100, 100, 1.0, 0.05, 0.2, 5000, 3).price ||
+        callPriceT<double>(100, 100, 1.0, 0.05, 0.2) != callPrice(100, 100, 1.0, 0.05, 0.2)) {
+        std::cerr << "FAIL: double instantiation differs from default API\n";
+        return 1;
+    }
+
+    std::cout << "PASS: float32 pricing mode within documented bounds\n";
+    return 0;
+}
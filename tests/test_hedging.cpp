@@ -0,0 +1,154 @@
+// Delta-hedging backtest: the fused price/delta kernel, zero-mean P&L with
+// stdev ~ 1 / sqrt(n_steps) (Derman–Kamal), exact cost accounting, thread
+// and ISA invariance, user path sources and the P&L distribution
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "hedging.h"
+#include "black_scholes.h"
+#include "cpu_dispatch.h"
+#include "greeks.h"
+#include "utils.h"
+
+namespace {
+    bool same(const HedgeResult& a, const HedgeResult& b) {
+        return a.paths == b.paths && a.mean_pnl == b.mean_pnl && a.stdev_pnl == b.stdev_pnl &&
+               a.min_pnl == b.min_pnl && a.max_pnl == b.max_pnl && a.mean_cost == b.mean_cost &&
+               a.distribution.counts == b.distribution.counts;
+    }
+}
+
+int main() {
+    // Fused price/delta kernel against the scalar functions
+    std::vector<double> S, price(200), delta(200);
+    for (int i = 0; i < 200; i++) S.push_back(50.0 + 0.5 * i);
+    for (bool call : {true, false}) {
+        kernels().bs_price_delta(call, S.data(), S.size(), 100.0, 0.4, 0.03, 0.25, price.data(), delta.data());
+        for (std::size_t i = 0; i < S.size(); i++) {
+            const double p = call ? callPrice(S[i], 100.0, 0.4, 0.03, 0.25) : putPrice(S[i], 100.0, 0.4, 0.03, 0.25);
+            const double d = call ? callDelta(S[i], 100.0, 0.4, 0.03, 0.25) : putDelta(S[i], 100.0, 0.4, 0.03, 0.25);
+            if (std::fabs(price[i] - p) > 1e-11 || std::fabs(delta[i] - d) > 1e-13) {
+                std::cerr << "FAIL: fused price/delta at S=" << S[i] << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // Frictionless hedge at the true vol: P&L mean ~ 0, stdev ~ sqrt(pi / 4) vega sigma / sqrt(N)
+    HedgeConfig c;
+    c.S0 = 100.0; c.K = 100.0; c.T = 1.0; c.r = 0.02; c.sigma = 0.2; c.mu = 0.08;
+    c.n_paths = 20000; c.seed = 11;
+    double stdev_prev = 0.0;
+    for (std::size_t steps : {25, 100}) {
+        c.n_steps = steps;
+        const HedgeResult h = runHedgeBacktest(c);
+        if (h.paths != c.n_paths || std::fabs(h.premium - callPrice(100.0, 100.0, 1.0, 0.02, 0.2)) > 1e-12) {
+            std::cerr << "FAIL: hedge premium\n";
+            return 1;
+        }
+        // Time-T money: the premium grown at r
+        if (!(std::fabs(h.mean_pnl) < 4.0 * h.stderr_pnl + 1e-3)) {
+            std::cerr << "FAIL: hedge P&L mean " << h.mean_pnl << " (stderr " << h.stderr_pnl << ")\n";
+            return 1;
+        }
+        const double dk = std::sqrt(M_PI / 4.0) * vega(100.0, 100.0, 1.0, 0.02, 0.2) * 0.2 /
+                          std::sqrt(static_cast<double>(steps)) * std::exp(0.02);
+        if (std::fabs(h.stdev_pnl / dk - 1.0) > 0.2) {
+            std::cerr << "FAIL: hedge P&L stdev " << h.stdev_pnl << " vs Derman-Kamal " << dk << "\n";
+            return 1;
+        }
+        if (stdev_prev > 0.0 && std::fabs(stdev_prev / h.stdev_pnl - 2.0) > 0.3) {
+            std::cerr << "FAIL: stdev does not halve with 4x steps\n";
+            return 1;
+        }
+        stdev_prev = h.stdev_pnl;
+    }
+
+    // The result does not depend on the thread count or ISA level
+    c.n_steps = 50;
+    c.n_threads = 1;
+    const HedgeResult one = runHedgeBacktest(c);
+    c.n_threads = 4;
+    const HedgeResult four = runHedgeBacktest(c);
+    if (!same(one, four) || one.distribution.total != c.n_paths) {
+        std::cerr << "FAIL: hedge result depends on thread count\n";
+        return 1;
+    }
+    const IsaLevel active = activeIsa();
+    for (IsaLevel level : {IsaLevel::Generic, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (!setActiveIsa(level)) continue;
+        if (!same(runHedgeBacktest(c), one)) {
+            std::cerr << "FAIL: hedge differs at " << isaName(level) << "\n";
+            return 1;
+        }
+    }
+    setActiveIsa(active);
+
+    // Costs do not change the trades: P&L drops by exactly the costs
+    c.cost_rate = 0.002;
+    const HedgeResult costly = runHedgeBacktest(c);
+    if (!(costly.mean_cost > 0.0) || costly.mean_turnover != one.mean_turnover ||
+        std::fabs((one.mean_pnl - costly.mean_pnl) - costly.mean_cost) > 1e-12) {
+        std::cerr << "FAIL: transaction cost accounting\n";
+        return 1;
+    }
+    c.cost_rate = 0.0;
+
+    // Mark-to-market drawdowns leave the P&L untouched
+    c.track_drawdown = true;
+    const HedgeResult dd = runHedgeBacktest(c);
+    if (!same(dd, one) || !(dd.mean_max_drawdown > 0.0) || !std::isnan(one.mean_max_drawdown)) {
+        std::cerr << "FAIL: drawdown tracking\n";
+        return 1;
+    }
+    c.track_drawdown = false;
+
+    // Distribution: ordered quantiles inside [min, max], shortfall below the 5% quantile
+    const HedgeDistribution& dist = one.distribution;
+    const double q05 = dist.quantile(0.05), q50 = dist.quantile(0.5), q95 = dist.quantile(0.95);
+    if (!(one.min_pnl <= q05 && q05 < q50 && q50 < q95 && q95 <= one.max_pnl) ||
+        !(dist.expectedShortfall(0.05) <= q05) || std::fabs(q50 - one.mean_pnl) > 0.5 * one.stdev_pnl) {
+        std::cerr << "FAIL: P&L distribution " << q05 << " " << q50 << " " << q95 << "\n";
+        return 1;
+    }
+
+    // A user path source with the engine's own GBM paths gives the GBM result
+    c.n_paths = 3000;
+    const HedgeResult gbm = runHedgeBacktest(c);
+    HedgeConfig user = c;
+    user.paths = [&](std::size_t first, std::size_t n, std::size_t steps, double* rows) {
+        const double dt = c.T / static_cast<double>(steps);
+        const double drift = (c.mu - 0.5 * c.sigma * c.sigma) * dt, vol = c.sigma * std::sqrt(dt);
+        std::vector<double> z(n);
+        for (std::size_t i = 0; i < n; i++) rows[i] = c.S0;
+        for (std::size_t k = 0; k < steps; k++) {
+            std::uint64_t state = c.seed;
+            rand_skip_normals(state, first * steps + k * n);
+            rand_standard_normal_fill(state, z.data(), n);
+            for (std::size_t i = 0; i < n; i++) rows[(k + 1) * n + i] = rows[k * n + i] * std::exp(drift + vol * z[i]);
+        }
+    };
+    user.sigma = 0.0;   // paths come from the source; hedge_vol still set
+    user.hedge_vol = 0.2;
+    const HedgeResult from_source = runHedgeBacktest(user);
+    if (from_source.paths != gbm.paths || std::fabs(from_source.mean_pnl - gbm.mean_pnl) > 1e-9 ||
+        std::fabs(from_source.stdev_pnl - gbm.stdev_pnl) > 1e-9) {
+        std::cerr << "FAIL: user path source " << from_source.mean_pnl << " vs " << gbm.mean_pnl << "\n";
+        return 1;
+    }
+
+    // Invalid configurations
+    HedgeConfig bad = c;
+    bad.n_steps = 0;
+    HedgeConfig bad_vol = c;
+    bad_vol.hedge_vol = -0.1;
+    if (runHedgeBacktest(bad).paths != 0 || !std::isnan(runHedgeBacktest(bad_vol).mean_pnl)) {
+        std::cerr << "FAIL: invalid hedge config accepted\n";
+        return 1;
+    }
+
+    std::cout << "PASS: delta-hedging backtest\n";
+    return 0;
+}
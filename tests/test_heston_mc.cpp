@@ -0,0 +1,130 @@
+// Heston MC: QE-M prices match the semi-analytic (COS) prices, two QE steps
+// beat eight full-truncation Euler steps, the martingale correction keeps
+// E[S_T] exact, the European control cuts Asian stderr, and block merges
+// reproduce the run bit for bit
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "heston_mc.h"
+#include "pricing_session.h"
+
+namespace {
+    double cos_price(const HestonOption& o) {
+        const CharFn cf = hestonCharFn(o.T, o.r, o.params);
+        return o.is_call ? cosCallPrices(cf, o.S, {o.K}, 4096, 40.0)[0] : cosPutPrices(cf, o.S, {o.K}, 4096, 40.0)[0];
+    }
+}
+
+int main() {
+    // Feller condition violated: 2 kappa theta = 0.16 < xi^2 = 0.36
+    HestonOption o;
+    o.S = 100.0; o.T = 1.0; o.r = 0.03;
+    o.params = {2.0, 0.04, 0.6, -0.7, 0.04};
+    const std::size_t n = 200000;
+
+    HestonMCOptions qe8, qe2, euler8;
+    qe2.n_steps = 2;
+    euler8.scheme = HestonScheme::Euler;
+
+    double qe2_worst = 0.0, euler8_best = HUGE_VAL;
+    for (double K : {80.0, 100.0, 120.0}) {
+        for (bool is_call : {true, false}) {
+            o.K = K;
+            o.is_call = is_call;
+            const double ref = cos_price(o);
+            const MCResult r = mcHestonPrice(o, n, 7, MCMode::Antithetic, qe8);
+            if (!(std::fabs(r.price - ref) < 4.0 * r.stderr)) {
+                std::cerr << "FAIL: QE-M K=" << K << (is_call ? " call " : " put ") << r.price
+                          << " (stderr " << r.stderr << ") vs COS " << ref << "\n";
+                return 1;
+            }
+            if (is_call) {
+                qe2_worst = std::max(qe2_worst, std::fabs(mcHestonPrice(o, n, 7, MCMode::Antithetic, qe2).price - ref));
+                euler8_best = std::min(euler8_best, std::fabs(mcHestonPrice(o, n, 7, MCMode::Antithetic, euler8).price - ref));
+            }
+        }
+    }
+    // Fewer steps for the same bias: 2 QE steps already beat 8 Euler steps
+    if (!(qe2_worst < 0.5 * euler8_best)) {
+        std::cerr << "FAIL: QE-M with 2 steps (bias " << qe2_worst << ") vs Euler with 8 (" << euler8_best << ")\n";
+        return 1;
+    }
+
+    // Andersen's case I (xi = 1, rho = -0.9, T = 10): a call struck near 0
+    // is the discounted S_T, whose mean the martingale correction keeps at S
+    HestonOption m;
+    m.S = 100.0; m.K = 1e-6; m.T = 10.0; m.r = 0.0;
+    m.params = {0.5, 0.04, 1.0, -0.9, 0.04};
+    for (std::size_t steps : {2, 5, 10}) {
+        HestonMCOptions opt;
+        opt.n_steps = steps;
+        const MCResult r = mcHestonPrice(m, 100000, 3, MCMode::Plain, opt);
+        if (!(std::fabs(r.price - (m.S - m.K)) < 4.0 * r.stderr)) {
+            std::cerr << "FAIL: QE-M E[S_T] with " << steps << " steps " << r.price << " (stderr " << r.stderr << ")\n";
+            return 1;
+        }
+    }
+    HestonMCOptions uncorrected;
+    uncorrected.n_steps = 2;
+    uncorrected.martingale_correction = false;
+    const MCResult drift = mcHestonPrice(m, 100000, 3, MCMode::Plain, uncorrected);
+    if (!(std::fabs(drift.price - (m.S - m.K)) > 10.0 * drift.stderr)) {
+        std::cerr << "FAIL: plain QE should miss E[S_T] at 2 steps: " << drift.price << "\n";
+        return 1;
+    }
+
+    // Asian call with the European Heston price as control
+    HestonOption a = o;
+    a.asian = true;
+    a.is_call = true;
+    a.K = 100.0;
+    const MCResult plain = mcHestonPrice(a, n, 7, MCMode::Plain);
+    const MCResult both = mcHestonPrice(a, n, 7, MCMode::AntitheticControlBS);
+    if (!(both.stderr < 0.35 * plain.stderr) ||
+        !(std::fabs(both.price - plain.price) < 4.0 * std::hypot(plain.stderr, both.stderr))) {
+        std::cerr << "FAIL: Asian control " << both.price << " (stderr " << both.stderr << ") vs plain "
+                  << plain.price << " (stderr " << plain.stderr << ")\n";
+        return 1;
+    }
+
+    // Merged blocks reproduce the run bit for bit
+    ScratchArena arena(std::size_t(1) << 20);
+    for (MCMode mode : {MCMode::Plain, MCMode::AntitheticControlBS}) {
+        const std::size_t paths = 10000;
+        const MCResult whole = mcHestonPrice(a, paths, 11, mode, qe8);
+        MCPartial total;
+        for (std::size_t b = 0; b < mcBlockCount(paths); b++) {
+            mcMerge(total, mcHestonBlock(a, qe8, paths, 11, mode, b, arena));
+        }
+        const MCResult merged = mcFinalize(total);
+        if (merged.price != whole.price || merged.stderr != whole.stderr) {
+            std::cerr << "FAIL: Heston block merge\n";
+            return 1;
+        }
+    }
+
+    // Expiry, unsupported modes and invalid inputs
+    HestonOption e = o;
+    e.is_call = true;
+    e.K = 90.0;
+    e.T = 0.0;
+    const MCResult expiry = mcHestonPrice(e, 1000, 1);
+    HestonOption bad = o;
+    bad.params.xi = 0.0;
+    HestonMCOptions bad_psi;
+    bad_psi.psi_c = 3.0;
+    if (expiry.price != 10.0 || expiry.stderr != 0.0 ||
+        !std::isnan(mcHestonPrice(o, 1000, 1, MCMode::ImportanceSampling).price) ||
+        !std::isnan(mcHestonPrice(o, 1000, 1, MCMode::MomentMatching).price) ||
+        !std::isnan(mcHestonPrice(bad, 1000, 1).price) ||
+        !std::isnan(mcHestonPrice(o, 1000, 1, MCMode::Plain, bad_psi).price) ||
+        !std::isnan(mcHestonPrice(o, 1, 1).price)) {
+        std::cerr << "FAIL: Heston edge cases\n";
+        return 1;
+    }
+
+    std::cout << "PASS: Heston QE Monte Carlo\n";
+    return 0;
+}
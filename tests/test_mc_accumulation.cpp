@@ -0,0 +1,127 @@
+// MC block accumulation: means and centred co-moments stay exact for
+// payoffs whose variance is tiny next to their mean, over a billion merged
+// samples from blocks with different means, and the control-variate partial
+// carries the same X moments as the plain one
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "monte_carlo.h"
+#include "mc_shard.h"
+#include "pricing_session.h"
+
+namespace {
+    bool close(double got, double want, double rel, const char* what) {
+        if (!(std::fabs(got - want) <= rel * std::fabs(want))) {
+            std::cerr << "FAIL: " << what << " " << got << " vs " << want << "\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    // A block with mean 2^20 and deviations of 2^-10: every value is exact,
+    // so the moments are known. Raw power sums lose all of them here
+    // (the rounding of sum X^2 ~ 2^40 n dwarfs sum (X - mean)^2 ~ 2^-20 n).
+    const double u = std::ldexp(1.0, -10);
+    std::vector<double> X(kMCBlockPaths), Y(kMCBlockPaths);
+    for (std::size_t i = 0; i < kMCBlockPaths; i++) {
+        const double s = (i % 2 == 0) ? 1.0 : -1.0;
+        const double t = (i % 4 < 2) ? 1.0 : -1.0;
+        X[i] = 1048576.0 + s * u;
+        Y[i] = 524288.0 - 2.0 * s * u + t * u;
+    }
+    const MCPartial block = mcAccumulate(X.data(), Y.data(), X.size(), true, 524288.0);
+    const double nb = static_cast<double>(kMCBlockPaths);
+    if (block.mean != 1048576.0 || block.meanY != 524288.0 || block.M2 != nb * u * u ||
+        block.M2Y != 5.0 * nb * u * u || block.C != -2.0 * nb * u * u) {
+        std::cerr << "FAIL: block moments " << block.M2 << " " << block.M2Y << " " << block.C << "\n";
+        return 1;
+    }
+
+    // Blocks b whose means move by x_b = a_b k u and y_b = (-2 a_b + c_b) k u,
+    // a_b = +-1 alternating and c_b = +-1 in pairs: over a multiple of four
+    // blocks the offsets average to zero and add k^2 times the within-block
+    // moments between blocks, so every merge exercises the mean-difference
+    // terms of the pairwise update
+    const double k = 3.0;
+    MCPartial shifted[4];
+    for (std::size_t b = 0; b < 4; b++) {
+        const double a = (b % 2 == 0) ? 1.0 : -1.0;
+        const double c = (b < 2) ? 1.0 : -1.0;
+        std::vector<double> Xb(X), Yb(Y);
+        for (std::size_t i = 0; i < kMCBlockPaths; i++) {
+            Xb[i] += a * k * u;
+            Yb[i] += (-2.0 * a + c) * k * u;
+        }
+        shifted[b] = mcAccumulate(Xb.data(), Yb.data(), Xb.size(), true, 524288.0);
+        if (shifted[b].mean != 1048576.0 + a * k * u || shifted[b].M2 != block.M2 ||
+            shifted[b].M2Y != block.M2Y || shifted[b].C != block.C) {
+            std::cerr << "FAIL: shifted block moments\n";
+            return 1;
+        }
+    }
+
+    // 250000 merged blocks: 1.024e9 samples. The running mean rounds to
+    // 2^-32 against offsets of 3 2^-10, which bounds the between-block
+    // terms to about 1e-8 relative; raw sums would lose every digit
+    MCPartial total;
+    const std::size_t merges = 250000;
+    for (std::size_t b = 0; b < merges; b++) mcMerge(total, shifted[b % 4]);
+    const double N = static_cast<double>(total.n);
+    const double spread = 1.0 + k * k;
+    if (total.n != merges * kMCBlockPaths ||
+        !close(total.mean, 1048576.0, 1e-15, "merged mean") ||
+        !close(total.meanY, 524288.0, 1e-15, "merged mean(Y)") ||
+        !close(total.M2 / (N - 1.0), N / (N - 1.0) * spread * u * u, 1e-7, "merged var(X)") ||
+        !close(total.M2Y / (N - 1.0), N / (N - 1.0) * 5.0 * spread * u * u, 1e-7, "merged var(Y)") ||
+        !close(total.C / (N - 1.0), -N / (N - 1.0) * 2.0 * spread * u * u, 1e-7, "merged cov(X, Y)")) {
+        return 1;
+    }
+    // b = -0.4: the controlled variance is var(X) - cov^2 / var(Y) = 0.2 var(X)
+    const MCResult cv = mcFinalize(total);
+    if (!close(cv.stderr, std::sqrt(0.2 * spread * u * u / (N - 1.0)), 1e-7, "controlled stderr")) return 1;
+
+    // Plain partial of the same block
+    const MCPartial plain = mcAccumulate(X.data(), nullptr, X.size(), false, 0.0);
+    if (plain.M2 != block.M2 || plain.mean != block.mean) {
+        std::cerr << "FAIL: plain block moments\n";
+        return 1;
+    }
+
+    // Deep in-the-money call with a tiny vol: X = Y - df K per path, so the
+    // control partial's X moments match the plain ones and X, Y are
+    // perfectly correlated
+    ScratchArena arena(std::size_t(1) << 20);
+    for (double sigma : {1e-4, 1e-7}) {
+        const MCPartial p = mcCallBlock(1e4, 1.0, 1.0, 0.02, sigma, 10000, 3, MCMode::Plain, 0, arena);
+        const MCPartial c = mcCallBlock(1e4, 1.0, 1.0, 0.02, sigma, 10000, 3, MCMode::ControlVariateBS, 0, arena);
+        if (!(p.M2 > 0.0) || !close(c.M2, p.M2, 1e-9, "control-mode var(X)") ||
+            !close(c.M2Y, p.M2, 1e-6, "var(Y) of a linear payoff") ||
+            !close(c.C / std::sqrt(c.M2 * c.M2Y), 1.0, 1e-6, "correlation of a linear payoff")) {
+            return 1;
+        }
+    }
+
+    // Partials still round-trip through the shard format bit for bit
+    for (MCMode mode : {MCMode::Plain, MCMode::AntitheticControlBS}) {
+        const MCJob job{true, 100.0, 100.0, 1.0, 0.03, 0.2, 20000, 9, mode};
+        const MCShardState shard = mcRunBlocks(job, 0, mcBlockCount(job.n_paths), arena);
+        MCShardState back;
+        if (!mcParseShard(mcSerializeShard(shard), back)) {
+            std::cerr << "FAIL: shard parse\n";
+            return 1;
+        }
+        const MCResult a = mcFinalize(shard), b = mcFinalize(back);
+        const MCResult direct = mcCallPrice(100.0, 100.0, 1.0, 0.03, 0.2, 20000, 9, mode);
+        if (a.price != b.price || a.stderr != b.stderr || a.price != direct.price || a.stderr != direct.stderr) {
+            std::cerr << "FAIL: shard round trip\n";
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: MC accumulation\n";
+    return 0;
+}
@@ -0,0 +1,222 @@
+// MC result cache: hits return the engine's bits, keys are exact input bits,
+// LRU eviction, the persistent store across instances, invalidation by
+// version tag, torn-record recovery, stores shared between writers and
+// concurrent use
+
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "mc_cache.h"
+
+namespace {
+    bool same_bits(const MCResult& a, const MCResult& b) {
+        return a.price == b.price && a.stderr == b.stderr && a.ci_low == b.ci_low && a.ci_high == b.ci_high;
+    }
+}
+
+int main() {
+    const MCJob call{true, 100.0, 105.0, 1.0, 0.03, 0.25, 20000, 7, MCMode::AntitheticControlBS};
+    const MCResult direct = mcCallPrice(call.S, call.K, call.T, call.r, call.sigma, call.n_paths, call.seed, call.mode);
+
+    // Miss then hit, both the engine's bits
+    MCResultCache cache(1024);
+    const MCResult first = cache.price(call);
+    const MCResult second = cache.price(call);
+    MCCacheStats st = cache.stats();
+    if (!same_bits(first, direct) || !same_bits(second, direct) || st.lookups != 2 || st.hits != 1 ||
+        st.misses != 1 || st.inserts != 1 || st.hitRate() != 0.5 || st.compute_ns == 0) {
+        std::cerr << "FAIL: cache miss/hit\n";
+        return 1;
+    }
+
+    // Every input is part of the key, to the bit
+    MCJob put = call;
+    put.is_call = false;
+    MCJob other_seed = call;
+    other_seed.seed = 8;
+    MCJob other_mode = call;
+    other_mode.mode = MCMode::Plain;
+    MCJob neg_zero = call;
+    neg_zero.r = 0.0;
+    MCJob pos_zero = neg_zero;
+    neg_zero.r = -0.0;
+    MCResult tmp;
+    cache.price(pos_zero);
+    if (cache.lookup(put, tmp) || cache.lookup(other_seed, tmp) || cache.lookup(other_mode, tmp) ||
+        cache.lookup(neg_zero, tmp) || !cache.lookup(pos_zero, tmp)) {
+        std::cerr << "FAIL: cache key collision\n";
+        return 1;
+    }
+    if (!same_bits(cache.price(put), mcPutPrice(put.S, put.K, put.T, put.r, put.sigma, put.n_paths, put.seed, put.mode))) {
+        std::cerr << "FAIL: cached put\n";
+        return 1;
+    }
+
+    // Invalid inputs are priced (NAN) but never cached
+    MCJob bad = call;
+    bad.sigma = -1.0;
+    if (!std::isnan(cache.price(bad).price) || cache.lookup(bad, tmp)) {
+        std::cerr << "FAIL: NAN result cached\n";
+        return 1;
+    }
+
+    // LRU: a full cache evicts the least recently used entries
+    MCResultCache small(32);
+    MCResult fake = direct;
+    for (std::uint64_t s = 0; s < 200; s++) {
+        MCJob j = call;
+        j.seed = s;
+        fake.price = static_cast<double>(s);
+        small.insert(j, fake);
+    }
+    MCJob newest = call;
+    newest.seed = 199;
+    MCJob oldest = call;
+    oldest.seed = 0;
+    if (small.stats().evictions < 200 - 32 || !small.lookup(newest, tmp) || tmp.price != 199.0 ||
+        small.lookup(oldest, tmp)) {
+        std::cerr << "FAIL: LRU eviction\n";
+        return 1;
+    }
+
+    // Persistent store: results survive the instance, bit for bit
+    const std::string path = "test_mc_cache.store";
+    std::remove(path.c_str());
+    {
+        MCResultCache writer(64);
+        if (!writer.openStore(path)) {
+            std::cerr << "FAIL: cannot create store\n";
+            return 1;
+        }
+        writer.price(call);
+        writer.price(put);
+        writer.price(call);
+        if (writer.stats().store_records != 2) {
+            std::cerr << "FAIL: store records " << writer.stats().store_records << "\n";
+            return 1;
+        }
+    }
+    {
+        // Torn trailing record from an interrupted append is dropped
+        std::ofstream f(path, std::ios::binary | std::ios::app);
+        f << "torn";
+    }
+    {
+        MCResultCache reader(64);
+        if (!reader.openStore(path) || reader.stats().store_records != 2 || !reader.lookup(call, tmp) ||
+            !same_bits(tmp, direct) || reader.stats().store_hits != 1) {
+            std::cerr << "FAIL: store reload\n";
+            return 1;
+        }
+        // Promoted to memory: the next hit does not touch the store
+        if (!reader.lookup(call, tmp) || reader.stats().store_hits != 1) {
+            std::cerr << "FAIL: store hit not promoted\n";
+            return 1;
+        }
+    }
+    {
+        // Another engine version invalidates the store
+        MCResultCache bumped(64, kMCEngineVersion + 1);
+        if (!bumped.openStore(path) || bumped.stats().store_records != 0 || bumped.lookup(call, tmp)) {
+            std::cerr << "FAIL: stale store served\n";
+            return 1;
+        }
+    }
+    {
+        MCResultCache again(64);
+        if (!again.openStore(path) || again.stats().store_records != 0) {
+            std::cerr << "FAIL: store not cleared on version change\n";
+            return 1;
+        }
+    }
+    std::remove(path.c_str());
+
+    // Two writers on one store (separate descriptors, as separate processes
+    // have): interleaved appends all land, and a version reset by a third
+    // leaves the first's mapping readable
+    {
+        MCResultCache a(64), b(64);
+        if (!a.openStore(path) || !b.openStore(path)) {
+            std::cerr << "FAIL: shared store open\n";
+            return 1;
+        }
+        fake = direct;
+        for (std::uint64_t s = 0; s < 20; s++) {
+            MCJob j = call;
+            j.seed = 1000 + s;
+            fake.price = static_cast<double>(s);
+            (s % 2 ? b : a).insert(j, fake);
+        }
+        MCResultCache mapped(64);
+        if (!mapped.openStore(path) || mapped.stats().store_records != 20) {
+            std::cerr << "FAIL: concurrent appends lost records (" << mapped.stats().store_records << ")\n";
+            return 1;
+        }
+
+        MCResultCache bumped(64, kMCEngineVersion + 1);
+        if (!bumped.openStore(path) || bumped.stats().store_records != 0) {
+            std::cerr << "FAIL: shared store reset\n";
+            return 1;
+        }
+        MCJob j = call;
+        j.seed = 1013;
+        if (!mapped.lookup(j, tmp) || tmp.price != 13.0) {
+            std::cerr << "FAIL: mapping lost on reset\n";
+            return 1;
+        }
+    }
+    std::remove(path.c_str());
+
+    // A file that is not a store is refused and left alone
+    const std::string foreign = "test_mc_cache.txt";
+    {
+        std::ofstream f(foreign);
+        f << "not a cache store, just some text\n";
+    }
+    MCResultCache refuse(16);
+    std::ifstream check(foreign);
+    std::string line;
+    if (refuse.openStore(foreign) || !std::getline(check, line) || line != "not a cache store, just some text") {
+        std::cerr << "FAIL: foreign file used as store\n";
+        return 1;
+    }
+    std::remove(foreign.c_str());
+
+    // Concurrent callers over overlapping keys all get the engine's bits
+    MCResultCache shared(256);
+    std::vector<MCResult> expected(16);
+    for (std::uint64_t s = 0; s < 16; s++) {
+        expected[s] = mcCallPrice(call.S, call.K, call.T, call.r, call.sigma, 5000, s, call.mode);
+    }
+    std::vector<int> ok(4, 1);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (std::size_t i = 0; i < 64; i++) {
+                MCJob j = call;
+                j.n_paths = 5000;
+                j.seed = (i * 7 + t) % 16;
+                if (!same_bits(shared.price(j), expected[j.seed])) ok[t] = 0;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    st = shared.stats();
+    for (int v : ok) {
+        if (!v) {
+            std::cerr << "FAIL: concurrent cache result\n";
+            return 1;
+        }
+    }
+    if (st.lookups != 256 || st.hits + st.misses != 256 || st.misses < 16) {
+        std::cerr << "FAIL: concurrent cache counters\n";
+        return 1;
+    }
+
+    std::cout << "PASS: MC result cache\n";
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Importance sampling: unbiased against Black–Scholes across moneyness and
+// far more accurate than plain MC on 3-5 sigma out-of-the-money wings
+
+#include <iostream>
+#include <cmath>
+
+#include "black_scholes.h"
+#include "monte_carlo.h"
+#include "pricing_session.h"
+
+int main() {
+    const double S = 100.0, T = 1.0, r = 0.02, sigma = 0.2;
+    const std::size_t n = 100000;
+    const std::uint64_t seed = 11;
+
+    // Strikes k standard deviations from the forward, both wings
+    for (double k : {-5.0, -3.0, -1.0, 0.0, 1.0, 3.0, 5.0}) {
+        const double K = S * std::exp(r * T + k * sigma * std::sqrt(T));
+        const bool call = k >= 0.0;
+        const double bs = call ? callPrice(S, K, T, r, sigma) : putPrice(S, K, T, r, sigma);
+
+        for (MCMode mode : {MCMode::ImportanceSampling, MCMode::AntitheticImportance}) {
+            const MCResult is = call ? mcCallPrice(S, K, T, r, sigma, n, seed, mode)
+                                     : mcPutPrice(S, K, T, r, sigma, n, seed, mode);
+            if (!(std::fabs(is.price - bs) <= 4.0 * is.stderr + 1e-14)) {
+                std::cerr << "FAIL: IS price " << is.price << " vs BS " << bs << " at k=" << k << "\n";
+                return 1;
+            }
+            if (std::fabs(k) >= 3.0 && !(is.stderr < 0.01 * bs)) {
+                std::cerr << "FAIL: IS relative stderr " << is.stderr / bs << " at k=" << k << "\n";
+                return 1;
+            }
+        }
+
+        if (std::fabs(k) == 3.0) {
+            const MCResult plain = call ? mcCallPrice(S, K, T, r, sigma, n, seed, MCMode::Plain)
+                                        : mcPutPrice(S, K, T, r, sigma, n, seed, MCMode::Plain);
+            const MCResult is = call ? mcCallPrice(S, K, T, r, sigma, n, seed, MCMode::ImportanceSampling)
+                                     : mcPutPrice(S, K, T, r, sigma, n, seed, MCMode::ImportanceSampling);
+            if (!(is.stderr * 10.0 < plain.stderr)) {
+                std::cerr << "FAIL: IS stderr " << is.stderr << " not 10x below plain " << plain.stderr
+                          << " at k=" << k << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // Block partials merged in order reproduce the one-shot run bitwise
+    const double K = 180.0;
+    const std::size_t paths = 50000;
+    const MCResult whole = mcCallPrice(S, K, T, r, sigma, paths, 3, MCMode::AntitheticImportance);
+    ScratchArena arena(std::size_t(1) << 18);
+    MCPartial total;
+    for (std::size_t b = 0; b < mcBlockCount(paths); b++) {
+        mcMerge(total, mcCallBlock(S, K, T, r, sigma, paths, 3, MCMode::AntitheticImportance, b, arena));
+    }
+    const MCResult merged = mcFinalize(total);
+    if (merged.price != whole.price || merged.stderr != whole.stderr) {
+        std::cerr << "FAIL: IS block merge differs from the one-shot run\n";
+        return 1;
+    }
+
+    std::cout << "PASS: importance sampling\n";
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Moment matching and empirical martingale correction: unbiased against BS,
+// batch-means stderr that matches the spread over seeds, variance well below
+// antithetics, an exact martingale, and block / shard / single-block rules
+
+#include <iostream>
+#include <cmath>
+
+#include "monte_carlo.h"
+#include "mc_shard.h"
+#include "black_scholes.h"
+#include "pricing_session.h"
+#include "term_structure.h"
+
+namespace {
+    const MCMode kModes[] = {MCMode::MomentMatching, MCMode::AntitheticMomentMatching,
+                             MCMode::MartingaleCorrection, MCMode::AntitheticMartingale};
+}
+
+int main() {
+    const double S = 100.0, T = 1.0, r = 0.03, sigma = 0.25;
+    const std::size_t n = 200000;
+
+    // Within 4 stderr of Black–Scholes, calls and puts across strikes
+    for (MCMode mode : kModes) {
+        for (double K : {80.0, 100.0, 130.0}) {
+            const MCResult c = mcCallPrice(S, K, T, r, sigma, n, 7, mode);
+            const MCResult p = mcPutPrice(S, K, T, r, sigma, n, 7, mode);
+            if (!(std::fabs(c.price - callPrice(S, K, T, r, sigma)) < 4.0 * c.stderr) ||
+                !(std::fabs(p.price - putPrice(S, K, T, r, sigma)) < 4.0 * p.stderr)) {
+                std::cerr << "FAIL: mode " << static_cast<int>(mode) << " K=" << K << " call " << c.price
+                          << " (stderr " << c.stderr << "), put " << p.price << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // Batch means: the reported stderr matches the spread of prices over seeds
+    for (MCMode mode : {MCMode::AntitheticMomentMatching, MCMode::MartingaleCorrection}) {
+        const int seeds = 40;
+        double sum = 0.0, sum2 = 0.0, se = 0.0;
+        for (int s = 0; s < seeds; s++) {
+            const MCResult res = mcCallPrice(S, 100.0, T, r, sigma, 100000, 1000 + s, mode);
+            sum += res.price;
+            sum2 += res.price * res.price;
+            se += res.stderr / seeds;
+        }
+        const double sd = std::sqrt((sum2 - sum * sum / seeds) / (seeds - 1));
+        if (!(se > 0.65 * sd && se < 1.5 * sd)) {
+            std::cerr << "FAIL: batch-means stderr " << se << " vs spread over seeds " << sd << "\n";
+            return 1;
+        }
+    }
+
+    // Few batches: three blocks leave two degrees of freedom, and the
+    // t interval still covers the BS price 95% of the time (a normal
+    // quantile would cover about 81%)
+    for (MCMode mode : {MCMode::MomentMatching, MCMode::AntitheticMartingale}) {
+        const int seeds = 400;
+        int covered = 0;
+        const double bs = callPrice(S, 100.0, T, r, sigma);
+        for (int s = 0; s < seeds; s++) {
+            const MCResult res = mcCallPrice(S, 100.0, T, r, sigma, 3 * kMCBlockPaths, 5000 + s, mode);
+            if (res.ci_low <= bs && bs <= res.ci_high) covered++;
+        }
+        const double coverage = static_cast<double>(covered) / seeds;
+        if (!(coverage > 0.915 && coverage < 0.985)) {
+            std::cerr << "FAIL: 3-batch CI coverage " << coverage << "\n";
+            return 1;
+        }
+    }
+
+    // Well beyond antithetics for smooth payoffs: in the money, and at the money
+    for (double K : {80.0, 100.0}) {
+        const MCResult anti = mcCallPrice(S, K, T, r, sigma, n, 7, MCMode::Antithetic);
+        const MCResult mm = mcCallPrice(S, K, T, r, sigma, n, 7, MCMode::AntitheticMomentMatching);
+        if (!(mm.stderr < (K < 100.0 ? 0.2 : 0.5) * anti.stderr)) {
+            std::cerr << "FAIL: moment matching stderr " << mm.stderr << " vs antithetic " << anti.stderr << "\n";
+            return 1;
+        }
+    }
+
+    // The correction makes the discounted S_T mean exactly spot: a call
+    // struck near zero is worth S - K df with no sampling error left
+    const double K0 = 1e-6;
+    for (MCMode mode : {MCMode::MartingaleCorrection, MCMode::AntitheticMartingale}) {
+        const MCResult c = mcCallPrice(S, K0, T, r, sigma, 50000, 3, mode);
+        if (!(std::fabs(c.price - (S - K0 * std::exp(-r * T))) < 1e-10) || !(c.stderr < 1e-10)) {
+            std::cerr << "FAIL: martingale correction " << c.price << " (stderr " << c.stderr << ")\n";
+            return 1;
+        }
+    }
+    // ... and on term-structure grids, where the target is S e^{-int q}
+    const MarketCurves curves = MarketCurves::flat(r, sigma, 0.02);
+    const MCResult tc = mcCallPrice(S, K0, T, curves, 50000, 3, MCMode::AntitheticMartingale);
+    if (!(std::fabs(tc.price - (S * std::exp(-0.02 * T) - K0 * std::exp(-r * T))) < 1e-10)) {
+        std::cerr << "FAIL: martingale correction on curves " << tc.price << "\n";
+        return 1;
+    }
+    const MCResult tm = mcCallPrice(S, 100.0, T, curves, n, 5, MCMode::AntitheticMomentMatching);
+    if (!(std::fabs(tm.price - callPrice(S * std::exp(-0.02 * T), 100.0, T, r, sigma)) < 4.0 * tm.stderr)) {
+        std::cerr << "FAIL: moment matching on curves " << tm.price << "\n";
+        return 1;
+    }
+
+    // Single precision uses the same post-processing
+    const MCResult f = mcCallPriceT<float>(S, 100.0, T, r, sigma, n, 7, MCMode::AntitheticMomentMatching);
+    const MCResult d = mcCallPrice(S, 100.0, T, r, sigma, n, 7, MCMode::AntitheticMomentMatching);
+    if (!(std::fabs(f.price - d.price) < 0.1 * d.stderr)) {
+        std::cerr << "FAIL: float moment matching " << f.price << " vs " << d.price << "\n";
+        return 1;
+    }
+
+    // Block-wise: merged block partials and shards reproduce the run bit for bit
+    ScratchArena arena(std::size_t(1) << 20);
+    for (MCMode mode : kModes) {
+        const std::size_t paths = 30000;
+        const MCResult whole = mcPutPrice(S, 95.0, T, r, sigma, paths, 11, mode);
+        MCPartial total;
+        for (std::size_t b = 0; b < mcBlockCount(paths); b++) {
+            mcMerge(total, mcPutBlock(S, 95.0, T, r, sigma, paths, 11, mode, b, arena));
+        }
+        const MCResult merged = mcFinalize(total);
+
+        const MCJob job{false, S, 95.0, T, r, sigma, paths, 11, mode};
+        MCShardState lo = mcRunBlocks(job, 0, 3, arena), hi, back;
+        if (!mcParseShard(mcSerializeShard(mcRunBlocks(job, 3, mcBlockCount(paths), arena)), hi) ||
+            !mcMergeShards(lo, hi) || !mcParseShard(mcSerializeShard(lo), back)) {
+            std::cerr << "FAIL: shards of mode " << static_cast<int>(mode) << "\n";
+            return 1;
+        }
+        const MCResult sharded = mcFinalize(back);
+        if (total.batches != mcBlockCount(paths) || merged.price != whole.price || merged.stderr != whole.stderr ||
+            sharded.price != whole.price || sharded.stderr != whole.stderr) {
+            std::cerr << "FAIL: block merge of mode " << static_cast<int>(mode) << "\n";
+            return 1;
+        }
+    }
+
+    // One block gives no batch-means stderr
+    const MCResult one = mcCallPrice(S, 100.0, T, r, sigma, kMCBlockPaths, 7, MCMode::MomentMatching);
+    if (!std::isfinite(one.price) || !std::isnan(one.stderr)) {
+        std::cerr << "FAIL: single-block run " << one.price << " " << one.stderr << "\n";
+        return 1;
+    }
+
+    std::cout << "PASS: moment matching and martingale correction\n";
+    return 0;
+}
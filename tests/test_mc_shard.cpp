@@ -0,0 +1,103 @@
+// Sharded MC: serialized shard states merged in any grouping finalize to
+// exactly the single-process result; mismatched or gapped merges are refused
+
+#include <iostream>
+#include <cmath>
+
+#include "mc_shard.h"
+#include "pricing_session.h"
+
+static bool same(const MCResult& a, const MCResult& b) {
+    return a.price == b.price && a.stderr == b.stderr && a.ci_low == b.ci_low && a.ci_high == b.ci_high;
+}
+
+int main() {
+    ScratchArena arena(std::size_t(1) << 18);
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS, MCMode::ImportanceSampling};
+
+    for (MCMode mode : modes) {
+        for (bool is_call : {true, false}) {
+            const MCJob job{is_call, 100.0, 105.0, 0.75, 0.03, 0.25, 10 * kMCBlockPaths + 123, 99, mode};
+            const MCResult whole = is_call
+                ? mcCallPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, mode)
+                : mcPutPrice(job.S, job.K, job.T, job.r, job.sigma, job.n_paths, job.seed, mode);
+
+            for (std::size_t n_shards : {1, 2, 3, 5, 11, 16}) {
+                // Each shard goes through its text form, as between processes
+                std::vector<MCShardState> parts;
+                for (std::size_t i = 0; i < n_shards; i++) {
+                    std::size_t first = 0, last = 0;
+                    mcShardRange(job.n_paths, i, n_shards, first, last);
+                    MCShardState s;
+                    if (!mcParseShard(mcSerializeShard(mcRunBlocks(job, first, last, arena)), s)) {
+                        std::cerr << "FAIL: shard state does not round-trip\n";
+                        return 1;
+                    }
+                    parts.push_back(s);
+                }
+
+                // Left fold in order, and right-to-left (prepending)
+                MCShardState left = parts.front(), right = parts.back();
+                for (std::size_t i = 1; i < n_shards; i++) {
+                    if (!mcMergeShards(left, parts[i]) || !mcMergeShards(right, parts[n_shards - 1 - i])) {
+                        std::cerr << "FAIL: adjacent shards refused\n";
+                        return 1;
+                    }
+                }
+                if (!left.complete() || !same(mcFinalize(left), whole) || !same(mcFinalize(right), whole)) {
+                    std::cerr << "FAIL: merged shards differ from the single run ("
+                              << n_shards << " shards)\n";
+                    return 1;
+                }
+            }
+
+            // Checkpoint and resume: first 4 blocks saved, remainder run later
+            MCShardState ckpt;
+            mcParseShard(mcSerializeShard(mcRunBlocks(job, 0, 4, arena)), ckpt);
+            if (!mcMergeShards(ckpt, mcRunBlocks(job, 4, mcBlockCount(job.n_paths), arena)) ||
+                !same(mcFinalize(ckpt), whole)) {
+                std::cerr << "FAIL: resumed run differs from the single run\n";
+                return 1;
+            }
+        }
+    }
+
+    // Refusals: gaps, overlaps and other runs
+    {
+        const MCJob job{true, 100.0, 100.0, 1.0, 0.05, 0.2, 8 * kMCBlockPaths, 1, MCMode::Plain};
+        MCJob other = job;
+        other.seed = 2;
+        MCShardState a = mcRunBlocks(job, 0, 3, arena);
+        const std::size_t before = a.blocks.size();
+        if (mcMergeShards(a, mcRunBlocks(job, 4, 8, arena)) || mcMergeShards(a, mcRunBlocks(job, 2, 5, arena)) ||
+            mcMergeShards(a, mcRunBlocks(other, 3, 8, arena)) || a.blocks.size() != before || a.complete()) {
+            std::cerr << "FAIL: invalid merge accepted\n";
+            return 1;
+        }
+        MCShardState bad;
+        if (mcParseShard("mcshard 2\n", bad) || mcParseShard("garbage", bad)) {
+            std::cerr << "FAIL: malformed state parsed\n";
+            return 1;
+        }
+
+        // Another engine version, and counts the file cannot hold
+        const std::string text = mcSerializeShard(mcRunBlocks(job, 0, 2, arena));
+        const std::string engine = " " + std::to_string(kMCEngineVersion) + "\n";
+        std::string foreign = text;
+        foreign.replace(foreign.find(engine), engine.size(), " " + std::to_string(kMCEngineVersion + 1) + "\n");
+        const std::string job_line = text.substr(text.find("job"), text.find("blocks") - text.find("job"));
+        const std::string header = text.substr(0, text.find("job"));
+        const std::string huge = header + "job call 0x1.9p+6 0x1.9p+6 0x1p+0 0x1p-4 0x1p-2 18446744073709551615 1 0\n";
+        if (!mcParseShard(text, bad) || mcParseShard(foreign, bad) ||
+            mcParseShard(huge + "blocks 0 4503599627370496\n", bad) ||
+            mcParseShard(huge + "blocks 18446744073709551615 2\n", bad) ||
+            mcParseShard(header + job_line + "blocks 0 2\n", bad)) {
+            std::cerr << "FAIL: foreign or oversized shard parsed\n";
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: sharded MC\n";
+    return 0;
+}
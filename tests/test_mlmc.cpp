@@ -0,0 +1,99 @@
+// Multilevel MC: accuracy against Black–Scholes, Asian parity, level
+// structure and the eps^-2 cost growth of the Milstein coupling
+
+#include <iostream>
+#include <cmath>
+
+#include "black_scholes.h"
+#include "monte_carlo.h"
+
+int main() {
+    const double S = 100.0, K = 100.0, T = 1.0, r = 0.05, sigma = 0.2;
+
+    // European call within the requested RMSE (3 eps allows for the bias)
+    for (MLMCScheme scheme : {MLMCScheme::Euler, MLMCScheme::Milstein}) {
+        MLMCOptions opt;
+        opt.scheme = scheme;
+        opt.target_rmse = 0.02;
+        const MLMCResult res = mlmcPrice(MLMCPayoff::EuropeanCall, S, K, T, r, sigma, 5, opt);
+        const double bs = callPrice(S, K, T, r, sigma);
+        if (!res.converged || !(std::fabs(res.result.price - bs) < 3.0 * opt.target_rmse)) {
+            std::cerr << "FAIL: MLMC call " << res.result.price << " vs BS " << bs << "\n";
+            return 1;
+        }
+        if (!(res.result.stderr <= opt.target_rmse / std::sqrt(2.0) * 1.01) || res.levels.size() < 3) {
+            std::cerr << "FAIL: MLMC stderr " << res.result.stderr << " levels " << res.levels.size() << "\n";
+            return 1;
+        }
+        // Corrections shrink with refinement
+        const std::size_t L = res.levels.size() - 1;
+        if (!(res.levels[L].variance < res.levels[1].variance)) {
+            std::cerr << "FAIL: level variances do not decay\n";
+            return 1;
+        }
+        const MLMCResult again = mlmcPrice(MLMCPayoff::EuropeanCall, S, K, T, r, sigma, 5, opt);
+        if (again.result.price != res.result.price || again.total_cost != res.total_cost) {
+            std::cerr << "FAIL: MLMC not deterministic at equal seed\n";
+            return 1;
+        }
+    }
+
+    // A smaller min_levels still starts with two corrections, so the bias
+    // test never reads the level-0 price as a correction
+    for (std::size_t min_levels : {1, 2}) {
+        MLMCOptions opt;
+        opt.target_rmse = 0.02;
+        opt.min_levels = min_levels;
+        const MLMCResult res = mlmcPrice(MLMCPayoff::EuropeanCall, S, K, T, r, sigma, 5, opt);
+        if (!res.converged || res.levels.size() < 3 || !(res.bias_estimate < 0.5 * res.levels[0].mean)) {
+            std::cerr << "FAIL: min_levels " << min_levels << ": levels " << res.levels.size()
+                      << " bias " << res.bias_estimate << "\n";
+            return 1;
+        }
+    }
+
+    // Put through put-call parity; Asian parity on the continuous average
+    {
+        MLMCOptions opt;
+        opt.target_rmse = 0.02;
+        const double put = mlmcPrice(MLMCPayoff::EuropeanPut, S, K, T, r, sigma, 9, opt).result.price;
+        if (!(std::fabs(put - putPrice(S, K, T, r, sigma)) < 3.0 * opt.target_rmse)) {
+            std::cerr << "FAIL: MLMC put " << put << "\n";
+            return 1;
+        }
+
+        const double ac = mlmcPrice(MLMCPayoff::AsianCall, S, K, T, r, sigma, 9, opt).result.price;
+        const double ap = mlmcPrice(MLMCPayoff::AsianPut, S, K, T, r, sigma, 10, opt).result.price;
+        const double mean_avg = S * std::expm1(r * T) / (r * T);
+        const double parity = std::exp(-r * T) * (mean_avg - K);
+        if (!(std::fabs((ac - ap) - parity) < 4.0 * opt.target_rmse)) {
+            std::cerr << "FAIL: Asian parity " << ac - ap << " vs " << parity << "\n";
+            return 1;
+        }
+        if (!(ac > 0.0 && ac < callPrice(S, K, T, r, sigma))) {
+            std::cerr << "FAIL: Asian call " << ac << " outside (0, European)\n";
+            return 1;
+        }
+    }
+
+    // Halving eps costs ~4x (eps^-2); plain MC with bias eps would cost 8x
+    {
+        MLMCOptions opt;
+        opt.target_rmse = 0.02;
+        const double c1 = mlmcPrice(MLMCPayoff::EuropeanCall, S, K, T, r, sigma, 3, opt).total_cost;
+        opt.target_rmse = 0.01;
+        const double c2 = mlmcPrice(MLMCPayoff::EuropeanCall, S, K, T, r, sigma, 3, opt).total_cost;
+        if (!(c2 / c1 < 6.0)) {
+            std::cerr << "FAIL: MLMC cost ratio " << c2 / c1 << " for eps / 2\n";
+            return 1;
+        }
+    }
+
+    if (!std::isnan(mlmcPrice(MLMCPayoff::EuropeanCall, -1.0, K, T, r, sigma, 1).result.price)) {
+        std::cerr << "FAIL: invalid input should give NAN\n";
+        return 1;
+    }
+
+    std::cout << "PASS: multilevel MC\n";
+    return 0;
+}
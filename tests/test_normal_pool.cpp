@@ -0,0 +1,133 @@
+// Normal variate pool: the file holds exactly the generated stream for any
+// thread count, is reused or regenerated as its header says, and installed
+// pools leave every European MC result bit-identical
+
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "monte_carlo.h"
+#include "normal_pool.h"
+#include "term_structure.h"
+#include "utils.h"
+
+namespace {
+    bool same_bits(const MCResult& a, const MCResult& b) {
+        return std::memcmp(&a, &b, sizeof(MCResult)) == 0;
+    }
+}
+
+int main() {
+    const std::string path = "test_normal_pool.bin";
+    std::remove(path.c_str());
+    const std::uint64_t seed = 7;
+    const std::size_t count = 300000;
+
+    std::vector<double> expected(count);
+    std::uint64_t state = seed;
+    rand_standard_normal_fill(state, expected.data(), count);
+
+    // Generated on several threads, then mapped as is by the next opener
+    NormalPool pool;
+    if (!pool.open(path, seed, count, 3) || !pool.generated() ||
+        std::memcmp(pool.data(), expected.data(), count * sizeof(double)) != 0) {
+        std::cerr << "FAIL: generated pool differs from the stream\n";
+        return 1;
+    }
+    {
+        NormalPool again;
+        if (!again.open(path, seed, count) || again.generated() ||
+            std::memcmp(again.data(), expected.data(), count * sizeof(double)) != 0) {
+            std::cerr << "FAIL: existing pool not reused\n";
+            return 1;
+        }
+    }
+    if (pool.normals(seed, 1000, 5000) != pool.data() + 1000 || pool.normals(seed + 1, 0, 10) ||
+        pool.normals(seed, count - 10, 11) || !pool.normals(seed, count - 10, 10) || pool.normals(seed, count + 1, 0)) {
+        std::cerr << "FAIL: pool ranges\n";
+        return 1;
+    }
+
+    // Installed: the same bits in every mode, for runs inside, straddling
+    // and outside the pool
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS, MCMode::ImportanceSampling,
+                            MCMode::AntitheticImportance, MCMode::MomentMatching,
+                            MCMode::AntitheticMomentMatching, MCMode::MartingaleCorrection,
+                            MCMode::AntitheticMartingale};
+    const MarketCurves curves = MarketCurves::flat(0.03, 0.25, 0.01);
+    std::vector<MCResult> off;
+    auto run_all = [&](std::vector<MCResult>& out) {
+        out.clear();
+        for (MCMode mode : modes) {
+            out.push_back(mcCallPrice(100.0, 105.0, 1.0, 0.03, 0.25, 250000, seed, mode));
+            out.push_back(mcPutPrice(100.0, 95.0, 1.0, 0.03, 0.25, 400000, seed, mode));
+            out.push_back(mcCallPrice(100.0, 105.0, 1.0, 0.03, 0.25, 50000, seed + 1, mode));
+            out.push_back(mcCallPrice(100.0, 105.0, 1.0, curves, 60000, seed, mode));
+        }
+        out.push_back(mcCallPriceT<float>(100.0, 105.0, 1.0, 0.03, 0.25, 100000, seed, MCMode::Antithetic));
+    };
+    run_all(off);
+    mcSetNormalPool(&pool);
+    std::vector<MCResult> on;
+    run_all(on);
+    mcSetNormalPool(nullptr);
+    for (std::size_t i = 0; i < off.size(); i++) {
+        if (!same_bits(off[i], on[i])) {
+            std::cerr << "FAIL: pooled run " << i << " " << on[i].price << " vs " << off[i].price << "\n";
+            return 1;
+        }
+    }
+    pool.close();
+
+    // The engine reads the mapped draws: a pool whose data (not header) was
+    // overwritten changes the price
+    {
+        std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(64);
+        const double zero = 0.0;
+        for (int i = 0; i < 1000; i++) f.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+    }
+    NormalPool tampered;
+    if (!tampered.open(path, seed, count) || tampered.generated()) {
+        std::cerr << "FAIL: reopening the pool\n";
+        return 1;
+    }
+    mcSetNormalPool(&tampered);
+    const MCResult read = mcCallPrice(100.0, 105.0, 1.0, 0.03, 0.25, 250000, seed);
+    mcSetNormalPool(nullptr);
+    if (read.price == off[0].price) {
+        std::cerr << "FAIL: the engine did not read the pool\n";
+        return 1;
+    }
+    tampered.close();
+
+    // Another count, a truncated file or a foreign file is regenerated
+    NormalPool other;
+    if (!other.open(path, seed, 1000) || !other.generated() ||
+        std::memcmp(other.data(), expected.data(), 1000 * sizeof(double)) != 0) {
+        std::cerr << "FAIL: pool for another count\n";
+        return 1;
+    }
+    other.close();
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f << "not a pool";
+    }
+    if (!other.open(path, seed, 1000) || !other.generated() || other.data()[999] != expected[999]) {
+        std::cerr << "FAIL: foreign file not regenerated\n";
+        return 1;
+    }
+    other.close();
+    if (other.open(path, seed, 0) || other.isOpen()) {
+        std::cerr << "FAIL: empty pool\n";
+        return 1;
+    }
+
+    std::remove(path.c_str());
+    std::cout << "PASS: normal variate pool\n";
+    return 0;
+}
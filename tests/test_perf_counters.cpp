@@ -0,0 +1,65 @@
+// Hardware counters: a reading is the scaled change since start(), so
+// threads that ran (and exited) inside an earlier counted region do not
+// leak into later readings. The delta arithmetic is checked everywhere;
+// the threaded check runs only where the PMU is exposed.
+
+#include <iostream>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "perf_counters.h"
+
+namespace {
+    double spin(std::size_t n) {
+        volatile double x = 1.0;
+        for (std::size_t i = 0; i < n; i++) x = x * 1.0000001 + 1e-9;
+        return x;
+    }
+}
+
+int main() {
+    // Multiplexed: 600 counted while running 50 of 100 enabled -> 1200
+    double c = 0.0;
+    if (!PerfCounters::scaledDelta({1000, 50, 50}, {1600, 150, 100}, c) || std::fabs(c - 1200.0) > 1e-9) {
+        std::cerr << "FAIL: scaled delta " << c << "\n";
+        return 1;
+    }
+    // A baseline holding earlier (e.g. inherited-thread) counts is subtracted
+    if (!PerfCounters::scaledDelta({5000000, 900, 900}, {5000250, 1000, 1000}, c) || c != 250.0) {
+        std::cerr << "FAIL: baseline not subtracted " << c << "\n";
+        return 1;
+    }
+    if (PerfCounters::scaledDelta({10, 100, 100}, {20, 100, 100}, c)) {
+        std::cerr << "FAIL: a counter that did not run must be invalid\n";
+        return 1;
+    }
+
+    PerfCounters counters;
+    if (!counters.available()) {
+        std::cout << "PASS: perf counter deltas (no PMU: " << counters.unavailableReason() << ")\n";
+        return 0;
+    }
+
+    // Worker threads started and joined in one region, then a short region:
+    // its reading must not carry the workers' instructions
+    counters.start();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) workers.emplace_back([] { spin(20000000); });
+    for (auto& w : workers) w.join();
+    const PerfCounters::Reading busy = counters.stop();
+
+    counters.start();
+    spin(1000);
+    const PerfCounters::Reading idle = counters.stop();
+
+    if (!busy.valid[PerfCounters::Instructions] || !idle.valid[PerfCounters::Instructions] ||
+        idle.count[PerfCounters::Instructions] * 100.0 > busy.count[PerfCounters::Instructions]) {
+        std::cerr << "FAIL: later reading includes earlier threads: " << idle.count[PerfCounters::Instructions]
+                  << " vs " << busy.count[PerfCounters::Instructions] << "\n";
+        return 1;
+    }
+
+    std::cout << "PASS: perf counter deltas\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+/* C ABI of the shared library: version, scalar BS / Greeks / IV, in-place
+ * batches with and without a thread pool, MC bits independent of the
+ * context, and argument errors */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pricing_c.h"
+
+#define N 3000
+
+static int fail(const char* what) {
+    fprintf(stderr, "FAIL: %s\n", what);
+    return 1;
+}
+
+int main(void) {
+    static uint8_t is_call[N];
+    static double S[N], K[N], T[N], r[N], sigma[N];
+    static double price[N], delta[N], gamma[N], vega[N], price_mt[N], iv[N];
+    static int32_t iters[N];
+    pricing_context* serial;
+    pricing_context* pool;
+    pricing_greeks g;
+    pricing_mc_result a, b, c;
+    size_t i;
+    int it = 0;
+
+    if ((pricing_abi_version() >> 16) != PRICING_ABI_VERSION_MAJOR) return fail("ABI major version");
+    if (!pricing_kernel_level()) return fail("kernel level");
+
+    /* Scalar functions */
+    if (fabs(pricing_bs_price(1, 100.0, 100.0, 1.0, 0.05, 0.2) - 10.450583572185565) > 1e-12) {
+        return fail("BS call");
+    }
+    if (pricing_bs_greeks(0, 100.0, 100.0, 1.0, 0.05, 0.2, &g) != PRICING_OK ||
+        fabs(g.delta - (0.6368306511756191 - 1.0)) > 1e-12 || !(g.gamma > 0.0) || !(g.vega > 0.0)) {
+        return fail("BS greeks");
+    }
+    if (fabs(pricing_implied_vol(1, 10.450583572185565, 100.0, 100.0, 1.0, 0.05, 0.0, &it) - 0.2) > 1e-8 || it < 1) {
+        return fail("implied vol");
+    }
+    if (!isnan(pricing_implied_vol(1, 200.0, 100.0, 100.0, 1.0, 0.05, 0.2, NULL))) {
+        return fail("IV above the no-arbitrage bound");
+    }
+
+    /* Batches, in place, mixed calls and puts */
+    for (i = 0; i < N; i++) {
+        is_call[i] = (uint8_t)((i / 7) % 2);
+        S[i] = 80.0 + 0.013 * (double)i;
+        K[i] = 100.0;
+        T[i] = 0.1 + 0.0007 * (double)i;
+        r[i] = 0.02;
+        sigma[i] = 0.15 + 0.0001 * (double)i;
+    }
+    serial = pricing_context_create(1, 0);
+    pool = pricing_context_create(4, 0);
+    if (!serial || !pool || pricing_context_threads(serial) != 1 || pricing_context_threads(pool) != 4) {
+        return fail("context create");
+    }
+    if (pricing_bs_batch(serial, N, is_call, S, K, T, r, sigma, price, delta, gamma, vega) != PRICING_OK ||
+        pricing_bs_batch(pool, N, is_call, S, K, T, r, sigma, price_mt, NULL, NULL, NULL) != PRICING_OK) {
+        return fail("BS batch status");
+    }
+    for (i = 0; i < N; i++) {
+        if (fabs(price[i] - pricing_bs_price(is_call[i], S[i], K[i], T[i], r[i], sigma[i])) > 1e-11 ||
+            price_mt[i] != price[i]) {
+            return fail("BS batch price");
+        }
+        pricing_bs_greeks(is_call[i], S[i], K[i], T[i], r[i], sigma[i], &g);
+        if (delta[i] != g.delta || gamma[i] != g.gamma || vega[i] != g.vega) return fail("BS batch greeks");
+    }
+    if (pricing_iv_batch(pool, N, is_call, price, S, K, T, r, iv, iters) != PRICING_OK) return fail("IV batch status");
+    for (i = 0; i < N; i++) {
+        /* Deep in/out of the money the vol is barely identified: compare repriced quotes */
+        if (!(fabs(pricing_bs_price(is_call[i], S[i], K[i], T[i], r[i], iv[i]) - price[i]) < 1e-7) || iters[i] < 1) {
+            return fail("IV batch round trip");
+        }
+    }
+
+    /* MC: same bits with no context, a serial context and a pool */
+    if (pricing_mc_price(NULL, 1, 100.0, 105.0, 1.0, 0.03, 0.25, 50000, 7, PRICING_MC_ANTITHETIC_CONTROL_BS, &a) ||
+        pricing_mc_price(serial, 1, 100.0, 105.0, 1.0, 0.03, 0.25, 50000, 7, PRICING_MC_ANTITHETIC_CONTROL_BS, &b) ||
+        pricing_mc_price(pool, 1, 100.0, 105.0, 1.0, 0.03, 0.25, 50000, 7, PRICING_MC_ANTITHETIC_CONTROL_BS, &c)) {
+        return fail("MC status");
+    }
+    if (a.price != b.price || a.price != c.price || a.std_error != c.std_error ||
+        fabs(a.price - pricing_bs_price(1, 100.0, 105.0, 1.0, 0.03, 0.25)) > 4.0 * a.std_error) {
+        return fail("MC result");
+    }
+    /* Modes added in 1.1 */
+    if (pricing_mc_price(pool, 0, 100.0, 95.0, 1.0, 0.03, 0.25, 50000, 7, PRICING_MC_ANTITHETIC_MOMENT_MATCHING, &a) ||
+        fabs(a.price - pricing_bs_price(0, 100.0, 95.0, 1.0, 0.03, 0.25)) > 4.0 * a.std_error) {
+        return fail("MC moment matching");
+    }
+
+    /* Argument errors */
+    if (pricing_mc_price(pool, 1, 100.0, 100.0, 1.0, 0.0, 0.2, 1000, 1, (pricing_mc_mode)42, &a) != PRICING_ERR_ARGUMENT ||
+        pricing_mc_price(pool, 1, 100.0, 100.0, 1.0, 0.0, 0.2, 1000, 1, PRICING_MC_PLAIN, NULL) != PRICING_ERR_ARGUMENT ||
+        pricing_bs_batch(pool, N, NULL, S, K, T, r, sigma, price, NULL, NULL, NULL) != PRICING_ERR_ARGUMENT ||
+        pricing_bs_greeks(1, 100.0, 100.0, 1.0, 0.0, 0.2, NULL) != PRICING_ERR_ARGUMENT) {
+        return fail("argument errors");
+    }
+
+    pricing_context_destroy(pool);
+    pricing_context_destroy(serial);
+    pricing_context_destroy(NULL);
+
+    printf("PASS: C ABI\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// PricingSession / ScratchArena: alignment, O(1) reset, reuse and MC integration
+
+#include <iostream>
+#include <cstdint>
+
+#include "monte_carlo.h"
+#include "pricing_session.h"
+
+int main() {
+    // Alignment, growth past the first chunk and peak tracking
+    {
+        ScratchArena arena(1024);
+        double* a = arena.allocArray<double>(3);
+        double* b = arena.allocArray<double>(1000);   // forces a new chunk
+        if (reinterpret_cast<std::uintptr_t>(a) % kCacheLine != 0 ||
+            reinterpret_cast<std::uintptr_t>(b) % kCacheLine != 0) {
+            std::cerr << "FAIL: arena buffers not cache-line aligned\n";
+            return 1;
+        }
+        b[999] = 1.0;
+
+        const std::size_t peak = arena.peakBytes();
+        const std::size_t reserved = arena.reservedBytes();
+        arena.reset();
+        if (arena.bytesInUse() != 0 || arena.peakBytes() != peak || arena.reservedBytes() != reserved) {
+            std::cerr << "FAIL: reset should release use but keep memory and peak\n";
+            return 1;
+        }
+
+        // Same request again must be served from retained chunks
+        (void)arena.allocArray<double>(3);
+        (void)arena.allocArray<double>(1000);
+        if (arena.reservedBytes() != reserved) {
+            std::cerr << "FAIL: arena grew on a repeated request\n";
+            return 1;
+        }
+    }
+
+    // Mark / rewind
+    {
+        ScratchArena arena(4096);
+        (void)arena.allocate(100);
+        const auto m = arena.mark();
+        const std::size_t used = arena.bytesInUse();
+        (void)arena.allocate(10000);
+        arena.rewind(m);
+        if (arena.bytesInUse() != used) {
+            std::cerr << "FAIL: rewind\n";
+            return 1;
+        }
+    }
+
+    // MC through a session: identical results, no growth across calls
+    {
+        PricingSessionOptions opts;
+        opts.n_workers = 2;
+        opts.huge_pages = true;
+        PricingSession session(opts);
+
+        const auto ref = mcCallPrice(100, 100, 1.0, 0.05, 0.2, 50000, 99, MCMode::AntitheticControlBS);
+        const auto s1  = mcCallPrice(100, 100, 1.0, 0.05, 0.2, 50000, 99, MCMode::AntitheticControlBS, session);
+        const std::size_t reserved = session.reservedBytes();
+        const auto s2  = mcPutPrice(100, 100, 1.0, 0.05, 0.2, 50000, 99, MCMode::Plain, session);
+        const auto s3  = mcCallPrice(100, 100, 1.0, 0.05, 0.2, 50000, 99, MCMode::AntitheticControlBS, session);
+
+        if (s1.price != ref.price || s1.stderr != ref.stderr || s3.price != ref.price) {
+            std::cerr << "FAIL: session MC differs from default MC\n";
+            return 1;
+        }
+        if (!(s2.price > 0.0) || session.reservedBytes() != reserved) {
+            std::cerr << "FAIL: session scratch grew across MC calls\n";
+            return 1;
+        }
+        if (session.peakScratchBytes() < 3 * 4096 * sizeof(double)) {
+            std::cerr << "FAIL: peak scratch not reported: " << session.peakScratchBytes() << "\n";
+            return 1;
+        }
+
+        session.reset();
+        if (session.arena().bytesInUse() != 0) {
+            std::cerr << "FAIL: session reset\n";
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: pricing session scratch memory\n";
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Work-stealing scheduler: MC jobs split into blocks match the serial engine exactly
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "black_scholes.h"
+#include "implied_vol.h"
+#include "monte_carlo.h"
+#include "scheduler.h"
+
+int main() {
+    TaskScheduler sched(4);
+
+    // Mixed MC jobs of very different sizes, all in flight at once
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS};
+    std::vector<MCJob> jobs;
+    for (MCMode mode : modes) {
+        jobs.push_back({true,  100, 100, 1.0, 0.05, 0.2, 300001, 42, mode});
+        jobs.push_back({false, 100, 120, 0.5, 0.03, 0.3, 5000,   7,  mode});
+        jobs.push_back({true,  100, 90,  2.0, 0.01, 0.25, 3,     1,  mode});
+    }
+    jobs.push_back({true, 100, 90, 0.0, 0.05, 0.2, 1000, 1, MCMode::Plain});   // T = 0 inline path
+
+    std::vector<JobHandle<MCResult>> handles;
+    for (const MCJob& j : jobs) handles.push_back(submitMC(sched, j));
+
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        const MCJob& j = jobs[i];
+        const MCResult ref = j.is_call
+            ? mcCallPrice(j.S, j.K, j.T, j.r, j.sigma, j.n_paths, j.seed, j.mode)
+            : mcPutPrice(j.S, j.K, j.T, j.r, j.sigma, j.n_paths, j.seed, j.mode);
+        const MCResult& got = handles[i].get();
+        if (got.price != ref.price || got.stderr != ref.stderr) {
+            std::cerr << "FAIL: scheduled MC job " << i << " differs from serial\n"
+                      << "got=" << got.price << " ref=" << ref.price << "\n";
+            return 1;
+        }
+    }
+
+    // Batched closed-form work
+    std::vector<BSQuote> bs;
+    std::vector<IVQuote> iv;
+    for (int i = 0; i < 5000; i++) {
+        const double K = 60.0 + 0.02 * i;
+        const bool call = (i % 2) == 0;
+        bs.push_back({call, 100.0, K, 0.75, 0.02, 0.25});
+        const double px = call ? callPrice(100.0, K, 0.75, 0.02, 0.25) : putPrice(100.0, K, 0.75, 0.02, 0.25);
+        iv.push_back({call, px, 100.0, K, 0.75, 0.02});
+    }
+    const auto hb = submitBSBatch(sched, bs);
+    const auto hi = submitIVBatch(sched, iv);
+
+    const auto& prices = hb.get();
+    const auto& ivs = hi.get();
+    for (std::size_t i = 0; i < bs.size(); i++) {
+        const BSQuote& q = bs[i];
+        const double ref = q.is_call ? callPrice(q.S, q.K, q.T, q.r, q.sigma) : putPrice(q.S, q.K, q.T, q.r, q.sigma);
+        if (prices[i] != ref) {
+            std::cerr << "FAIL: BS batch at " << i << "\n";
+            return 1;
+        }
+        if (!ivs[i].converged || std::fabs(ivs[i].sigma - 0.25) > 1e-6) {
+            std::cerr << "FAIL: IV batch at " << i << " sigma=" << ivs[i].sigma << "\n";
+            return 1;
+        }
+    }
+
+    if (sched.tasksExecuted() == 0) {
+        std::cerr << "FAIL: no tasks executed\n";
+        return 1;
+    }
+
+    std::cout << "PASS: work-stealing scheduler (tasks=" << sched.tasksExecuted()
+              << " steals=" << sched.steals() << ")\n";
+    return 0;
+}
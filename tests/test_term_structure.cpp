@@ -0,0 +1,134 @@
+// Term structures: cumulative integrals, reduction to the flat engines, and
+// BS / Greeks / IV / multi-step MC consistency on non-flat curves
+
+#include <iostream>
+#include <cmath>
+
+#include "term_structure.h"
+#include "black_scholes.h"
+#include "greeks.h"
+#include "implied_vol.h"
+#include "monte_carlo.h"
+
+static bool close(double a, double b, double tol) { return std::fabs(a - b) <= tol; }
+
+int main() {
+    // Piecewise integrals and knot search
+    {
+        const PiecewiseCurve f({0.5, 1.0, 2.0}, {0.01, 0.02, 0.03});
+        if (!close(f.integral(0.25), 0.0025, 1e-15) || !close(f.integral(1.5), 0.03, 1e-15) ||
+            !close(f.integral(3.0), 0.075, 1e-15) || f.integral(0.0) != 0.0 ||
+            f.value(0.5) != 0.01 || f.value(0.75) != 0.02 || f.value(5.0) != 0.03) {
+            std::cerr << "FAIL: piecewise integral/value\n";
+            return 1;
+        }
+
+        const DiscountCurve zc = DiscountCurve::fromZeroRates({0.5, 1.0, 3.0}, {0.02, 0.025, 0.035});
+        if (!close(zc.discount(1.0), std::exp(-0.025), 1e-15) || !close(zc.zeroRate(3.0), 0.035, 1e-15)) {
+            std::cerr << "FAIL: zero-rate bootstrap does not reprice its pillars\n";
+            return 1;
+        }
+    }
+
+    // Flat curves reduce to the constant-parameter engines
+    const double cases[][5] = {{100, 100, 1.0, 0.05, 0.2}, {100, 80, 0.25, 0.01, 0.35},
+                               {50, 70, 2.0, 0.03, 0.15}, {120, 100, 0.5, -0.01, 0.6}};
+    for (const auto& c : cases) {
+        const double S = c[0], K = c[1], T = c[2], r = c[3], v = c[4];
+        const MarketCurves flat = MarketCurves::flat(r, v);
+        if (!close(callPrice(S, K, T, flat), callPrice(S, K, T, r, v), 1e-12) ||
+            !close(putPrice(S, K, T, flat), putPrice(S, K, T, r, v), 1e-12) ||
+            !close(callDelta(S, K, T, flat), callDelta(S, K, T, r, v), 1e-14) ||
+            !close(gamma(S, K, T, flat), gamma(S, K, T, r, v), 1e-14) ||
+            !close(vega(S, K, T, flat), vega(S, K, T, r, v), 1e-11)) {
+            std::cerr << "FAIL: flat curves differ from flat inputs at S=" << S << " K=" << K << "\n";
+            return 1;
+        }
+    }
+
+    // Non-flat market: bootstrapped rates, a yield curve, two cash dividends
+    // and a rising vol term structure
+    const MarketCurves mkt(DiscountCurve::fromZeroRates({0.25, 1.0, 2.0}, {0.02, 0.03, 0.035}),
+                           DividendCurve(PiecewiseCurve({1.0}, {0.01}), {{0.3, 1.5}, {0.8, 1.5}}),
+                           VolTermStructure({0.5, 1.0, 2.0}, {0.18, 0.22, 0.25}));
+    const double S = 100.0;
+
+    for (double T : {0.2, 0.5, 1.0, 1.75}) {
+        // Parity on the curve forward
+        for (double K : {80.0, 100.0, 125.0}) {
+            const double C = callPrice(S, K, T, mkt), P = putPrice(S, K, T, mkt);
+            if (!close(C - P, mkt.discount(T) * (mkt.forward(S, T) - K), 1e-10)) {
+                std::cerr << "FAIL: put-call parity on curves at T=" << T << " K=" << K << "\n";
+                return 1;
+            }
+
+            // Implied vol recovers the effective vol of the term structure
+            const IVResult iv = impliedVolCall(C, S, K, T, mkt);
+            if (!iv.converged || !close(iv.sigma, mkt.effectiveVol(T), 1e-7)) {
+                std::cerr << "FAIL: curve IV " << iv.sigma << " vs " << mkt.effectiveVol(T) << "\n";
+                return 1;
+            }
+
+            // Spot Greeks against central differences
+            const double h = 1e-3;
+            const double fd_delta = (callPrice(S + h, K, T, mkt) - callPrice(S - h, K, T, mkt)) / (2 * h);
+            const double fd_gamma = (callPrice(S + h, K, T, mkt) - 2 * C + callPrice(S - h, K, T, mkt)) / (h * h);
+            if (!close(callDelta(S, K, T, mkt), fd_delta, 1e-7) || !close(gamma(S, K, T, mkt), fd_gamma, 1e-4)) {
+                std::cerr << "FAIL: curve delta/gamma vs finite differences at T=" << T << "\n";
+                return 1;
+            }
+        }
+
+        // Grid terms add up to the curve integrals
+        const MCTimeGrid grid = mkt.timeGrid(T, 16);
+        const double q_int = mkt.dividends().yieldIntegral(T);
+        const double r_int = mkt.rates().rateIntegral(T);
+        if (!close(grid.total_variance, mkt.totalVariance(T), 1e-14) ||
+            !close(grid.total_drift, r_int - q_int - 0.5 * mkt.totalVariance(T), 1e-14)) {
+            std::cerr << "FAIL: time grid does not integrate the curves at T=" << T << "\n";
+            return 1;
+        }
+    }
+
+    // Curve MC against the curve price, every mode
+    const MCMode modes[] = {MCMode::Plain, MCMode::Antithetic, MCMode::ControlVariateBS,
+                            MCMode::AntitheticControlBS};
+    for (MCMode mode : modes) {
+        const double T = 1.5, K = 95.0;
+        const MCResult call = mcCallPrice(S, K, T, mkt, 200000, 7, mode);
+        const MCResult put = mcPutPrice(S, K, T, mkt, 200000, 7, mode);
+        if (!close(call.price, callPrice(S, K, T, mkt), 4.0 * call.stderr) ||
+            !close(put.price, putPrice(S, K, T, mkt), 4.0 * put.stderr)) {
+            std::cerr << "FAIL: curve MC " << call.price << " vs " << callPrice(S, K, T, mkt) << "\n";
+            return 1;
+        }
+        const MCResult again = mcCallPrice(S, K, T, mkt, 200000, 7, mode);
+        if (again.price != call.price || again.stderr != call.stderr) {
+            std::cerr << "FAIL: curve MC not deterministic at equal seed\n";
+            return 1;
+        }
+    }
+
+    // One draw per path from the totals to expiry: on flat curves the
+    // curve MC is the flat engine's run with the same seed
+    {
+        const MarketCurves flat = MarketCurves::flat(0.03, 0.25, 0.01);
+        const MCResult curve = mcCallPrice(S, 95.0, 1.5, flat, 50000, 7, MCMode::Antithetic);
+        const MCResult ref = mcCallPrice(S * std::exp(-0.01 * 1.5), 95.0, 1.5, 0.03, 0.25, 50000, 7, MCMode::Antithetic);
+        if (!close(curve.price, ref.price, 1e-9 * ref.price)) {
+            std::cerr << "FAIL: flat-curve MC " << curve.price << " vs flat engine " << ref.price << "\n";
+            return 1;
+        }
+    }
+
+    // Dividends worth more than the spot leave nothing to diffuse
+    const MarketCurves rich(DiscountCurve(0.01), DividendCurve(PiecewiseCurve(), {{0.5, 150.0}}),
+                            VolTermStructure(0.2));
+    if (!std::isnan(callPrice(S, 100.0, 1.0, rich)) || !std::isnan(mcCallPrice(S, 100.0, 1.0, rich, 1000, 1).price)) {
+        std::cerr << "FAIL: negative escrowed spot should give NAN\n";
+        return 1;
+    }
+
+    std::cout << "PASS: term structures\n";
+    return 0;
+}
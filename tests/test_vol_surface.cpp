@@ -0,0 +1,134 @@
+// SVI / SSVI surface calibration on synthetic slices with known parameters
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "black_scholes.h"
+#include "vol_surface.h"
+
+static std::vector<SliceQuotes> make_slices(double S, double r, const std::vector<double>& Ts,
+                                            const std::vector<SVIParams>& truth) {
+    std::vector<SliceQuotes> out;
+    for (std::size_t j = 0; j < Ts.size(); j++) {
+        SliceQuotes q;
+        q.T = Ts[j];
+        q.forward = S * std::exp(r * q.T);
+        for (double K = 60.0; K <= 160.0; K += 5.0) {
+            q.strikes.push_back(K);
+            q.ivs.push_back(std::sqrt(sviTotalVariance(truth[j], std::log(K / q.forward)) / q.T));
+        }
+        out.push_back(q);
+    }
+    return out;
+}
+
+int main() {
+    const double S = 100.0, r = 0.03;
+    const std::vector<double> Ts = {0.1, 0.25, 0.5, 1.0, 2.0};
+
+    std::vector<SVIParams> truth;
+    for (double T : Ts) truth.push_back({0.02 * T, 0.08 * std::sqrt(T), -0.4, 0.02, 0.15});
+    const auto slices = make_slices(S, r, Ts, truth);
+
+    // Raw SVI per expiry, in parallel
+    CalibrationOptions opts;
+    opts.n_threads = 4;
+    CalibrationReport cold;
+    const VolSurface surf = calibrateSurface(S, slices, opts, nullptr, &cold);
+
+    if (!cold.all_converged || cold.max_rmse > 1e-7) {
+        std::cerr << "FAIL: SVI calibration max_rmse=" << cold.max_rmse
+                  << " converged=" << cold.all_converged << "\n";
+        return 1;
+    }
+
+    for (const auto& q : slices) {
+        for (std::size_t i = 0; i < q.strikes.size(); i++) {
+            const double K = q.strikes[i];
+            const double iv = surf.sigma(K, q.T);
+            if (std::fabs(iv - q.ivs[i]) > 1e-5) {
+                std::cerr << "FAIL: surface sigma(K,T) K=" << K << " T=" << q.T
+                          << " got=" << iv << " want=" << q.ivs[i] << "\n";
+                return 1;
+            }
+            const double c_mkt = callPrice(S, K, q.T, r, q.ivs[i]);
+            const double c_srf = callPrice(S, K, q.T, r, iv);
+            if (std::fabs(c_mkt - c_srf) > 1e-4) {
+                std::cerr << "FAIL: BS price from surface vol K=" << K << " T=" << q.T << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // Interpolated expiry lies between its neighbours
+    {
+        const double lo = surf.totalVariance(0.0, 0.5), hi = surf.totalVariance(0.0, 1.0);
+        const double mid = surf.totalVariance(0.0, 0.75);
+        if (!(mid > lo && mid < hi)) {
+            std::cerr << "FAIL: total variance interpolation in T\n";
+            return 1;
+        }
+    }
+
+    // Warm start from the previous calibration converges in fewer iterations
+    {
+        CalibrationReport warm;
+        (void)calibrateSurface(S, slices, opts, &surf, &warm);
+        int it_cold = 0, it_warm = 0;
+        for (std::size_t j = 0; j < slices.size(); j++) {
+            it_cold += cold.fits[j].iterations;
+            it_warm += warm.fits[j].iterations;
+        }
+        if (!(it_warm < it_cold) || warm.max_rmse > 1e-7) {
+            std::cerr << "FAIL: warm start iterations cold=" << it_cold << " warm=" << it_warm << "\n";
+            return 1;
+        }
+
+        // One second later every expiry is 3.2e-8 years shorter: still warm
+        auto later = slices;
+        for (auto& q : later) q.T -= 1.0 / (365.0 * 86400.0);
+        CalibrationReport next;
+        (void)calibrateSurface(S, later, opts, &surf, &next);
+        int it_next = 0;
+        for (const auto& f : next.fits) it_next += f.iterations;
+        if (!(it_next < it_cold) || !next.all_converged) {
+            std::cerr << "FAIL: warm start one second later cold=" << it_cold << " warm=" << it_next << "\n";
+            return 1;
+        }
+    }
+
+    // SSVI across expiries recovers an SSVI-generated surface
+    {
+        const double rho = -0.35, eta = 1.2, gam = 0.4;
+        std::vector<SVIParams> ssvi_truth;
+        for (double T : Ts) {
+            const double theta = 0.04 * T;
+            const double phi = eta / (std::pow(theta, gam) * std::pow(1.0 + theta, 1.0 - gam));
+            ssvi_truth.push_back({0.5 * theta * (1.0 - rho * rho), 0.5 * theta * phi, rho, -rho / phi,
+                                  std::sqrt(1.0 - rho * rho) / phi});
+        }
+        // ATM quote included so theta is observed exactly
+        auto ssvi_slices = make_slices(S, r, Ts, ssvi_truth);
+        for (auto& q : ssvi_slices) {
+            q.strikes.push_back(q.forward);
+            q.ivs.push_back(std::sqrt(0.04));
+        }
+
+        CalibrationOptions sopts;
+        sopts.ssvi = true;
+        CalibrationReport rep;
+        const VolSurface ssurf = calibrateSurface(S, ssvi_slices, sopts, nullptr, &rep);
+        if (rep.max_rmse > 1e-7) {
+            std::cerr << "FAIL: SSVI calibration rmse=" << rep.max_rmse << "\n";
+            return 1;
+        }
+        if (std::fabs(ssurf.sigma(80.0, 1.0) - ssvi_slices[3].ivs[4]) > 1e-5) {
+            std::cerr << "FAIL: SSVI surface sigma\n";
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: SVI/SSVI surface calibration\n";
+    return 0;
+}